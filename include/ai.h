@@ -0,0 +1,66 @@
+#ifndef AI_H
+#define AI_H
+
+#include <stdint.h>  // uint64_t
+#include <stdbool.h> // for bool type
+
+#include "game.h"
+#include "bitboard.h"
+
+// Expectimax 탐색 AI (봇, 공격 규칙 튜닝용 "최선" 점수 추정)
+// 내 이동(max 노드)과 타일 생성(chance 노드: 빈칸마다 2가 90%, 4가 10%)을 번갈아 펼치고
+// 말단은 행/열 휴리스틱 테이블로 평가함, 같은 보드는 트랜스포지션 테이블로 재사용
+
+typedef struct {
+    int depth;          // 내다볼 이동 수, 0 이하면 보드의 서로 다른 타일 수로 자동 결정
+    float prob_cutoff;  // 이 확률보다 낮은 타일 생성 분기는 더 펼치지 않음 (예: 0.0001)
+    int tt_bits;        // 트랜스포지션 테이블 크기 = 2^tt_bits 항목 (항목당 16바이트, 스레드 공유)
+    int threads;        // 탐색 스레드 수, 2 이상이면 작업 훔치기 스레드 풀로 서브트리를 나눠 탐색
+    int time_ms;        // 한 수당 시간 제한 (ms), 0보다 크면 깊이 2부터 늘려가며 시간 안에 끝난 가장 깊은 결과를 사용
+                        // (이때 depth는 최대 깊이, 0이면 제한 없음)
+} AiConfig;
+
+typedef struct {
+    Direction move;     // 가장 좋은 이동
+    float expected;     // 그 이동의 기대 평가값
+    bool valid;         // 움직일 수 있는 방향이 하나도 없으면 false
+    int depth;          // 끝까지 탐색한 깊이
+    long nodes;         // 방문한 노드 수 (max + chance)
+} AiResult;
+
+// 탐색 상태 (트랜스포지션 테이블, 탐색 스레드 보유)
+// ai_search는 한 번에 한 스레드에서만 호출 (봇마다 하나씩 만들어서 사용)
+typedef struct AiSearch AiSearch;
+
+/**
+ * @brief 기본 설정 (depth 자동, prob_cutoff 0.0001, tt_bits 18, 스레드 1개, 시간 제한 없음)
+ */
+void ai_default_config(AiConfig *config);
+
+/**
+ * @brief 탐색 상태 생성 (휴리스틱 테이블은 처음 한 번만 만듦, threads > 1이면 스레드 풀도 생성)
+ * @return 생성된 탐색 상태, 메모리 할당 실패 시 NULL
+ */
+AiSearch *ai_create(const AiConfig *config);
+
+/**
+ * @brief 탐색 상태 해제
+ */
+void ai_destroy(AiSearch *ai);
+
+/**
+ * @brief 비트보드에서 가장 좋은 이동을 찾음
+ */
+AiResult ai_search(AiSearch *ai, Board board);
+
+/**
+ * @brief GameState에서 가장 좋은 이동을 찾음 (game_move에 바로 넘길 수 있는 Direction)
+ */
+AiResult ai_best_move(AiSearch *ai, const GameState *state);
+
+/**
+ * @brief 보드 휴리스틱 평가값 (행 4개 + 열 4개의 테이블 합)
+ */
+float ai_evaluate(Board board);
+
+#endif // AI_H
@@ -0,0 +1,173 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <stdint.h>  // uint64_t, uint16_t
+#include <stdbool.h> // for bool type
+
+#include "game.h"    // Direction
+#include "rng.h"     // Rng
+
+// 4x4 보드를 64비트 정수 하나에 담는 비트보드 표현
+// 셀프플레이, 봇 등 대량 시뮬레이션용이며 GameState.board(int[4][4])와는 변환 함수로 오감
+//
+// 각 칸은 4비트 지수(nibble): 0 = 빈칸, k = 2^k 타일 (최대 2^15 = 32768)
+// (r, c) 칸은 비트 16*r + 4*c 부터 시작 -> 한 행(row)이 16비트이고 c=0(왼쪽 칸)이 가장 낮은 니블
+typedef uint64_t Board;
+
+#define BB_ROW_MASK  0xFFFFULL
+#define BB_MAX_EXP   15
+
+// (r, c) 칸의 지수 꺼내기
+#define BB_CELL(b, r, c) ((int)(((b) >> (16 * (r) + 4 * (c))) & 0xF))
+// r번째 행(16비트) 꺼내기
+#define BB_ROW(b, r)     ((uint16_t)(((b) >> (16 * (r))) & BB_ROW_MASK))
+
+// 16비트 한 행에 대한 이동 결과 (행 이동 테이블의 한 항목, 65536개)
+// LEFT와 RIGHT는 같은 쌍이 합쳐지므로 점수가 같음
+typedef struct {
+    uint16_t left;             // LEFT 이동 후 행
+    uint16_t right;            // RIGHT 이동 후 행
+    uint32_t score       : 30; // 합쳐서 얻는 점수
+    uint32_t moved_left  : 1;  // LEFT 이동으로 바뀌는 칸이 있는지
+    uint32_t moved_right : 1;  // RIGHT 이동으로 바뀌는 칸이 있는지
+} BbRow;
+
+#define BB_ROW_COUNT 65536
+
+// 행 이동 테이블 (bb_init() 이후 유효)
+extern const BbRow *bb_rows;
+
+/**
+ * @brief 행 이동 테이블 초기화 및 이동 커널 선택, 이동 함수들을 쓰기 전에 한 번 호출
+ * 여러 번/여러 스레드에서 호출해도 안전하며 BB_STATIC_TABLES 빌드에서는 아무것도 하지 않음
+ */
+void bb_init(void);
+
+/**
+ * @brief 16비트 한 행을 "왼쪽"으로 밀고 합치는 기준 구현 (테이블 생성용, 느림)
+ * @param row 이동 전 행
+ * @param score 합쳐서 얻은 점수를 누적할 포인터
+ * @return 이동 후 행
+ */
+uint16_t bb_row_left(uint16_t row, int *score);
+
+/**
+ * @brief int[4][4] 보드(타일 값)를 비트보드로 변환
+ * @param board 2, 4, 8 ... MAX_TILE 타일 값이 담긴 보드 (0 = 빈칸, 그 밖의 값은 assert)
+ * @return 변환된 비트보드
+ */
+Board bb_from_array(const int board[4][4]);
+
+/**
+ * @brief 비트보드를 int[4][4] 보드(타일 값)로 변환
+ * @param b 비트보드
+ * @param board 결과를 담을 보드
+ */
+void bb_to_array(Board b, int board[4][4]);
+
+/**
+ * @brief 4x4 보드를 전치 (행 <-> 열), UP/DOWN 이동을 행 연산으로 바꿀 때 사용
+ */
+Board bb_transpose(Board b);
+
+/**
+ * @brief 비트보드를 주어진 방향으로 밀고 합침 (game_move의 비트보드 버전)
+ * 2^15 타일끼리는 니블 범위를 넘기 때문에 합쳐지지 않음, bb_init() 이후에만 호출
+ * @param b 이동 전 보드
+ * @param dir 이동 방향 (UP, DOWN, LEFT, RIGHT)
+ * @param score 합쳐져서 얻은 점수를 돌려받을 포인터 (NULL 가능)
+ * @return 이동 후 보드 (움직인 타일이 없으면 b와 같음)
+ */
+Board bb_move(Board b, Direction dir, int *score);
+
+/**
+ * @brief 네 방향 이동을 한 번에 계산 (봇/탐색용, AVX2가 있으면 두 방향씩 묶어서 처리)
+ * @param out 방향(Direction 값)별 이동 결과
+ * @param score 방향별 획득 점수
+ */
+void bb_move_all(Board b, Board out[4], int score[4]);
+
+// 이동 커널 종류, bb_init()이 CPU 기능을 보고 가장 빠른 것을 고름 (AVX2 -> SCALAR)
+// 결과와 점수는 커널과 무관하게 항상 같음
+typedef enum {
+    BB_KERNEL_SCALAR, // 행 이동 테이블 (모든 CPU)
+    BB_KERNEL_SSE41,  // x86 SSE4.1, 4행을 레지스터 하나에서 동시에 처리 (bb_set_kernel로만 선택)
+    BB_KERNEL_AVX2    // x86 AVX2, bb_move_all에서 두 방향을 동시에 처리 (bb_move는 테이블)
+} BbKernel;
+
+/**
+ * @brief 현재 CPU에서 해당 커널을 쓸 수 있는지
+ */
+bool bb_kernel_supported(BbKernel kernel);
+
+/**
+ * @brief 사용할 커널을 강제로 지정 (테스트/벤치마크용, 스레드 시작 전에 호출)
+ * @return 지원하지 않는 커널이면 false (기존 선택 유지)
+ */
+bool bb_set_kernel(BbKernel kernel);
+
+/**
+ * @brief 현재 선택된 커널
+ */
+BbKernel bb_get_kernel(void);
+
+/**
+ * @brief 커널 이름 ("scalar", "sse4.1", "avx2")
+ */
+const char *bb_kernel_name(BbKernel kernel);
+
+/**
+ * @brief 해당 방향으로 움직일 수 있는지 (보드를 만들지 않고 테이블의 moved 플래그만 확인)
+ */
+bool bb_can_move(Board b, Direction dir);
+
+/**
+ * @brief 빈 칸 개수
+ */
+int bb_count_empty(Board b);
+
+/**
+ * @brief 빈 칸 마스크, 칸 번호(4*r + c) 비트가 1이면 빈칸
+ */
+uint16_t bb_empty_mask(Board b);
+
+/**
+ * @brief 지수가 exp인 칸의 마스크 (칸 번호 비트가 1)
+ */
+uint16_t bb_match_mask(Board b, int exp);
+
+/**
+ * @brief 마스크에서 켜진 칸 하나를 균등하게 고름 (난수 1번, 시간은 빈칸 수와 무관)
+ * @param mask 후보 칸 마스크 (칸 번호 비트)
+ * @param rng 난수 생성기
+ * @return 고른 칸 번호 (4*r + c), 후보가 없으면 -1
+ */
+int bb_pick_cell(uint16_t mask, Rng *rng);
+
+/**
+ * @brief 빈 칸 중 한 곳에 2(90%) 또는 4(10%) 타일 생성
+ * @param rng 난수 생성기 (보통 게임별 GameState.rng)
+ * @return 타일이 추가된 보드 (빈 칸이 없으면 b 그대로)
+ */
+Board bb_spawn(Board b, Rng *rng);
+
+/**
+ * @brief 방해 타일 하나를 빈 칸 또는 같은 타일 위에 무작위로 놓음 (game_execute_attack의 비트보드 버전)
+ * @param exp 방해 타일의 지수 (2 -> 1, 4 -> 2)
+ * @param pos 놓인 칸 번호(4*r + c)를 돌려받을 포인터, 놓을 곳이 없으면 -1 (NULL 가능)
+ * @param rng 난수 생성기
+ * @return 방해 타일이 놓인 보드 (놓을 곳이 없으면 b 그대로)
+ */
+Board bb_place_attack(Board b, int exp, int *pos, Rng *rng);
+
+/**
+ * @brief 더 이상 움직일 수 없는지 (빈칸도, 인접한 같은 타일도 없는지) 확인
+ */
+bool bb_is_over(Board b);
+
+/**
+ * @brief 보드에서 가장 큰 타일 값 (2^지수, 빈 보드면 0)
+ */
+int bb_max_tile(Board b);
+
+#endif // BITBOARD_H
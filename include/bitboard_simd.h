@@ -0,0 +1,26 @@
+#ifndef BITBOARD_SIMD_H
+#define BITBOARD_SIMD_H
+
+#include "bitboard.h"
+
+// x86 SIMD 이동 커널 (bitboard_simd.c)
+// 직접 부르지 말고 bb_move / bb_move_all 을 사용 (bb_init에서 CPU 기능을 보고 골라줌)
+// 16칸을 1바이트씩 펼쳐 4행을 레지스터 하나에서 동시에 밀고 합침
+
+#if defined(__x86_64__)
+#define BB_HAVE_X86_KERNELS 1
+
+/**
+ * @brief SSE4.1 커널, 보드 하나를 한 방향으로 이동 (결과/점수는 bb_move와 동일)
+ */
+Board bb_move_sse41(Board b, Direction dir, int *score);
+
+/**
+ * @brief AVX2 커널, 256비트 레지스터 두 개로 네 방향 이동을 한 번에 계산
+ * @param out 방향(Direction 값)별 이동 결과
+ * @param score 방향별 획득 점수
+ */
+void bb_move_all_avx2(Board b, Board out[4], int score[4]);
+#endif
+
+#endif // BITBOARD_SIMD_H
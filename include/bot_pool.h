@@ -0,0 +1,64 @@
+#ifndef BOT_POOL_H
+#define BOT_POOL_H
+
+#include <stdint.h>  // uint64_t
+#include <stdbool.h> // for bool type
+
+#include "ai.h"
+#include "bitboard.h"
+
+// 서버 봇의 탐색을 돌리는 전용 작업 스레드 풀
+// 방의 루프는 보드를 담은 작업을 대기열에 넣기만 하고 (잠금 한 번, 탐색을 기다리지 않음),
+// 작업 스레드가 자기 AiSearch로 탐색한 뒤 done을 불러 결과를 넘김 (서버는 거기서 방의 루프로 loop_post)
+// -> 봇이 아무리 오래 생각해도 이벤트 루프는 사람의 패킷을 바로 처리함
+//
+// 스레드 수와 대기열 길이가 정해져 있어서 봇이 많아져도 탐색에 쓰는 코어는 늘지 않음
+// (대기열이 차면 넣지 않고 거절, 봇은 그 수를 건너뛰고 다음에 다시 시도)
+// 작업 스레드는 nice를 높여서 루프 스레드와 코어를 다툴 때 루프가 먼저 돎
+
+typedef struct BotPool BotPool;
+
+// 탐색 작업 하나 (넣은 쪽이 소유, done이 불릴 때까지 건드리지 않음)
+typedef struct BotJob {
+    struct BotJob *next;        // 풀의 대기열
+    Board board;                // 탐색할 보드
+    void (*done)(struct BotJob *job); // 탐색이 끝나면 작업 스레드에서 호출
+    void *arg;                  // 넣은 쪽 데이터
+
+    // 결과 (done 전에 채워짐)
+    AiResult result;
+    uint64_t cpu_ns;            // 이 탐색에 쓴 스레드 CPU 시간
+} BotJob;
+
+typedef struct {
+    uint64_t searches;  // 끝낸 탐색 수
+    uint64_t rejected;  // 대기열이 차서 거절한 작업 수
+    uint64_t cpu_ns;    // 탐색에 쓴 CPU 시간 합
+    int queued;         // 지금 대기열의 작업 수
+} BotPoolStats;
+
+/**
+ * @brief 풀 생성 (스레드마다 config로 AiSearch를 하나씩 만듦, config->threads는 1로 고정)
+ * @param threads 작업 스레드 수 (1 이상)
+ * @param max_queued 대기열에 쌓아 둘 수 있는 최대 작업 수 (실행 중인 작업은 빼고)
+ * @return 생성된 풀, 실패 시 NULL
+ */
+BotPool *bot_pool_create(int threads, int max_queued, const AiConfig *config);
+
+/**
+ * @brief 탐색 작업을 대기열에 넣음 (어느 스레드에서나)
+ * @return 성공 0, 대기열이 차 있으면 -1 (done은 불리지 않음)
+ */
+int bot_pool_submit(BotPool *pool, BotJob *job);
+
+/**
+ * @brief 대기열에 남은 작업을 모두 끝내고 (done까지 부름) 스레드를 끝낸 뒤 해제
+ */
+void bot_pool_destroy(BotPool *pool);
+
+/**
+ * @brief 지금까지의 통계
+ */
+void bot_pool_stats(BotPool *pool, BotPoolStats *out);
+
+#endif // BOT_POOL_H
@@ -0,0 +1,113 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <stdint.h>  // uint32_t, uint64_t
+#include <stdbool.h> // for bool type
+
+#include "timer_wheel.h"
+
+// epoll 기반 이벤트 루프 (서버용, 코어마다 하나씩 스레드로 실행)
+// 소켓마다 스레드를 두고 1초마다 select로 깨우는 대신, 루프 스레드 하나가 자기 소켓들의
+// 읽기/쓰기 가능 이벤트와 타이머를 한 번의 epoll_wait로 처리함
+// 소켓 등록, 타이머 조작은 루프 스레드에서만 하고, 다른 스레드는 loop_post로 일을 넘김
+// 타이머는 루프마다 1ms tick 계층형 타이머 휠 (연결이 많아도 걸기/다시 걸기/끄기가 O(1))
+
+typedef struct EventLoop EventLoop;
+typedef struct Watcher Watcher;
+typedef struct Timer Timer;
+
+/**
+ * @brief 소켓 이벤트 콜백 (events = EPOLLIN, EPOLLOUT, EPOLLHUP ... 조합)
+ */
+typedef void (*WatchFn)(EventLoop *loop, Watcher *w, uint32_t events);
+
+/**
+ * @brief 타이머 만료 콜백 (콜백 안에서 같은 타이머를 다시 걸어도 됨)
+ */
+typedef void (*TimerFn)(EventLoop *loop, Timer *t);
+
+/**
+ * @brief loop_post로 넘긴 일 (루프 스레드에서 실행)
+ */
+typedef void (*PostFn)(EventLoop *loop, void *arg);
+
+// 감시할 소켓, 보통 연결 구조체 안에 넣어 두고 콜백에서 container 주소로 되돌림
+struct Watcher {
+    int fd;
+    WatchFn fn;
+};
+
+// 타이머, 역시 연결 구조체 안에 넣어서 사용 (메모리 할당 없음)
+struct Timer {
+    WheelTimer node;        // 루프의 타이머 휠 안의 자리 (만료 tick 포함)
+    TimerFn fn;
+};
+
+/**
+ * @brief 루프 생성 (스레드는 loop_start에서 시작)
+ * @param id 루프 번호 (로그 출력용)
+ * @return 생성된 루프, 실패 시 NULL
+ */
+EventLoop *loop_create(int id);
+
+/**
+ * @brief 루프 스레드 시작
+ * @return 성공 0, 실패 -1
+ */
+int loop_start(EventLoop *loop);
+
+/**
+ * @brief 루프 번호
+ */
+int loop_id(const EventLoop *loop);
+
+/**
+ * @brief 소켓 등록 (루프 스레드에서만)
+ * @param events 감시할 이벤트 (EPOLLIN 등)
+ * @return 성공 0, 실패 -1
+ */
+int loop_add(EventLoop *loop, Watcher *w, uint32_t events);
+
+/**
+ * @brief 감시할 이벤트 변경 (보낼 데이터가 남았을 때 EPOLLOUT 추가 등)
+ */
+int loop_mod(EventLoop *loop, Watcher *w, uint32_t events);
+
+/**
+ * @brief 소켓 등록 해제 (close 전에 호출, 같은 epoll_wait 묶음에 남은 이 소켓의 이벤트도 버림)
+ */
+void loop_del(EventLoop *loop, Watcher *w);
+
+/**
+ * @brief 타이머 초기화 (꺼진 상태)
+ */
+void timer_init(Timer *t, TimerFn fn);
+
+/**
+ * @brief 지금부터 delay_ms 뒤에 만료되도록 (다시) 걸기, 이미 걸려 있으면 만료 시각만 바꿈
+ * 1ms 단위로 올림하므로 delay_ms보다 일찍 만료되는 일은 없음
+ */
+void loop_timer_start(EventLoop *loop, Timer *t, uint64_t delay_ms);
+
+/**
+ * @brief 타이머 끄기 (꺼져 있으면 아무것도 안 함)
+ */
+void loop_timer_stop(EventLoop *loop, Timer *t);
+
+/**
+ * @brief 타이머가 걸려 있는지
+ */
+bool timer_active(const Timer *t);
+
+/**
+ * @brief 다른 스레드에서 루프 스레드로 일을 넘김 (스레드 안전, 루프를 깨움)
+ * @return 성공 0, 메모리 할당 실패 -1
+ */
+int loop_post(EventLoop *loop, PostFn fn, void *arg);
+
+/**
+ * @brief 단조 증가 시각 (ns)
+ */
+uint64_t loop_now_ns(void);
+
+#endif // EVENT_LOOP_H
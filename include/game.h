@@ -2,23 +2,34 @@
 #define GAME_H
 
 #include <stdbool.h> // for bool type
+#include <stdint.h>  // uint64_t
+
+#include "rng.h"     // 게임별 난수 생성기
 
 // 2048 게임의 순수 로직 정의
 // server.c는 이 헤더를 include 하여 게임 로직 함수를 호출
 // game_logic.c는 이 헤더를 include 하여 함수들을 구현
 
+#define MAX_ATTACK_QUEUE 10 // 공격 대기열 최대 길이
+#define ATTACK_THRESHOLD 128 // 한 번 이동으로 이 점수 이상 얻으면 상대에게 공격
+#define MAX_ATTACK_PER_MOVE 4 // 한 번 이동으로 보낼 수 있는 최대 방해 타일 수
+#define MAX_TILE 32768 // 가장 큰 타일 (비트보드 칸 하나에 담기는 2^15), 둘이 만나도 합쳐지지 않음
+
 // 게임 보드와 상태를 담는 구조체, 서버 내부 로직용이므로 protocol.hdml S2C_Packet는 별개
 typedef struct {
     int board[4][4]; // 4x4 게임 보드
     int score;       // 현재 점수
     bool game_over;  // 게임 오버 여부
     bool moved;      // 마지막 이동에서 타일이 움직였는지 여부
-    int attack_queue[10]; // 최대 10개의 공격 대기열
+    int attack_queue[MAX_ATTACK_QUEUE]; // 최대 10개의 공격 대기열
     int attack_cnt;       // 현재 대기열에 있는 공격 수
 
     // 이번 턴에 공격받은 위치 저장
     int highlight_r; 
     int highlight_c;
+
+    // 이 게임 전용 난수 생성기 (타일 생성, 공격 위치, 공격 타일 값)
+    Rng rng;
 } GameState;
 
 // 방향 상수 
@@ -38,6 +49,15 @@ typedef enum {
  */
 void game_init(GameState* state);
 
+/**
+ * @brief 정해진 시드로 게임 상태를 초기화 (벤치마크/리플레이 재현용)
+ * 같은 시드와 스트림이면 같은 입력에 대해 항상 같은 게임이 진행됨
+ * @param state 게임 상태 구조체의 포인터
+ * @param seed 난수 시드
+ * @param stream 난수 스트림 번호 (같은 시드로 여러 게임을 만들 때 게임마다 다르게)
+ */
+void game_init_seeded(GameState* state, uint64_t seed, uint64_t stream);
+
 /**
  * @brief 사용자의 입력에 따라 보드의 타일을 이동하고 합침
  * 프로젝트의 뇌에 해당하는 가장 복잡한 함수
@@ -58,6 +78,26 @@ void game_queue_attack(GameState *state, int value);
 // 큐에 있는 공격 실행 (위치 정보 업데이트 포함)
 void game_execute_attack(GameState *state);
 
+/**
+ * @brief 한 번 이동으로 얻은 점수에 따라 상대 대기열에 방해 타일을 보냄 (서버와 시뮬레이터 공통 규칙)
+ * ATTACK_THRESHOLD점마다 하나씩 최대 MAX_ATTACK_PER_MOVE개, 타일 값은 공격자의 난수로 2(90%) 또는 4(10%)
+ * @param attacker 이동한 쪽 (난수 생성기 사용)
+ * @param target 공격받는 쪽
+ * @param score_gained game_move가 리턴한 점수
+ * @return 보낸 방해 타일 수 (0이면 공격 없음)
+ */
+int game_send_attack(GameState *attacker, GameState *target, int score_gained);
+
+/**
+ * @brief 대전에서 이동 하나를 처리 (이동, 움직였으면 새 타일, 대기 공격 하나 실행, 게임 오버 확인, 상대에게 공격)
+ * 서버와 록스텝 클라이언트가 같은 순서로 부르므로, 같은 상태(난수 포함)에서 시작하면 결과도 같음
+ * @param me 이동한 쪽
+ * @param opp 공격받는 쪽
+ * @param dir 이동 방향
+ * @return 상대에게 보낸 방해 타일 수
+ */
+int game_play_move(GameState *me, GameState *opp, Direction dir);
+
 /**
  * @brief 게임이 끝났는지 (더 이상 이동할 수 없는지) 확인
  * @param state 게임 상태 구조체의 포인터
@@ -0,0 +1,68 @@
+#ifndef GAME_BATCH_H
+#define GAME_BATCH_H
+
+#include <stdint.h>  // uint8_t
+#include <stdbool.h> // for bool type
+
+#include "game.h"
+#include "bitboard.h"
+
+// 여러 게임을 한 번에 진행하는 배치 API (공격 규칙 밸런스 시뮬레이션용)
+// GameState를 배열로 두는 대신 필드별 배열(SoA)로 보관해서
+// 보드 이동/게임 오버 판정을 여러 게임에 걸쳐 벡터로 처리함
+
+typedef struct {
+    int count;              // 게임 수
+
+    // 매 스텝 접근하는 필드
+    Board *boards;          // [count] 비트보드
+    int *scores;            // [count] 누적 점수
+    uint8_t *game_over;     // [count] 게임 오버 여부
+    Rng *rngs;              // [count] 게임별 난수 생성기 (타일 생성, 공격 위치)
+
+    // 공격 대기열 (공격이 있을 때만 접근)
+    uint8_t *attack_cnt;    // [count] 대기 중인 공격 수
+    uint8_t *attack_queue;  // [count * MAX_ATTACK_QUEUE] 방해 타일의 지수 (2 -> 1, 4 -> 2)
+} GameBatch;
+
+/**
+ * @brief count개의 게임을 할당하고 game_init과 같이 시작 타일 두 개씩 배치
+ * i번째 게임은 (seed, 스트림 i)로 시드하므로 같은 seed면 항상 같은 배치가 만들어짐
+ * @return 성공 0, 메모리 할당 실패 -1
+ */
+int game_batch_init(GameBatch *batch, int count, uint64_t seed);
+
+/**
+ * @brief 배치가 가진 메모리 해제
+ */
+void game_batch_free(GameBatch *batch);
+
+/**
+ * @brief 모든 게임을 한 스텝 진행 (서버 처리 순서와 동일)
+ * 이동 -> (움직였으면) 타일 생성 -> 대기 중인 공격 실행 -> 게임 오버 판정
+ * 이미 끝난 게임은 그대로 두고 점수 0, moved 0으로 채움
+ * @param dirs 게임별 이동 방향 [count]
+ * @param score_delta 게임별 이번 스텝 획득 점수 [count] (NULL 가능)
+ * @param moved 게임별 타일 이동 여부 [count] (NULL 가능)
+ * @param over 게임별 게임 오버 여부 [count] (NULL 가능)
+ */
+void game_batch_step(GameBatch *batch, const Direction *dirs,
+                     int *score_delta, uint8_t *moved, uint8_t *over);
+
+/**
+ * @brief idx번째 게임의 공격 대기열에 방해 타일 추가 (game_queue_attack과 동일)
+ * @param value 방해 타일 값 (2 또는 4)
+ */
+void game_batch_queue_attack(GameBatch *batch, int idx, int value);
+
+/**
+ * @brief idx번째 게임을 GameState로 꺼냄 (화면 출력, 서버 코드와 연동용)
+ */
+void game_batch_get(const GameBatch *batch, int idx, GameState *state);
+
+/**
+ * @brief GameState를 idx번째 게임에 덮어씀 (난수 생성기 상태 포함)
+ */
+void game_batch_set(GameBatch *batch, int idx, const GameState *state);
+
+#endif // GAME_BATCH_H
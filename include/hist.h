@@ -0,0 +1,72 @@
+#ifndef HIST_H
+#define HIST_H
+
+#include <stdint.h>    // uint64_t
+#include <stdatomic.h>
+
+// 지연 시간 히스토그램 (HDR 방식 로그-선형 칸)
+// 2의 거듭제곱 구간마다 칸 64개로 나눠서 값의 크기와 상관없이 상대 오차 1/64 (약 1.6%) 안에서 분위수를 냄
+// 1ns부터 uint64_t 끝까지 칸 수가 정해져 있어서 기록은 칸 번호 계산 + 더하기 하나 (메모리 할당 없음)
+//
+// 기록은 히스토그램마다 한 스레드만 하고 (스레드마다 하나씩), 다른 스레드는 언제든 읽거나 합칠 수 있음
+// (칸은 relaxed 원자 변수라 읽는 쪽이 값 하나를 반쯤 쓴 상태로 보지 않음, 칸끼리는 조금 어긋날 수 있음)
+
+#define HIST_SUB_BITS 7                         // 처음 2^7개 값은 칸 하나에 값 하나
+#define HIST_SUB      (1 << HIST_SUB_BITS)
+#define HIST_HALF     (HIST_SUB / 2)            // 그 위 2의 거듭제곱 구간마다 칸 수
+#define HIST_BUCKETS  (HIST_SUB + (64 - HIST_SUB_BITS) * HIST_HALF)
+
+typedef struct {
+    _Atomic uint64_t counts[HIST_BUCKETS];
+    _Atomic uint64_t total;
+    _Atomic uint64_t sum;
+    _Atomic uint64_t max;
+} Hist;
+
+/**
+ * @brief 비우기 (다른 스레드가 기록하지 않을 때)
+ */
+void hist_reset(Hist *h);
+
+/**
+ * @brief 값 v가 들어가는 칸 번호
+ */
+static inline int hist_bucket(uint64_t v) {
+    if (v < HIST_SUB) return (int)v;
+    int shift = 63 - __builtin_clzll(v) - (HIST_SUB_BITS - 1);
+    return HIST_SUB + (shift - 1) * HIST_HALF + (int)((v >> shift) - HIST_HALF);
+}
+
+/**
+ * @brief 값 하나 기록 (이 히스토그램에 기록하는 스레드는 하나뿐이라 잠금도 원자적 더하기도 없음)
+ */
+static inline void hist_record(Hist *h, uint64_t v) {
+    _Atomic uint64_t *c = &h->counts[hist_bucket(v)];
+    atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + 1, memory_order_relaxed);
+    atomic_store_explicit(&h->total, atomic_load_explicit(&h->total, memory_order_relaxed) + 1, memory_order_relaxed);
+    atomic_store_explicit(&h->sum, atomic_load_explicit(&h->sum, memory_order_relaxed) + v, memory_order_relaxed);
+    if (v > atomic_load_explicit(&h->max, memory_order_relaxed)) atomic_store_explicit(&h->max, v, memory_order_relaxed);
+}
+
+/**
+ * @brief src를 dst에 더함 (dst는 호출한 스레드만 쓰는 것, src는 기록 중이어도 됨)
+ */
+void hist_merge(Hist *dst, const Hist *src);
+
+/**
+ * @brief 기록된 값 수
+ */
+uint64_t hist_count(const Hist *h);
+
+/**
+ * @brief 분위수 (p = 0 ~ 1), 그 값이 들어간 칸의 가장 큰 값 (기록된 최댓값을 넘지 않음)
+ * @return 기록된 값이 없으면 0
+ */
+uint64_t hist_percentile(const Hist *h, double p);
+
+/**
+ * @brief 평균 (기록된 값이 없으면 0)
+ */
+double hist_mean(const Hist *h);
+
+#endif // HIST_H
@@ -0,0 +1,49 @@
+#ifndef LOCKSTEP_H
+#define LOCKSTEP_H
+
+#include <stdbool.h> // for bool type
+
+#include "protocol.h"
+#include "game.h"
+#include "wire.h"
+
+// 록스텝 클라이언트 (버전 5)
+// 서버가 보내는 사건(시드, 이동, 대기 공격 ...)을 받은 순서대로 내 게임과 상대 게임에 적용해서
+// 보드를 받지 않고도 서버와 같은 상태를 만들고, 화면용 S2C_Packet은 직접 채움
+// 이동은 서버와 같은 game_play_move로 처리하므로 같은 시드에서 시작하면 결과가 같음
+
+typedef struct {
+    GameState games[2]; // 0 = 나, 1 = 상대
+    bool present[2];    // 게임을 받았는지 (상대는 앉아 있는 동안만)
+    bool hit;           // 마지막 사건으로 내가 공격받았는지
+} Lockstep;
+
+/**
+ * @brief 게임 없이 초기화 (내 시드가 오기 전)
+ */
+void lockstep_init(Lockstep *ls);
+
+/**
+ * @brief 사건 하나를 적용
+ * @return 성공 0, 적용할 게임이 없으면 -1 (상태를 놓쳤으므로 키프레임 요청)
+ */
+int lockstep_apply(Lockstep *ls, const LockEvent *ev);
+
+/**
+ * @brief 내 이동 요청 하나를 처리했다는 사건인지 (이동, 건너뜀은 보낸 요청마다 순서대로 하나씩 옴)
+ */
+bool lockstep_acks_input(const LockEvent *ev);
+
+/**
+ * @brief 지금 상태로 화면에 그릴 패킷 채우기
+ */
+void lockstep_packet(const Lockstep *ls, S2C_Packet *pkt);
+
+/**
+ * @brief 두 게임으로 한쪽 플레이어에게 보낼 패킷 채우기 (상태 판정 포함)
+ * 서버(room_compose_packet)와 록스텝 클라이언트가 같은 판정을 씀
+ * @param opp_present 상대가 앉아 있는지 (없으면 상대 보드는 비우고 GAME_WAITING)
+ */
+void lockstep_compose_packet(const GameState *me, const GameState *other, bool opp_present, S2C_Packet *pkt);
+
+#endif // LOCKSTEP_H
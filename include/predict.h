@@ -0,0 +1,55 @@
+#ifndef PREDICT_H
+#define PREDICT_H
+
+#include <stdint.h>  // uint16_t
+#include <stdbool.h> // for bool type
+
+#include "protocol.h"
+#include "game.h"
+
+// 클라이언트 예측 (버전 4)
+// 키를 누르면 서버 응답을 기다리지 않고 내 보드에 game_move를 바로 적용해서 그림
+// 보낸 입력에는 번호를 붙여 두고, 서버 상태가 오면 "서버가 처리한 마지막 입력 번호(ack)"까지는 버린 뒤
+// 서버 상태 위에 아직 확인되지 않은 입력만 다시 적용 (되감고 다시 재생)
+//
+// 새 타일과 공격 타일은 서버의 난수로 정해지므로 예측하지 않음 (서버 상태가 오면 그때 나타남)
+
+#define PREDICT_MAX_PENDING 64 // 확인 안 된 입력을 기억하는 최대 수 (넘치면 예측 없이 보내기만)
+
+typedef struct {
+    uint16_t seq;
+    Direction dir;
+} PredictInput;
+
+typedef struct {
+    uint16_t next_seq;                        // 다음 입력에 붙일 번호
+    PredictInput pending[PREDICT_MAX_PENDING]; // 확인 안 된 입력 (보낸 순서)
+    int head, count;
+    S2C_Packet server;                        // 마지막으로 받은 서버 상태
+    bool has_server;
+} Predictor;
+
+/**
+ * @brief 입력 기록과 서버 상태 없이 초기화
+ */
+void predict_init(Predictor *p);
+
+/**
+ * @brief 이동 입력 하나를 기록하고 번호를 붙임
+ * @return 요청에 실어 보낼 입력 번호
+ */
+int predict_input(Predictor *p, Direction dir);
+
+/**
+ * @brief 서버 상태 반영: ack 이하의 입력을 버리고 기준 상태를 바꿈
+ * @param ack 서버가 이 상태까지 처리한 마지막 입력 번호 (-1이면 아직 없음)
+ */
+void predict_server_state(Predictor *p, const S2C_Packet *pkt, int ack);
+
+/**
+ * @brief 화면에 그릴 상태: 서버 상태 위에 확인 안 된 입력을 다시 적용한 결과
+ * @return 서버 상태가 아직 없으면 false
+ */
+bool predict_view(const Predictor *p, S2C_Packet *out);
+
+#endif // PREDICT_H
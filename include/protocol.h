@@ -1,6 +1,8 @@
 #ifndef PROTOCOL_H
 #define PROTOCOL_H
 
+#include <stdbool.h>
+
 // 두 프로그램 간의 모든 네트워크 통신 규약을 정의하는 헤더 파일
 
 // 게임 상태를 나타내는 상수
@@ -0,0 +1,45 @@
+#ifndef RECV_BUF_H
+#define RECV_BUF_H
+
+#include <stdint.h>    // uint8_t
+#include <stddef.h>    // size_t
+#include <sys/types.h> // ssize_t
+
+// 연결마다 두는 수신 링 버퍼
+// 메시지 하나마다 그 크기만큼 read()를 부르지 않고, 소켓에 와 있는 만큼 readv 한 번으로 받아 둔 뒤
+// 완성된 메시지를 한꺼번에 꺼내 처리함 (키를 몰아서 누르면 여러 요청이 syscall 한 번에 처리됨)
+// 메시지 경계는 모르므로, 꺼내는 쪽이 앞부분을 들여다보고(peek) 크기를 정해서 consume함
+
+typedef struct {
+    uint8_t *data;
+    size_t cap;     // 2의 거듭제곱
+    size_t head;    // 맨 앞 바이트의 위치
+    size_t len;     // 받아 둔 바이트 수
+} RecvBuf;
+
+/**
+ * @brief 버퍼 할당 (cap은 2의 거듭제곱으로 올림)
+ * @return 성공 0, 메모리 할당 실패 -1
+ */
+int recv_buf_init(RecvBuf *rb, size_t cap);
+void recv_buf_free(RecvBuf *rb);
+
+/**
+ * @brief 빈 자리만큼 소켓에서 읽음 (read 한 번, 링이 한 바퀴 돌면 readv로 두 조각)
+ * @return 읽은 바이트 수, 상대가 연결을 닫았으면 0, 오류 -1 (errno, 논블로킹 소켓이면 EAGAIN 포함)
+ *         버퍼가 가득 차 있으면 읽지 않고 -1 (errno = ENOBUFS)
+ */
+ssize_t recv_buf_fill(RecvBuf *rb, int fd);
+
+/**
+ * @brief 맨 앞 n바이트를 out에 복사 (버퍼에서 빼지는 않음)
+ * @return 복사한 바이트 수 (받아 둔 것이 n보다 적으면 그만큼)
+ */
+size_t recv_buf_peek(const RecvBuf *rb, void *out, size_t n);
+
+/**
+ * @brief 맨 앞 n바이트를 버림 (처리한 메시지)
+ */
+void recv_buf_consume(RecvBuf *rb, size_t n);
+
+#endif // RECV_BUF_H
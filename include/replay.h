@@ -0,0 +1,188 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdint.h>  // uint8_t, uint64_t
+#include <stddef.h>  // size_t
+#include <stdbool.h> // for bool type
+
+#include "game.h"
+#include "wire.h"
+
+// 경기 기록 (리플레이) 형식과 읽기
+// 서버는 경기 하나(두 자리가 모두 찬 동안)를 방의 루프에서 메모리 버퍼(Replay)에 사건 단위로 쌓고,
+// 경기가 끝나면 버퍼를 통째로 기록 스레드(replay_log.h)에 넘김 -> 파일에는 경기가 하나씩 연속된 덩어리로 붙음
+// 읽는 쪽은 파일을 mmap해서 경기와 사건을 복사 없이 차례로 꺼냄
+//
+// 경기 덩어리, 모든 정수는 리틀 엔디언
+//   u32    'M' '2' 'K' 'R'
+//   u32    본문 바이트 수
+//   u32    본문 체크섬 (FNV-1a, 기록 스레드가 씀)
+//   u32    방 번호
+//   u64    경기 번호 (서버 실행마다 1부터)
+//   u64    시작 시각 (유닉스 ms)
+//   본문   사건을 차례로: varint 직전 사건 이후 지난 ms + 버전 5 사건과 같은 틀
+//          (u8 길이, u8 종류 << 4 | 자리 << 2 | 방향, 내용), 자리는 0, 1 그대로
+//   시드     경기 시작 때 새 게임 (u64 시드, u8 스트림)
+//   상태     경기 시작 때 이미 진행 중이던 게임 (버전 5 상태 사건과 같음)
+//   이동     game_play_move(자리, 다른 자리, 방향)
+//   대기 공격 game_execute_attack + game_is_over
+//   공격     내용 u8: 이 자리가 상대에게 보낸 방해 타일 수 (이동 바로 뒤, 다시 계산하지 않고 볼 수 있게)
+//   끝       u8 이유, u8 이긴 자리 (0xFF = 없음), varint 점수 두 개, u64 보드 두 개 (본문의 마지막 사건)
+//
+// 서버가 꺼지거나 죽으면 진행 중인 경기는 기록되지 않음 (끝난 경기만 파일에 있음)
+// 파일 끝이 덜 써졌거나 체크섬이 맞지 않는 덩어리에서는 읽기를 멈춤
+
+#define REPLAY_MAGIC        0x524B324DU // "M2KR"
+#define REPLAY_HEADER_SIZE  32
+#define REPLAY_MAX_EVENT    (5 + WIRE_MAX_LOCK) // varint 시간 + 사건
+#define REPLAY_SPLIT_BYTES  (1024 * 1024) // 경기 하나가 이보다 커지면 끊어서 기록하고 이어서 새 경기로
+#define REPLAY_NO_WINNER    0xFF
+
+typedef enum {
+    REPLAY_MOVE = LOCK_MOVE,
+    REPLAY_IDLE = LOCK_IDLE,
+    REPLAY_SEED = LOCK_SEED,
+    REPLAY_STATE = LOCK_STATE,
+    REPLAY_ATTACK = 8,
+    REPLAY_END
+} ReplayEventType;
+
+// 경기가 끝난 이유
+typedef enum {
+    REPLAY_FINISHED,    // 둘 다 게임 오버
+    REPLAY_LEFT,        // 한 명이 나감 (seat = 나간 자리)
+    REPLAY_SPLIT        // 기록이 REPLAY_SPLIT_BYTES를 넘어서 끊음 (다음 덩어리가 같은 방에서 이어짐)
+} ReplayReason;
+
+typedef struct {
+    ReplayEventType type;
+    int seat;           // 사건이 일어난 자리 (끝: 나간 자리)
+    uint32_t t_ms;      // 경기 시작부터 지난 ms (읽을 때 채워짐)
+    Direction dir;      // 이동
+    uint64_t seed;      // 시드
+    int stream;
+    GameState state;    // 상태
+    int attacks;        // 공격
+    ReplayReason reason; // 끝
+    int winner;         // 이긴 자리, 없으면 -1
+    int scores[2];
+    uint64_t boards[2]; // 끝 상태의 보드 (bb_from_array 모양)
+} ReplayEvent;
+
+// 기록 중인 경기 하나 (방의 루프 스레드만 사용, 끝나면 기록 스레드로 넘어감)
+typedef struct Replay {
+    struct Replay *next;    // 기록 스레드의 대기열
+    uint64_t start_ns;      // 시작 시각 (단조 시각)
+    uint32_t last_ms;       // 마지막 사건의 시각 (시작부터 ms)
+    size_t len, cap;        // data에 쓴 바이트 수 / 할당한 크기 (헤더 포함)
+    uint8_t data[];         // 헤더 + 본문 (그대로 파일에 씀)
+} Replay;
+
+// mmap한 기록 파일
+typedef struct {
+    const uint8_t *base;
+    size_t size;
+} ReplayFile;
+
+// 파일 안의 경기 하나 (본문은 mmap한 파일을 그대로 가리킴)
+typedef struct {
+    uint64_t id;
+    uint64_t start_ms;
+    uint32_t room_id;
+    const uint8_t *body;
+    size_t len;
+} ReplayMatch;
+
+// 검증 결과 (기록된 값과 다시 진행한 값이 처음으로 달라진 곳)
+typedef enum {
+    REPLAY_OK,
+    REPLAY_BAD_FORMAT,  // 읽을 수 없는 사건, 게임이 없는데 이동, 끝 사건이 없거나 끝 뒤에 사건
+    REPLAY_BAD_MOVE,    // 게임 오버인 게임의 이동
+    REPLAY_BAD_ATTACK,  // 공격 사건의 타일 수가 다시 계산한 값과 다름 (빠진 공격 사건 포함)
+    REPLAY_BAD_SCORE,   // 끝 사건의 점수가 다름
+    REPLAY_BAD_BOARD,   // 끝 사건의 보드가 다름
+    REPLAY_BAD_RESULT   // 이유/이긴 자리가 끝 상태와 맞지 않음
+} ReplayVerdict;
+
+typedef struct {
+    ReplayVerdict verdict;
+    int event;          // 문제가 된 사건 번호 (1부터)
+    int seat;
+    uint32_t t_ms;
+    uint64_t recorded;  // 기록된 값 / 다시 진행한 값 (점수, 공격 수, 보드)
+    uint64_t replayed;
+    long moves;         // 다시 진행한 이동 수
+} ReplayCheck;
+
+// 경기 본문 안의 읽는 위치 (0으로 초기화해서 시작)
+typedef struct {
+    size_t off;
+    uint32_t t_ms;      // 마지막으로 꺼낸 사건의 시각
+} ReplayCursor;
+
+/**
+ * @brief 새 경기 기록 시작 (헤더만 쓴 버퍼)
+ * @return 버퍼, 메모리 할당 실패 시 NULL
+ */
+Replay *replay_begin(uint64_t id, uint32_t room_id);
+
+/**
+ * @brief 사건 하나를 지금 시각으로 덧붙임 (버퍼가 모자라면 늘림)
+ * @return 성공 0, 메모리 할당 실패 -1 (*r는 그대로)
+ */
+int replay_append(Replay **r, const ReplayEvent *ev);
+
+/**
+ * @brief 본문 크기와 체크섬을 헤더에 채움 (파일에 쓰기 직전, 기록 스레드에서)
+ */
+void replay_seal(Replay *r);
+
+/**
+ * @brief 본문 체크섬 (FNV-1a 32비트)
+ */
+uint32_t replay_checksum(const uint8_t *data, size_t len);
+
+/**
+ * @brief 기록 파일을 읽기 전용으로 mmap
+ * @return 성공 0, 실패 -1 (빈 파일은 경기 0개로 성공)
+ */
+int replay_open(ReplayFile *f, const char *path);
+
+/**
+ * @brief mmap 해제
+ */
+void replay_close(ReplayFile *f);
+
+/**
+ * @brief p에서 시작하는 경기 덩어리의 전체 크기 (헤더 포함, 체크섬은 보지 않음)
+ * 스트리밍으로 읽을 때 버퍼 안에서 경기 경계를 찾는 용도
+ * @param avail p부터 읽을 수 있는 바이트 수
+ * @return 크기, 헤더가 아직 다 오지 않았으면 0, 경기 덩어리가 아니면 -1
+ */
+long replay_block_size(const uint8_t *p, size_t avail);
+
+/**
+ * @brief *off 위치의 경기 하나를 꺼내고 *off를 다음 경기로 옮김 (처음에는 *off = 0)
+ * @return 경기를 꺼내면 1, 파일 끝이면 0, 덜 써졌거나 깨진 덩어리면 -1
+ */
+int replay_next_match(const ReplayFile *f, size_t *off, ReplayMatch *m);
+
+/**
+ * @brief 경기 본문에서 다음 사건 하나를 꺼냄
+ * @return 사건을 꺼내면 1, 본문 끝이면 0, 잘못된 사건이면 -1
+ */
+int replay_next_event(const ReplayMatch *m, ReplayCursor *cur, ReplayEvent *ev);
+
+/**
+ * @brief 경기 하나를 시드(또는 시작 상태)부터 game_play_move 등으로 다시 진행하면서 기록된 공격 수, 끝 점수/보드/결과와 비교
+ * 서버와 같은 순서로 같은 함수를 부르므로 조작되지 않은 기록은 항상 REPLAY_OK (bb_init() 이후 호출)
+ * @return 결과 (out->verdict와 같음)
+ */
+ReplayVerdict replay_verify(const ReplayMatch *m, ReplayCheck *out);
+
+/**
+ * @brief 결과 이름 (출력용)
+ */
+const char *replay_verdict_name(ReplayVerdict v);
+
+#endif // REPLAY_H
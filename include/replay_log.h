@@ -0,0 +1,48 @@
+#ifndef REPLAY_LOG_H
+#define REPLAY_LOG_H
+
+#include <stdint.h>  // uint64_t
+#include <stddef.h>  // size_t
+
+#include "replay.h"
+
+// 경기 기록 파일에 끝난 경기를 덧붙이는 기록 스레드
+// 방의 루프는 끝난 경기 버퍼를 대기열에 넣기만 하고 (잠금 한 번, 디스크를 기다리지 않음),
+// 기록 스레드가 그동안 쌓인 경기를 한꺼번에 쓴 뒤 fdatasync 한 번으로 묶어서 디스크에 내림
+// (쓰는 동안 끝난 경기는 다음 묶음으로, 바쁠수록 묶음이 커져서 fsync 수는 늘지 않음)
+//
+// 디스크가 따라오지 못해 대기열이 상한을 넘으면 새 경기는 버리고 수만 셈 (게임은 기록 때문에 멈추지 않음)
+
+typedef struct ReplayLog ReplayLog;
+
+typedef struct {
+    uint64_t matches;   // 파일에 쓴 경기 수
+    uint64_t bytes;     // 파일에 쓴 바이트 수
+    uint64_t syncs;     // fdatasync 횟수 (묶음 수)
+    uint64_t dropped;   // 대기열이 넘치거나 쓰기에 실패해서 버린 경기 수
+} ReplayLogStats;
+
+/**
+ * @brief 기록 파일을 덧붙이기 모드로 열고 (없으면 만듦) 기록 스레드 시작
+ * @param max_pending 대기열에 쌓아 둘 수 있는 최대 바이트 수 (0이면 상한 없음)
+ * @return 생성된 기록기, 실패 시 NULL
+ */
+ReplayLog *replay_log_open(const char *path, size_t max_pending);
+
+/**
+ * @brief 끝난 경기 하나를 기록 대기열에 넣음 (어느 스레드에서나, r의 소유권은 기록기로 넘어감)
+ * @return 성공 0, 대기열이 넘쳐서 버렸으면 -1
+ */
+int replay_log_submit(ReplayLog *log, Replay *r);
+
+/**
+ * @brief 대기열에 남은 경기를 모두 쓰고 fdatasync한 뒤 스레드를 끝내고 해제
+ */
+void replay_log_close(ReplayLog *log);
+
+/**
+ * @brief 지금까지의 통계
+ */
+void replay_log_stats(ReplayLog *log, ReplayLogStats *out);
+
+#endif // REPLAY_LOG_H
@@ -0,0 +1,55 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h> // uint64_t, uint32_t
+
+// 게임마다 따로 가지는 난수 생성기 (PCG32)
+// 전역 rand()와 달리 잠금이 없고, 같은 시드/스트림이면 항상 같은 수열이 나옴
+// (벤치마크 재현, 리플레이 검증에 사용)
+
+typedef struct {
+    uint64_t state; // 내부 상태
+    uint64_t inc;   // 스트림 번호 (항상 홀수)
+} Rng;
+
+/**
+ * @brief 시드와 스트림 번호로 초기화, 같은 시드라도 스트림이 다르면 서로 독립인 수열
+ * @param seed 시드
+ * @param stream 스트림 번호 (예: 게임 번호, 스레드 번호)
+ */
+void rng_seed(Rng *rng, uint64_t seed, uint64_t stream);
+
+/**
+ * @brief 운영체제 난수(getrandom)로 만든 시드, 같은 시각에 시작한 게임끼리도 겹치지 않음
+ */
+uint64_t rng_entropy_seed(void);
+
+/**
+ * @brief 32비트 난수 하나
+ */
+static inline uint32_t rng_next(Rng *rng) {
+    uint64_t old = rng->state;
+    rng->state = old * 6364136223846793005ULL + rng->inc;
+    uint32_t xorshifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+    uint32_t rot = (uint32_t)(old >> 59u);
+    return (xorshifted >> rot) | (xorshifted << ((-rot) & 31));
+}
+
+/**
+ * @brief [0, n) 범위의 균등한 난수 (나머지 연산 편향 없음, n > 0)
+ */
+static inline uint32_t rng_below(Rng *rng, uint32_t n) {
+    // 곱셈 후 상위 32비트를 쓰고, 편향이 생기는 구간만 다시 뽑음 (Lemire)
+    uint64_t m = (uint64_t)rng_next(rng) * n;
+    uint32_t low = (uint32_t)m;
+    if (low < n) {
+        uint32_t threshold = -n % n;
+        while (low < threshold) {
+            m = (uint64_t)rng_next(rng) * n;
+            low = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
+
+#endif // RNG_H
@@ -0,0 +1,110 @@
+#ifndef ROOM_H
+#define ROOM_H
+
+#include <stdbool.h> // for bool type
+
+#include "protocol.h"
+#include "game.h"
+#include "event_loop.h"
+#include "wire.h"
+#include "replay.h"
+
+// 대전 방: 두 자리(seat)가 각자 GameState를 가지고, 방 하나는 이벤트 루프 하나에서만 처리됨
+// 새 연결은 매칭 대기열에서 한 명이 기다리는 방을 찾아 앉고, 없으면 새 방을 만들어 대기열에 넣음
+// 한 명이 나가면 남은 사람은 그대로 새 상대를 기다리고 (다시 대기열로), 모두 나가면 방을 해제함
+// 다른 방의 게임에는 영향 없음
+// 봇을 켜면 혼자 오래 기다린 방의 빈자리에 서버가 봇(소켓 없는 Client)을 앉히고, 사람이 나가면 봇도 나감
+//
+// 두 자리가 모두 찬 동안이 경기 하나이고, 기록을 켜면 방의 루프가 경기의 사건을 replay에 쌓음 (server.c)
+//
+// 관전자는 자리 없이 방의 루프에 붙어서 방의 상태가 바뀔 때마다 같은 프레임을 받음
+//
+// 잠금: 매칭 대기열, members, 관전 참조 수만 대기열 잠금으로 보호하고 (접속/종료 때만 잡음),
+// 게임 상태와 자리, 관전자 목록은 방의 루프 스레드만 건드리므로 이동 처리에는 잠금이 없음
+
+#define ROOM_SEATS 2
+
+typedef struct Client Client; // 서버의 연결 구조체 (server.c)
+
+typedef struct Room {
+    int id;                     // 로그 출력용 번호
+    EventLoop *loop;            // 이 방의 연결과 타이머를 처리하는 루프 (바뀌지 않음)
+
+    // 방의 루프 스레드만 접근
+    GameState games[ROOM_SEATS];
+    uint64_t seeds[ROOM_SEATS]; // 자리마다 지금 게임을 시작한 시드 (스트림은 자리 번호)
+    bool fresh[ROOM_SEATS];     // 앉은 뒤 아직 경기에 쓰이지 않은 게임 (경기 기록에 시드만 남기면 됨)
+    Replay *replay;             // 기록 중인 경기 (경기 중이 아니거나 기록이 꺼져 있으면 NULL)
+    Client *seats[ROOM_SEATS];  // 자리에 앉은 연결 (NULL = 빈자리)
+    int players;                // 앉은 사람 수
+    Client *watchers;           // 관전자 목록 (server.c가 관리)
+    int watcher_count;
+    WireStream watch_tx;        // 관전자 모두에게 같이 보내는 델타 스트림의 기준 상태
+
+    // 대기열 잠금으로 보호
+    int members;                // 앉은 사람 + 루프로 넘어오는 중인 사람
+    int watch_refs;             // 관전자 + 넘어오는 중인 관전자 (0이 될 때까지 방을 해제하지 않음)
+    struct Room *prev, *next;   // 매칭 대기열 연결 (한 명이 기다리는 동안만)
+    bool queued;
+    struct Room *all_prev, *all_next; // 열린 방 전체 목록 (관전할 방 찾기)
+} Room;
+
+/**
+ * @brief 새 연결이 들어갈 방을 정함 (accept 스레드에서 호출)
+ * 기다리는 방이 있으면 그 방을, 없으면 새 방을 만들어 대기열에 넣음
+ * 실제로 자리에 앉히는 건 방의 루프에서 room_sit으로 함
+ * @param new_room_loop 새 방을 만들 때 배정할 루프
+ * @return 들어갈 방, 메모리 할당 실패 시 NULL
+ */
+Room *room_match(EventLoop *new_room_loop);
+
+/**
+ * @brief 한 명이 기다리는 방의 빈자리를 서버가 차지함 (봇을 앉힐 때, 방의 루프에서 호출)
+ * 대기열에서 빼고 members를 늘림, 실제로 앉히는 건 room_match처럼 room_sit으로
+ * @return 차지했으면 true, 그 사이에 상대가 매칭되어 넘어오는 중이면 false
+ */
+bool room_claim(Room *room);
+
+/**
+ * @brief 관전할 방을 찾아 참조를 잡음 (어느 스레드에서나 호출 가능)
+ * @param id 방 번호, 0이면 두 명이 모두 있는 가장 최근 방
+ * @return 방 (사람이 있는 방만), 없으면 NULL
+ */
+Room *room_watch(int id);
+
+/**
+ * @brief room_watch로 잡은 참조를 놓음, 사람도 관전자도 없으면 방을 해제
+ */
+void room_unwatch(Room *room);
+
+/**
+ * @brief 방에 남은 사람 수 (넘어오는 중인 사람 포함, 대기열 잠금을 잡음)
+ */
+int room_members(Room *room);
+
+/**
+ * @brief 빈자리에 앉히고 그 자리의 게임을 새로 시작함 (방의 루프에서 호출)
+ * @return 앉은 자리 번호
+ */
+int room_sit(Room *room, Client *c);
+
+/**
+ * @brief 자리에서 나감 (방의 루프에서 호출)
+ * 남은 사람이 있으면 방을 대기열로 되돌리고, 아무도 없고 넘어오는 중인 사람도 없으면 방을 해제
+ * (관전 참조가 남아 있으면 마지막 room_unwatch에서 해제)
+ * @return 방에 남은 사람 수 (넘어오는 중인 사람 포함, 0이고 관전자가 없었으면 room은 이미 해제됨)
+ */
+int room_leave(Room *room, int seat);
+
+/**
+ * @brief seat 자리 플레이어에게 보낼 패킷 채우기 (전송 안 함)
+ */
+void room_compose_packet(const Room *room, int seat, S2C_Packet *pkt);
+
+/**
+ * @brief 현재 열린 방 수 / 상대를 기다리는 방 수 (어느 스레드에서나 호출 가능)
+ */
+int room_count(void);
+int room_waiting_count(void);
+
+#endif // ROOM_H
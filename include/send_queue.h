@@ -0,0 +1,78 @@
+#ifndef SEND_QUEUE_H
+#define SEND_QUEUE_H
+
+#include <stdint.h>  // uint8_t
+#include <stddef.h>  // size_t
+#include <stdbool.h> // for bool type
+
+// 한 번 직렬화한 프레임을 여러 연결에 나눠 보내기 위한 공유 버퍼와 연결별 전송 대기열
+// 방의 상태가 바뀌면 프레임을 한 번만 만들어 SharedBuf에 담고, 관전자마다 복사 없이 참조만 대기열에 넣은 뒤
+// 대기열에 쌓인 버퍼들을 writev 식으로 한 번의 sendmsg로 보냄 (느린 연결은 그동안 쌓인 프레임을 한꺼번에)
+//
+// 같은 버퍼를 참조하는 연결은 모두 같은 방 = 같은 루프 스레드에 있으므로 참조 수는 잠금 없이 셈
+//
+// 대기열마다 상한(high-water)을 두어, 받지 않고 버티는 연결의 대기열이 끝없이 커지지 않게 함
+// 상한을 넘기는 push는 실패하고, 호출한 쪽이 그 연결을 끊음
+
+// 변경 불가 버퍼 (만든 뒤에는 data를 바꾸지 않음)
+typedef struct SharedBuf {
+    int refs;
+    size_t len;
+    uint8_t data[];
+} SharedBuf;
+
+// 연결 하나의 전송 대기열 (SharedBuf 참조의 원형 배열)
+typedef struct {
+    SharedBuf **bufs;
+    int head, count, cap;
+    size_t offset;      // 맨 앞 버퍼에서 이미 보낸 바이트 수
+    size_t bytes;       // 대기열에 남은 바이트 수
+    size_t limit;       // bytes의 상한 (0이면 없음)
+} SendQueue;
+
+/**
+ * @brief data를 복사한 공유 버퍼 생성 (참조 수 1)
+ * @return 생성된 버퍼, 메모리 할당 실패 시 NULL
+ */
+SharedBuf *shared_buf_new(const void *data, size_t len);
+
+/**
+ * @brief 참조 추가 / 해제 (0이 되면 해제)
+ */
+SharedBuf *shared_buf_ref(SharedBuf *b);
+void shared_buf_unref(SharedBuf *b);
+
+/**
+ * @brief 빈 대기열로 초기화
+ * @param limit 대기열에 쌓아 둘 수 있는 최대 바이트 수 (0이면 상한 없음)
+ */
+void send_queue_init(SendQueue *q, size_t limit);
+
+/**
+ * @brief 남은 버퍼의 참조를 모두 놓고 대기열 해제
+ */
+void send_queue_free(SendQueue *q);
+
+/**
+ * @brief 버퍼를 대기열 끝에 넣음 (참조를 하나 잡음)
+ * @return 성공 0, 상한을 넘거나 메모리 할당 실패 -1
+ */
+int send_queue_push(SendQueue *q, SharedBuf *b);
+
+/**
+ * @brief 한 연결에만 보내는 데이터 전송: 대기열이 비어 있으면 바로 보내고, 못 보낸 나머지만 복사해서 대기열에 넣음
+ * @return 다 보냈으면 1, 남았으면 0 (EPOLLOUT을 기다림), 소켓 오류나 상한 초과 -1
+ */
+int send_queue_write(SendQueue *q, int fd, const void *data, size_t len);
+
+/**
+ * @brief 쌓인 버퍼를 소켓 버퍼가 찰 때까지 보냄
+ * @return 다 보냈으면 1, 남았으면 0 (EPOLLOUT을 기다림), 소켓 오류 -1
+ */
+int send_queue_flush(SendQueue *q, int fd);
+
+static inline bool send_queue_empty(const SendQueue *q) {
+    return q->count == 0;
+}
+
+#endif // SEND_QUEUE_H
@@ -0,0 +1,105 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdio.h>     // FILE
+#include <stdint.h>    // uint64_t, int64_t
+#include <stdatomic.h>
+#include <time.h>      // clock_gettime()
+
+#include "hist.h"
+
+// 서버 내부 통계: 스레드마다 지연 히스토그램과 카운터를 따로 들고 (기록에 잠금도 원자적 더하기도 없음),
+// 읽는 쪽(통계 스레드)이 요청받았을 때만 모든 스레드의 값을 합쳐서 JSON 한 덩어리로 냄
+// - 로컬 유닉스 소켓에 접속하면 JSON을 받고 끊김 (예: socat - UNIX-CONNECT:stats.sock)
+// - stats_request_dump()를 부르면 (SIGUSR1 처리기) 표준 출력에 같은 JSON을 한 줄로 씀
+// 아무도 읽지 않으면 기록 비용은 시계 읽기와 자기 스레드 메모리에 더하기뿐
+//
+// stats_register를 부르지 않은 스레드의 기록은 버림 (봇 풀, 기록 스레드 등)
+
+// 지연 히스토그램 (ns)
+typedef enum {
+    STATS_RECV_SEND,    // 소켓에서 받은 뒤 그 요청들의 결과를 모두 보낼 때까지 (루프 하나의 처리 시간)
+    STATS_LOCK_WAIT,    // 매칭 대기열 잠금을 기다린 시간 (방 찾기/나가기)
+    STATS_MOVE,         // game_play_move 한 번
+    STATS_WRITE,        // 소켓에 쓰기 한 번 (send 시스템 콜, 대기열 비우기 포함)
+    STATS_HISTS
+} StatsHist;
+
+// 카운터
+typedef enum {
+    STATS_ACCEPTED,     // 받은 연결 수
+    STATS_CLOSED,       // 닫은 연결 수
+    STATS_PACKETS_IN,   // 처리한 요청 수
+    STATS_PACKETS_OUT,  // 보낸 메시지 수 (상태 패킷, 록스텝 사건, 관전 프레임)
+    STATS_BYTES_IN,
+    STATS_BYTES_OUT,
+    STATS_COUNTERS
+} StatsCounter;
+
+typedef struct StatsThread {
+    char name[16];
+    Hist hists[STATS_HISTS];
+    _Atomic uint64_t counters[STATS_COUNTERS];
+    struct StatsThread *next;
+} StatsThread;
+
+// 서버가 읽을 때마다 값을 알려 주는 항목 (방 수 등)
+typedef struct {
+    const char *name;
+    int64_t (*read)(void);
+} StatsGauge;
+
+extern _Thread_local StatsThread *stats_self;
+
+/**
+ * @brief 호출한 스레드의 통계를 만들어 등록 (한 번만, 프로세스가 끝날 때까지 해제하지 않음)
+ * @return 등록한 통계, 메모리 할당 실패 시 NULL (이 스레드의 기록은 버려짐)
+ */
+StatsThread *stats_register(const char *name);
+
+static inline uint64_t stats_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief 카운터에 더함 (자기 스레드의 카운터만 쓰므로 relaxed 읽고 쓰기)
+ */
+static inline void stats_add(StatsCounter c, uint64_t n) {
+    StatsThread *s = stats_self;
+    if (s) atomic_store_explicit(&s->counters[c], atomic_load_explicit(&s->counters[c], memory_order_relaxed) + n,
+                                 memory_order_relaxed);
+}
+
+/**
+ * @brief since(stats_now()로 잰 시각)부터 지금까지를 히스토그램에 기록
+ */
+static inline void stats_since(StatsHist h, uint64_t since) {
+    StatsThread *s = stats_self;
+    if (s) hist_record(&s->hists[h], stats_now() - since);
+}
+
+/**
+ * @brief 모든 스레드의 통계를 합쳐서 JSON 한 줄로 씀 (합계 + 스레드별, 히스토그램은 ns 분위수)
+ */
+void stats_write_json(FILE *f, const StatsGauge *gauges, int gauge_count);
+
+/**
+ * @brief 통계 스레드 시작: path에 유닉스 소켓을 열고 (NULL이면 소켓 없음) 접속마다 JSON을 보냄
+ * gauges는 stats_stop까지 그대로 있어야 함
+ * @return 성공 0, 소켓/스레드를 만들지 못하면 -1
+ */
+int stats_serve(const char *path, const StatsGauge *gauges, int gauge_count);
+
+/**
+ * @brief 표준 출력으로 JSON을 한 번 쓰도록 요청 (시그널 처리기에서 불러도 됨, 통계 스레드가 곧 씀)
+ */
+void stats_request_dump(void);
+
+/**
+ * @brief 통계 스레드를 끝내고 소켓 파일을 지움
+ */
+void stats_stop(void);
+
+#endif // STATS_H
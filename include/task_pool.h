@@ -0,0 +1,39 @@
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+// 작업 훔치기(work-stealing) 스레드 풀
+// 작업 번호 [0, count)를 스레드 수만큼 나눠서 각자의 대기열에 넣고,
+// 자기 대기열이 빈 스레드는 다른 스레드 대기열의 뒤쪽 절반을 가져와서 계속 일함
+// (작업마다 걸리는 시간이 크게 다른 탐색 서브트리 분배용)
+
+typedef struct TaskPool TaskPool;
+
+/**
+ * @brief 작업 함수 (index = 작업 번호, worker = 실행 중인 스레드 번호 0 ~ threads-1)
+ */
+typedef void (*TaskFn)(void *ctx, int index, int worker);
+
+/**
+ * @brief 스레드 풀 생성, 호출한 스레드도 0번 스레드로 일하므로 threads-1개의 스레드를 만듦
+ * @param threads 전체 스레드 수 (1 이상)
+ * @return 생성된 풀, 실패 시 NULL
+ */
+TaskPool *task_pool_create(int threads);
+
+/**
+ * @brief 스레드 풀 종료 및 해제 (실행 중인 작업이 없을 때 호출)
+ */
+void task_pool_destroy(TaskPool *pool);
+
+/**
+ * @brief 전체 스레드 수
+ */
+int task_pool_threads(const TaskPool *pool);
+
+/**
+ * @brief fn(ctx, i, worker)를 i = 0 ~ count-1 에 대해 모두 실행하고 끝날 때까지 대기
+ * 한 번에 한 스레드에서만 호출
+ */
+void task_pool_run(TaskPool *pool, TaskFn fn, void *ctx, int count);
+
+#endif // TASK_POOL_H
@@ -0,0 +1,71 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdint.h>  // uint64_t
+#include <stdbool.h> // for bool type
+
+// 계층형 타이머 휠 (이벤트 루프의 타이머, 대기 공격 타임아웃용)
+// 시간은 tick 단위 정수 (이벤트 루프는 1 tick = 1ms), 바퀴 4단 x 칸 64개로 2^24 tick(약 4.6시간)까지 표현
+// 0단은 1 tick 칸, k단은 64^k tick 칸이라 먼 타이머는 윗단에 있다가 시간이 다가오면 아랫단으로 내려옴
+// 걸기/끄기/다시 걸기는 항상 O(1)이고, 걸린 타이머가 없거나 먼 타이머뿐이면 루프를 깨울 일이 없음
+// (칸마다 비었는지를 비트맵으로 들고 있어서 다음에 깨어날 시각도 O(1)로 계산)
+
+#define WHEEL_BITS   6
+#define WHEEL_SLOTS  (1 << WHEEL_BITS)
+#define WHEEL_LEVELS 4
+
+// 타이머 하나, 보통 다른 구조체 안에 넣어서 사용 (메모리 할당 없음)
+typedef struct WheelTimer {
+    uint64_t expires;               // 만료 tick
+    struct WheelTimer *prev, *next; // 칸 안의 원형 연결 리스트
+    int slot;                       // 들어 있는 칸 번호, -1이면 꺼져 있음
+} WheelTimer;
+
+typedef struct {
+    uint64_t now;                           // 다음에 처리할 tick (이보다 앞선 tick은 모두 처리됨)
+    uint64_t occupied[WHEEL_LEVELS];        // 단별로 타이머가 있는 칸의 비트맵
+    WheelTimer heads[WHEEL_LEVELS * WHEEL_SLOTS + 1]; // 칸별 리스트 머리 (+ 만료된 타이머 목록)
+} TimerWheel;
+
+/**
+ * @brief 빈 휠 초기화
+ * @param now 시작 tick
+ */
+void wheel_init(TimerWheel *w, uint64_t now);
+
+/**
+ * @brief 타이머를 꺼진 상태로 초기화
+ */
+void wheel_timer_init(WheelTimer *t);
+
+/**
+ * @brief 타이머가 걸려 있는지
+ */
+static inline bool wheel_timer_active(const WheelTimer *t) {
+    return t->slot >= 0;
+}
+
+/**
+ * @brief expires tick에 만료되도록 걸기 (이미 걸려 있으면 옮김), 이미 지난 tick이면 다음 처리 때 바로 만료
+ */
+void wheel_add(TimerWheel *w, WheelTimer *t, uint64_t expires);
+
+/**
+ * @brief 타이머 끄기 (꺼져 있으면 아무것도 안 함)
+ */
+void wheel_del(TimerWheel *w, WheelTimer *t);
+
+/**
+ * @brief now tick까지 만료된 타이머를 하나씩 꺼냄 (꺼낸 타이머는 꺼진 상태)
+ * 콜백을 부른 뒤 다시 호출하는 식으로 사용, 콜백 안에서 타이머를 걸거나 꺼도 됨
+ * @return 만료된 타이머, 없으면 NULL
+ */
+WheelTimer *wheel_expire(TimerWheel *w, uint64_t now);
+
+/**
+ * @brief 다음에 wheel_expire를 불러야 하는 tick (만료 또는 윗단에서 내려올 시각)
+ * @return 걸린 타이머가 없으면 false
+ */
+bool wheel_next(const TimerWheel *w, uint64_t *tick);
+
+#endif // TIMER_WHEEL_H
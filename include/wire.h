@@ -0,0 +1,220 @@
+#ifndef WIRE_H
+#define WIRE_H
+
+#include <stdint.h>  // uint8_t
+#include <stddef.h>  // size_t
+#include <stdbool.h> // for bool type
+
+#include "protocol.h"
+#include "game.h"
+
+// 압축 전송 형식 (S2C_Packet 약 200바이트 -> 최대 35바이트)
+// 구조체를 그대로 보내는 기존 형식(raw)은 호스트의 int 크기/바이트 순서/패딩에 의존하므로,
+// 모든 필드를 리틀 엔디언으로 명시해서 바이트 단위로 직접 씀
+//
+// 협상: 새 클라이언트는 접속 직후 hello(4바이트: 'M' '2' 'K' 버전)를 보내고,
+// 서버는 같은 모양의 hello로 고른 버전을 알려 준 뒤 그 버전으로만 보냄
+// hello를 보내지 않는 예전 클라이언트는 계속 raw 형식으로 주고받음
+// 관전자는 hello 대신 watch(8바이트: 'M' '2' 'W' 버전 + u32 방 번호, 0이면 아무 대전)를 보내고,
+// 서버는 hello로 답한 뒤 그 방의 상태를 1번 자리 기준(my = 1P, opp = 2P)의 버전 2 프레임으로 보냄
+//
+// S2C 패킷 (버전 1), 모든 정수는 리틀 엔디언
+//   u8     뒤따르는 바이트 수
+//   u16    비트필드: 0-2 game_status, 3 is_hit, 4 하이라이트 있음, 5-6 highlight_r, 7-8 highlight_c
+//   u64    my_board  (칸마다 4비트 지수, 0 = 빈칸, (r,c)는 (r*4+c)*4 비트부터)
+//   u64    opp_board
+//   varint my_score, opp_score (부호 없는 LEB128, 7비트씩)
+//   u8     attack_count, 이어서 대기 중인 공격 타일 지수를 4비트씩 (앞의 것이 하위 4비트)
+// C2S 요청은 ClientAction 1바이트
+//
+// 버전 2 (델타): 위 패킷(키프레임)과 함께, 직전에 보낸 상태에서 바뀐 필드만 담은 델타 프레임을 씀
+//   u8     뒤따르는 바이트 수
+//   u16    비트필드 0-8은 위와 같고, 9 = 델타, 10-14 = 담긴 필드 (내 보드, 상대 보드, 내 점수, 상대 점수, 공격)
+//   보드   u16 바뀐 칸 비트맵 + 바뀐 칸의 지수 4비트씩
+//   점수   varint (새 값), 공격은 키프레임과 같은 모양
+// TCP라 보낸 순서대로 모두 도착하므로 "직전에 보낸 상태"가 곧 받는 쪽이 가진 상태 (따로 ack 없음)
+// WIRE_KEYFRAME_INTERVAL개마다, 또는 받는 쪽이 WIRE_KEYFRAME_REQUEST를 보내면 키프레임으로 다시 맞춤
+//
+// 버전 3 (C2S 틀): S2C는 버전 2와 같고, C2S 요청도 길이 바이트를 앞에 붙임
+//   u8     뒤따르는 바이트 수 (0이면 빈 요청, 무시)
+//   u8     요청 종류 (ClientAction 또는 WIRE_KEYFRAME_REQUEST)
+//   ...    이후 버전에서 붙일 내용 (모르는 바이트는 건너뜀)
+// 받는 쪽은 길이만 보고 요청 하나를 잘라 낼 수 있으므로, 요청에 필드를 더해도 예전 서버가 틀을 잃지 않음
+//
+// 버전 4 (입력 번호): 클라이언트 예측용
+//   C2S    이동 요청 뒤에 u16 입력 번호 (1씩 늘고 65535 다음은 0)
+//   S2C    비트필드 15 = 입력 확인, 프레임 끝에 u16 "이 상태까지 처리한 마지막 입력 번호"
+//          키프레임에는 항상, 델타에는 바뀌었을 때만 붙음 (기준 상태의 일부)
+//
+// 버전 5 (록스텝): 서버는 보드를 보내지 않고, 양쪽 게임을 클라이언트가 직접 시뮬레이션할 수 있는 사건만 보냄
+// 게임마다 서버가 정한 시드로 난수를 만들므로, 같은 사건을 같은 순서로 적용하면 서버와 같은 상태가 됨
+//   u8     뒤따르는 바이트 수
+//   u8     사건 종류 (상위 4비트) | 누구 (비트 2, 0 = 받는 쪽, 1 = 상대) | 방향 (비트 0-1, 이동만)
+//   이동     내용 없음, game_play_move(누구, 다른 쪽, 방향)
+//   건너뜀   내용 없음, 내 이동 요청을 받았지만 게임에 반영하지 않음 (상대 대기 중, 게임 오버)
+//   대기 공격 내용 없음, game_execute_attack + game_is_over
+//   시드     u64 시드, u8 스트림: game_init_seeded로 새 게임 (자리에 앉을 때)
+//   상태     u64 보드, varint 점수, u8 공격 수 + 4비트씩, u8 (0 게임 오버, 1 하이라이트, 2-3 r, 4-5 c),
+//            u64 난수 상태, u64 난수 inc (이미 진행 중인 상대 게임, 또는 WIRE_KEYFRAME_REQUEST의 응답)
+//   퇴장     내용 없음, 상대가 나감
+// C2S는 버전 3과 같음 (입력 번호 없이, 내 이동 요청마다 이동이나 건너뜀이 보낸 순서대로 하나씩 돌아옴)
+
+#define WIRE_VERSION     5
+#define WIRE_LOCKSTEP_VERSION 5
+#define WIRE_HELLO_SIZE  4
+#define WIRE_WATCH_SIZE  8
+#define WIRE_ACTION_SIZE 1  // 버전 1, 2의 C2S 요청 크기
+#define WIRE_MAX_REQUEST 16 // 버전 3의 C2S 요청 최대 크기 (길이 바이트 포함)
+#define WIRE_MAX_PACKET  37 // 길이 바이트 포함 최대 크기 (델타도 이보다 크면 키프레임으로 보냄)
+#define WIRE_MAX_LOCK    38 // 버전 5 사건의 최대 크기 (길이 바이트 포함, 상태 사건)
+
+#define WIRE_KEYFRAME_INTERVAL 32   // 델타 이만큼마다 키프레임
+#define WIRE_KEYFRAME_REQUEST  0x80 // C2S: 다음 갱신을 키프레임으로 요청 (버전 2 이상)
+
+// 버전 2에서 연결마다 두는 기준 상태 (보내는 쪽과 받는 쪽이 각자 하나씩, 같은 값을 유지)
+typedef struct {
+    bool primed;          // 기준 상태가 있는지 (없으면 키프레임부터)
+    int since_key;        // 마지막 키프레임 이후 보낸 델타 수 (보내는 쪽)
+    uint64_t boards[2];   // 내 보드, 상대 보드 (칸마다 4비트 지수)
+    uint32_t scores[2];
+    int attack_count;
+    uint64_t attacks;     // 공격 타일 지수 4비트씩
+    int ack;              // 마지막으로 확인된 입력 번호 (버전 4, -1이면 없음), 받는 쪽은 디코딩 후 여기서 읽음
+} WireStream;
+
+// 버전 5 사건
+typedef enum {
+    LOCK_MOVE = 1,
+    LOCK_SKIP,
+    LOCK_IDLE,
+    LOCK_SEED,
+    LOCK_STATE,
+    LOCK_LEAVE
+} LockEventType;
+
+typedef struct {
+    LockEventType type;
+    int who;          // 0 = 받는 쪽 자신, 1 = 상대
+    Direction dir;    // LOCK_MOVE
+    uint64_t seed;    // LOCK_SEED
+    int stream;
+    GameState state;  // LOCK_STATE (보드, 점수, 공격 대기열, 게임 오버, 하이라이트, 난수)
+} LockEvent;
+
+/**
+ * @brief hello 4바이트 채우기
+ */
+void wire_hello(uint8_t out[WIRE_HELLO_SIZE], int version);
+
+/**
+ * @brief hello인지 확인
+ * @return hello의 버전, hello가 아니면 -1
+ */
+int wire_parse_hello(const uint8_t in[WIRE_HELLO_SIZE]);
+
+/**
+ * @brief watch 8바이트 채우기
+ * @param room_id 관전할 방 번호 (0 = 아무 대전)
+ */
+void wire_watch(uint8_t out[WIRE_WATCH_SIZE], int version, uint32_t room_id);
+
+/**
+ * @brief 앞 4바이트가 watch인지 확인
+ * @return watch의 버전, 아니면 -1
+ */
+int wire_parse_watch(const uint8_t in[WIRE_HELLO_SIZE]);
+
+/**
+ * @brief watch의 방 번호
+ */
+uint32_t wire_watch_room(const uint8_t in[WIRE_WATCH_SIZE]);
+
+/**
+ * @brief S2C 패킷 인코딩 (버전 1, 항상 전체)
+ * @param out WIRE_MAX_PACKET 바이트 이상
+ * @return 쓴 바이트 수
+ */
+size_t wire_encode_packet(const S2C_Packet *pkt, uint8_t *out);
+
+/**
+ * @brief S2C 패킷 디코딩 (버전 1, 스트림에서 받은 만큼 넘겨도 됨)
+ * @param len in에 들어 있는 바이트 수
+ * @return 읽은 바이트 수, 패킷이 아직 다 오지 않았으면 0, 잘못된 패킷이면 -1
+ */
+int wire_decode_packet(const uint8_t *in, size_t len, S2C_Packet *pkt);
+
+/**
+ * @brief 기준 상태 없이 초기화 (첫 패킷은 키프레임)
+ */
+void wire_stream_init(WireStream *s);
+
+/**
+ * @brief 버전 2 인코딩: 기준 상태와 비교해서 델타나 키프레임을 쓰고 기준 상태를 갱신
+ * @param ack 이 상태까지 처리한 마지막 입력 번호 (버전 4 플레이어에게만, 아니면 -1)
+ * @param keyframe true면 무조건 키프레임 (재동기화 요청 등)
+ * @return 쓴 바이트 수 (WIRE_MAX_PACKET 이하)
+ */
+size_t wire_encode_stream(WireStream *s, const S2C_Packet *pkt, int ack, uint8_t *out, bool keyframe);
+
+/**
+ * @brief 버전 2 디코딩: 델타면 기준 상태 위에 적용, 성공하면 기준 상태 갱신
+ * @return wire_decode_packet과 같음 (기준 상태 없이 델타가 오면 -1, 이때는 키프레임 요청)
+ */
+int wire_decode_stream(WireStream *s, const uint8_t *in, size_t len, S2C_Packet *pkt);
+
+/**
+ * @brief 버전 5 사건 인코딩
+ * @param out WIRE_MAX_LOCK 바이트 이상
+ * @return 쓴 바이트 수
+ */
+size_t wire_encode_lock(const LockEvent *ev, uint8_t *out);
+
+/**
+ * @brief 버전 5 사건 디코딩 (LOCK_STATE면 state의 나머지 필드는 0)
+ * @return wire_decode_packet과 같음
+ */
+int wire_decode_lock(const uint8_t *in, size_t len, LockEvent *ev);
+
+/**
+ * @brief C2S 요청 인코딩 / 디코딩
+ * @return 디코딩: 성공 0, 알 수 없는 행동이면 -1
+ */
+uint8_t wire_encode_action(ClientAction action);
+int wire_decode_action(uint8_t in, ClientAction *action);
+
+/**
+ * @brief 예전 형식 요청(C2S_Packet, 행동 enum을 그대로 4바이트로 보냄) 디코딩
+ * @return 성공 0, MOVE_UP ~ QUIT 밖의 값이면 -1
+ */
+int wire_decode_raw(const uint8_t *in, ClientAction *action);
+
+/**
+ * @brief 요청 하나를 버전에 맞는 틀로 씀 (버전 1, 2는 1바이트, 3부터 길이 바이트 + 요청 종류)
+ * @param code wire_encode_action의 결과 또는 WIRE_KEYFRAME_REQUEST
+ * @param seq 입력 번호 (버전 4만, 번호 없는 요청은 -1)
+ * @param out WIRE_MAX_REQUEST 바이트 이상
+ * @return 쓴 바이트 수
+ */
+size_t wire_encode_request(uint8_t *out, int version, uint8_t code, int seq);
+
+/**
+ * @brief 받아 둔 바이트의 맨 앞 요청 하나의 크기 (길이 바이트 포함)
+ * @param len in에 들어 있는 바이트 수 (요청 전체가 오지 않았어도 됨)
+ * @return 요청 크기, 길이 바이트가 아직 안 왔으면 0, 너무 긴 요청이면 -1
+ */
+int wire_request_size(const uint8_t *in, size_t len, int version);
+
+/**
+ * @brief 틀을 벗긴 요청 종류
+ * @param in wire_request_size만큼 받은 요청
+ * @return 요청 종류, 빈 요청이면 -1
+ */
+int wire_request_code(const uint8_t *in, int version);
+
+/**
+ * @brief 요청의 입력 번호 (버전 4만)
+ * @return 입력 번호, 없으면 -1
+ */
+int wire_request_seq(const uint8_t *in, int version);
+
+#endif // WIRE_H
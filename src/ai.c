@@ -0,0 +1,462 @@
+#define _DEFAULT_SOURCE
+#include "ai.h"
+#include <stdlib.h>  // calloc(), free()
+#include <string.h>  // memset()
+#include <math.h>    // powf()
+#include <time.h>    // clock_gettime()
+#include <stdatomic.h>
+#include <pthread.h> // pthread_once()
+
+#include "task_pool.h"
+
+// ==========================================
+// [1] 휴리스틱 테이블
+// ==========================================
+// 행(또는 열) 하나의 점수를 65536개 전부 미리 계산해 두고, 보드 평가는 8번 조회로 끝냄
+
+#define HEUR_LOST_PENALTY   200000.0f // 살아있는 보드 기본 점수 (움직일 수 없는 보드는 0)
+#define HEUR_EMPTY_WEIGHT   270.0f    // 빈칸 하나당 가점
+#define HEUR_MERGE_WEIGHT   700.0f    // 바로 합칠 수 있는 이웃 가점
+#define HEUR_MONO_POWER     4.0f      // 한쪽으로 정렬된(단조) 정도 계산용 지수
+#define HEUR_MONO_WEIGHT    47.0f     // 단조성이 깨진 만큼 감점
+#define HEUR_SUM_POWER      3.5f      // 큰 타일이 흩어져 있을수록 감점
+#define HEUR_SUM_WEIGHT     11.0f
+
+static float heur_table[BB_ROW_COUNT];
+static pthread_once_t heur_once = PTHREAD_ONCE_INIT;
+
+static void build_heur_table(void) {
+    for (int row = 0; row < BB_ROW_COUNT; row++) {
+        int line[4];
+        for (int i = 0; i < 4; i++) line[i] = (row >> (4 * i)) & 0xF;
+
+        float sum = 0;
+        int empty = 0, merges = 0;
+        int prev = 0, run = 0;
+        for (int i = 0; i < 4; i++) {
+            sum += powf((float)line[i], HEUR_SUM_POWER);
+            if (line[i] == 0) {
+                empty++;
+                continue;
+            }
+            // 같은 타일이 연속되는 구간 길이로 합칠 수 있는 수를 셈
+            if (prev == line[i]) {
+                run++;
+            } else if (run > 0) {
+                merges += 1 + run;
+                run = 0;
+            }
+            prev = line[i];
+        }
+        if (run > 0) merges += 1 + run;
+
+        // 왼쪽/오른쪽 중 덜 깨진 쪽의 단조성 위반량
+        float mono_left = 0, mono_right = 0;
+        for (int i = 1; i < 4; i++) {
+            float a = powf((float)line[i - 1], HEUR_MONO_POWER);
+            float b = powf((float)line[i], HEUR_MONO_POWER);
+            if (line[i - 1] > line[i]) mono_left += a - b;
+            else mono_right += b - a;
+        }
+
+        heur_table[row] = HEUR_LOST_PENALTY +
+                          HEUR_EMPTY_WEIGHT * empty +
+                          HEUR_MERGE_WEIGHT * merges -
+                          HEUR_MONO_WEIGHT * (mono_left < mono_right ? mono_left : mono_right) -
+                          HEUR_SUM_WEIGHT * sum;
+    }
+}
+
+float ai_evaluate(Board b) {
+    Board t = bb_transpose(b);
+    float score = 0;
+    for (int r = 0; r < 4; r++) {
+        score += heur_table[BB_ROW(b, r)] + heur_table[BB_ROW(t, r)];
+    }
+    return score;
+}
+
+// ==========================================
+// [2] 트랜스포지션 테이블 (스레드 공유, 잠금 없음)
+// ==========================================
+// 같은 보드가 다른 이동 순서로 다시 나오면 (남은 깊이가 같거나 얕을 때) 저장된 값을 재사용
+// 탐색마다 세대 번호를 올려서 테이블을 지우지 않고 이전 탐색 결과를 무효화
+//
+// 항목은 8바이트 두 개 (check = key ^ data), 두 스레드가 같은 칸에 동시에 써서
+// key와 data가 섞이면 check가 맞지 않아 그냥 없는 항목으로 취급됨
+
+typedef struct {
+    _Atomic uint64_t check; // 보드 ^ data
+    _Atomic uint64_t data;  // 값(float 비트) | 남은 깊이 << 32 | 세대 번호 << 40
+} TtEntry;
+
+#define AI_MAX_DEPTH   12   // 시간 제한 탐색에서 더 깊게 내려가지 않는 한계
+#define TIME_CHECK_MASK 4095 // max 노드 4096개마다 한 번 시계 확인
+
+// 스레드별 탐색 상태 (다른 스레드와 캐시 라인을 나눠 쓰지 않도록 정렬)
+typedef struct {
+    AiSearch *ai;
+    long nodes;
+} __attribute__((aligned(64))) AiWorker;
+
+// 병렬 탐색에서 스레드 풀에 넘기는 작업 하나 = 위쪽 트리 말단의 max 노드
+typedef struct {
+    Board board;
+    int depth;
+    float cprob;
+    float value;
+} SplitTask;
+
+struct AiSearch {
+    AiConfig config;
+    TtEntry *tt;
+    uint64_t tt_mask;
+    uint8_t generation;
+
+    AiWorker *workers;      // [threads]
+    TaskPool *pool;         // threads > 1 일 때만
+
+    SplitTask *tasks;       // 병렬 탐색 한 깊이분의 작업 목록
+    int task_count, task_cap;
+
+    atomic_bool stop;       // 시간 초과 (모든 스레드가 확인하고 빠져나옴)
+    uint64_t deadline_ns;   // 0이면 시간 제한 없음
+};
+
+static inline TtEntry *tt_slot(AiSearch *ai, Board b) {
+    uint64_t h = (b ^ (b >> 29)) * 0x9E3779B97F4A7C15ULL;
+    return &ai->tt[(h >> 17) & ai->tt_mask];
+}
+
+static inline bool tt_probe(AiSearch *ai, Board b, int depth, float *value) {
+    TtEntry *slot = tt_slot(ai, b);
+    uint64_t data = atomic_load_explicit(&slot->data, memory_order_relaxed);
+    uint64_t check = atomic_load_explicit(&slot->check, memory_order_relaxed);
+    if ((check ^ data) != b) return false;
+    if ((uint8_t)(data >> 40) != ai->generation || (int)((data >> 32) & 0xFF) < depth) return false;
+
+    uint32_t bits = (uint32_t)data;
+    memcpy(value, &bits, sizeof(bits));
+    return true;
+}
+
+static inline void tt_store(AiSearch *ai, Board b, int depth, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint64_t data = bits | ((uint64_t)depth << 32) | ((uint64_t)ai->generation << 40);
+
+    TtEntry *slot = tt_slot(ai, b);
+    atomic_store_explicit(&slot->check, b ^ data, memory_order_relaxed);
+    atomic_store_explicit(&slot->data, data, memory_order_relaxed);
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// ==========================================
+// [3] Expectimax 탐색
+// ==========================================
+
+static float chance_node(AiWorker *w, Board b, int depth, float cprob);
+
+// 내 차례: 움직일 수 있는 방향 중 최댓값 (움직일 수 없으면 0 = 게임 오버)
+static float max_node(AiWorker *w, Board b, int depth, float cprob) {
+    AiSearch *ai = w->ai;
+    if (atomic_load_explicit(&ai->stop, memory_order_relaxed)) return 0;
+    if ((++w->nodes & TIME_CHECK_MASK) == 0 && ai->deadline_ns && now_ns() >= ai->deadline_ns) {
+        atomic_store_explicit(&ai->stop, true, memory_order_relaxed);
+        return 0;
+    }
+
+    Board out[4];
+    int score[4];
+    float best = 0;
+
+    // 탐색은 앞 결과에 의존하는 지연 시간 위주라 AVX2 bb_move_all보다 테이블 이동 4번이 빠름 (측정 기준 약 3.5배)
+    for (int d = 0; d < 4; d++) out[d] = bb_move(b, (Direction)d, &score[d]);
+    for (int d = 0; d < 4; d++) {
+        if (out[d] == b) continue;
+        float v = chance_node(w, out[d], depth, cprob);
+        if (v > best) best = v;
+    }
+    return best;
+}
+
+// 타일 생성 차례: 빈칸마다 2(90%), 4(10%)의 기대값
+static float chance_node(AiWorker *w, Board b, int depth, float cprob) {
+    AiSearch *ai = w->ai;
+
+    // 깊이를 다 썼거나, 여기까지 올 확률이 너무 낮으면 평가로 대신함
+    if (depth <= 0 || cprob < ai->config.prob_cutoff) {
+        return ai_evaluate(b);
+    }
+
+    float value;
+    if (tt_probe(ai, b, depth, &value)) return value;
+
+    w->nodes++;
+    uint16_t empty = bb_empty_mask(b);
+    int empty_cnt = __builtin_popcount(empty);
+    cprob /= (float)empty_cnt;
+
+    // 4가 나오는 분기(10%)가 기준 확률보다 낮으면 더 펼치지 않고 바로 평가
+    bool expand_four = (cprob * 0.1f >= ai->config.prob_cutoff);
+
+    float sum = 0;
+    while (empty) {
+        int i = __builtin_ctz(empty);
+        empty &= empty - 1;
+        Board two = b | (1ULL << (4 * i));
+        Board four = b | (2ULL << (4 * i));
+        sum += 0.9f * max_node(w, two, depth - 1, cprob * 0.9f);
+        sum += 0.1f * (expand_four ? max_node(w, four, depth - 1, cprob * 0.1f) : ai_evaluate(four));
+    }
+    value = sum / (float)empty_cnt;
+
+    // 중단된 탐색의 값은 일부 자식이 0으로 빠진 값이라 저장하지 않음
+    if (atomic_load_explicit(&ai->stop, memory_order_relaxed)) return 0;
+    tt_store(ai, b, depth, value);
+    return value;
+}
+
+// ==========================================
+// [4] 병렬 탐색 (위쪽 트리를 작업으로 쪼개기)
+// ==========================================
+// 루트부터 chance 층 plies개까지는 직접 펼쳐서 그 아래 max 노드들을 작업으로 모으고(collect),
+// 스레드 풀이 작업을 모두 끝내면 똑같은 순서로 다시 펼치면서 작업 결과로 기대값을 합침(combine)
+// 가지치기 조건(깊이, 확률)은 보드만으로 정해지므로 두 번 펼쳐도 작업 순서가 같음
+
+typedef struct {
+    AiSearch *ai;
+    bool combine;   // false: 작업 수집, true: 결과 합치기
+    int next;       // 다음 작업 번호
+    bool failed;    // 작업 목록 할당 실패
+} Splitter;
+
+static float split_chance(Splitter *sp, Board b, int depth, float cprob, int plies);
+
+// plies를 다 쓴 max 노드는 작업 하나
+static float split_leaf(Splitter *sp, Board b, int depth, float cprob) {
+    AiSearch *ai = sp->ai;
+    if (sp->combine) return ai->tasks[sp->next++].value;
+
+    if (ai->task_count == ai->task_cap) {
+        int cap = ai->task_cap ? ai->task_cap * 2 : 256;
+        SplitTask *tasks = realloc(ai->tasks, sizeof(SplitTask) * (size_t)cap);
+        if (!tasks) {
+            sp->failed = true;
+            return 0;
+        }
+        ai->tasks = tasks;
+        ai->task_cap = cap;
+    }
+    ai->tasks[ai->task_count++] = (SplitTask){ .board = b, .depth = depth, .cprob = cprob, .value = 0 };
+    sp->next++;
+    return 0;
+}
+
+static float split_max(Splitter *sp, Board b, int depth, float cprob, int plies) {
+    if (plies <= 0) return split_leaf(sp, b, depth, cprob);
+
+    float best = 0;
+    for (int d = 0; d < 4; d++) {
+        int score;
+        Board out = bb_move(b, (Direction)d, &score);
+        if (out == b) continue;
+        float v = split_chance(sp, out, depth, cprob, plies);
+        if (v > best) best = v;
+    }
+    return best;
+}
+
+// chance_node와 같은 규칙으로 펼침 (트랜스포지션 테이블은 사용 안 함)
+static float split_chance(Splitter *sp, Board b, int depth, float cprob, int plies) {
+    AiSearch *ai = sp->ai;
+    if (depth <= 0 || cprob < ai->config.prob_cutoff) {
+        return ai_evaluate(b);
+    }
+
+    uint16_t empty = bb_empty_mask(b);
+    int empty_cnt = __builtin_popcount(empty);
+    cprob /= (float)empty_cnt;
+    bool expand_four = (cprob * 0.1f >= ai->config.prob_cutoff);
+
+    float sum = 0;
+    while (empty) {
+        int i = __builtin_ctz(empty);
+        empty &= empty - 1;
+        Board two = b | (1ULL << (4 * i));
+        Board four = b | (2ULL << (4 * i));
+        sum += 0.9f * split_max(sp, two, depth - 1, cprob * 0.9f, plies - 1);
+        sum += 0.1f * (expand_four ? split_max(sp, four, depth - 1, cprob * 0.1f, plies - 1) : ai_evaluate(four));
+    }
+    return sum / (float)empty_cnt;
+}
+
+static void run_split_task(void *ctx, int index, int worker) {
+    AiSearch *ai = ctx;
+    SplitTask *t = &ai->tasks[index];
+    t->value = max_node(&ai->workers[worker], t->board, t->depth, t->cprob);
+}
+
+// 스레드마다 훔쳐갈 작업이 충분하도록 (스레드당 8개 이상) 쪼갤 chance 층 수를 고르고 작업 수집
+// @return 고른 층 수, 작업 목록 할당 실패 시 0
+static int split_collect(AiSearch *ai, const Board out[4], Board b, int depth) {
+    int threads = task_pool_threads(ai->pool);
+    for (int plies = 1; ; plies++) {
+        Splitter sp = { .ai = ai, .combine = false, .next = 0, .failed = false };
+        ai->task_count = 0;
+        for (int d = 0; d < 4; d++) {
+            if (out[d] != b) split_chance(&sp, out[d], depth - 1, 1.0f, plies);
+        }
+        if (sp.failed) return 0;
+        if (ai->task_count >= threads * 8 || plies >= depth - 2) return plies;
+    }
+}
+
+// ==========================================
+// [5] 루트 탐색
+// ==========================================
+
+// 자동 깊이: 서로 다른 타일 종류가 많을수록 (후반일수록) 깊게
+static int auto_depth(Board b) {
+    uint16_t kinds = 0;
+    for (int i = 0; i < 16; i++) {
+        kinds |= (uint16_t)(1u << ((b >> (4 * i)) & 0xF));
+    }
+    int distinct = __builtin_popcount(kinds & ~1u); // 빈칸 제외
+    int depth = distinct - 2;
+    if (depth < 3) depth = 3;
+    if (depth > 8) depth = 8;
+    return depth;
+}
+
+// 고정 깊이 한 번 탐색, 시간 초과로 중단되면 false (res는 그대로)
+static bool search_depth(AiSearch *ai, Board b, int depth, AiResult *res) {
+    Board out[4];
+    float value[4] = {0};
+    for (int d = 0; d < 4; d++) {
+        int score;
+        out[d] = bb_move(b, (Direction)d, &score);
+    }
+
+    int plies = (ai->pool && depth >= 3) ? split_collect(ai, out, b, depth) : 0;
+    if (plies > 0) {
+        task_pool_run(ai->pool, run_split_task, ai, ai->task_count);
+
+        Splitter sp = { .ai = ai, .combine = true, .next = 0, .failed = false };
+        for (int d = 0; d < 4; d++) {
+            if (out[d] != b) value[d] = split_chance(&sp, out[d], depth - 1, 1.0f, plies);
+        }
+    } else {
+        for (int d = 0; d < 4; d++) {
+            // 루트 이동도 깊이 하나로 셈 (depth = 내다보는 이동 수)
+            if (out[d] != b) value[d] = chance_node(&ai->workers[0], out[d], depth - 1, 1.0f);
+        }
+    }
+    if (atomic_load_explicit(&ai->stop, memory_order_relaxed)) return false;
+
+    AiResult r = { .move = UP, .expected = 0, .valid = false, .depth = depth, .nodes = 0 };
+    for (int d = 0; d < 4; d++) {
+        if (out[d] == b) continue;
+        if (!r.valid || value[d] > r.expected) {
+            r.move = (Direction)d;
+            r.expected = value[d];
+            r.valid = true;
+        }
+    }
+    *res = r;
+    return true;
+}
+
+// ==========================================
+// [6] 공개 함수 구현
+// ==========================================
+
+void ai_default_config(AiConfig *config) {
+    config->depth = 0;
+    config->prob_cutoff = 0.0001f;
+    config->tt_bits = 18;
+    config->threads = 1;
+    config->time_ms = 0;
+}
+
+AiSearch *ai_create(const AiConfig *config) {
+    bb_init();
+    pthread_once(&heur_once, build_heur_table);
+
+    AiSearch *ai = calloc(1, sizeof(AiSearch));
+    if (!ai) return NULL;
+
+    ai->config = *config;
+    if (ai->config.tt_bits < 10) ai->config.tt_bits = 10;
+    if (ai->config.threads < 1) ai->config.threads = 1;
+    ai->tt_mask = (1ULL << ai->config.tt_bits) - 1;
+    ai->tt = calloc(ai->tt_mask + 1, sizeof(TtEntry));
+    ai->workers = aligned_alloc(64, sizeof(AiWorker) * (size_t)ai->config.threads);
+    if (ai->config.threads > 1) ai->pool = task_pool_create(ai->config.threads);
+    if (!ai->tt || !ai->workers || (ai->config.threads > 1 && !ai->pool)) {
+        ai_destroy(ai);
+        return NULL;
+    }
+    // 스레드를 일부만 만들었으면 그만큼만 사용
+    if (ai->pool) ai->config.threads = task_pool_threads(ai->pool);
+    for (int i = 0; i < ai->config.threads; i++) {
+        ai->workers[i] = (AiWorker){ .ai = ai, .nodes = 0 };
+    }
+    return ai;
+}
+
+void ai_destroy(AiSearch *ai) {
+    if (!ai) return;
+    task_pool_destroy(ai->pool);
+    free(ai->tasks);
+    free(ai->workers);
+    free(ai->tt);
+    free(ai);
+}
+
+AiResult ai_search(AiSearch *ai, Board b) {
+    AiResult res = { .move = UP, .expected = 0, .valid = false, .depth = 0, .nodes = 0 };
+
+    // 세대 번호가 한 바퀴 돌면 오래된 항목과 헷갈리지 않도록 테이블을 비움
+    if (++ai->generation == 0) {
+        memset(ai->tt, 0, (ai->tt_mask + 1) * sizeof(TtEntry));
+        ai->generation = 1;
+    }
+    for (int i = 0; i < ai->config.threads; i++) ai->workers[i].nodes = 0;
+    atomic_store(&ai->stop, false);
+    ai->deadline_ns = 0;
+
+    if (ai->config.time_ms <= 0) {
+        int depth = (ai->config.depth > 0) ? ai->config.depth : auto_depth(b);
+        search_depth(ai, b, depth, &res);
+    } else {
+        // 시간 제한: 깊이 2부터 하나씩 늘리며 시간 안에 끝난 가장 깊은 결과를 사용
+        // (첫 탐색은 항상 끝까지 함, 지난 탐색보다 남은 시간이 짧으면 다음 깊이는 시작하지 않음)
+        int max_depth = (ai->config.depth > 0) ? ai->config.depth : AI_MAX_DEPTH;
+        uint64_t start = now_ns();
+        uint64_t budget = (uint64_t)ai->config.time_ms * 1000000ULL;
+        uint64_t last = 0;
+
+        for (int depth = 2; depth <= max_depth; depth++) {
+            uint64_t t0 = now_ns();
+            if (depth > 2) {
+                if (t0 - start + last > budget) break;
+                ai->deadline_ns = start + budget;
+            }
+            if (!search_depth(ai, b, depth, &res)) break;
+            last = now_ns() - t0;
+        }
+    }
+
+    for (int i = 0; i < ai->config.threads; i++) res.nodes += ai->workers[i].nodes;
+    return res;
+}
+
+AiResult ai_best_move(AiSearch *ai, const GameState *state) {
+    return ai_search(ai, bb_from_array(state->board));
+}
@@ -0,0 +1,94 @@
+// AI 병렬 탐색 벤치마크: 고정된 국면 묶음을 스레드 수를 바꿔가며 같은 시간 제한으로 탐색해서
+// 초당 노드 수와 도달한 깊이가 스레드 수에 따라 얼마나 늘어나는지 출력
+// 사용법: ./bin/ai_bench [국면 수=32] [한 수당 ms=50] [최대 스레드 수=코어 수]
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>     // clock_gettime()
+#include <unistd.h>   // sysconf()
+#include "game.h"
+#include "bitboard.h"
+#include "ai.h"
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// 얕은 AI로 시드 게임을 진행하면서 일정 간격으로 국면을 뽑음 (초반~후반이 고루 섞이도록)
+static int collect_positions(Board *out, int count) {
+    AiConfig config;
+    ai_default_config(&config);
+    config.depth = 2;
+    AiSearch *ai = ai_create(&config);
+    if (!ai) return 0;
+
+    int n = 0;
+    for (uint64_t seed = 1; n < count; seed++) {
+        GameState g;
+        game_init_seeded(&g, seed, 0);
+        for (int moves = 0; !g.game_over && n < count; moves++) {
+            if (moves % 97 == 50) out[n++] = bb_from_array(g.board);
+            AiResult r = ai_best_move(ai, &g);
+            if (!r.valid) break;
+            game_move(&g, r.move);
+            if (g.moved) game_spawn_tile(&g);
+            game_is_over(&g);
+        }
+    }
+    ai_destroy(ai);
+    return n;
+}
+
+int main(int argc, char *argv[]) {
+    int count = (argc > 1) ? atoi(argv[1]) : 32;
+    int budget_ms = (argc > 2) ? atoi(argv[2]) : 50;
+    int max_threads = (argc > 3) ? atoi(argv[3]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (count < 1) count = 1;
+    if (budget_ms < 1) budget_ms = 1;
+    if (max_threads < 1) max_threads = 1;
+
+    bb_init();
+    Board *positions = malloc(sizeof(Board) * (size_t)count);
+    if (!positions) return 1;
+    count = collect_positions(positions, count);
+
+    printf("국면 %d개, 한 수당 %dms\n", count, budget_ms);
+    printf("%8s %14s %10s %10s %12s\n", "threads", "nodes/s", "speedup", "avg depth", "avg ms/move");
+
+    double base = 0;
+    for (int threads = 1; ; ) {
+        AiConfig config;
+        ai_default_config(&config);
+        config.threads = threads;
+        config.time_ms = budget_ms;
+        AiSearch *ai = ai_create(&config);
+        if (!ai) {
+            fprintf(stderr, "ai_create 실패 (threads=%d)\n", threads);
+            return 1;
+        }
+
+        long nodes = 0, depth_sum = 0;
+        double t0 = now_sec();
+        for (int i = 0; i < count; i++) {
+            AiResult r = ai_search(ai, positions[i]);
+            nodes += r.nodes;
+            depth_sum += r.depth;
+        }
+        double elapsed = now_sec() - t0;
+        ai_destroy(ai);
+
+        double nps = (double)nodes / elapsed;
+        if (threads == 1) base = nps;
+        printf("%8d %14.0f %9.2fx %10.2f %12.2f\n", threads, nps, nps / base,
+               (double)depth_sum / count, elapsed * 1e3 / count);
+
+        // 1, 2, 4, ... 로 늘리고 마지막은 항상 최대 스레드 수로 측정
+        if (threads == max_threads) break;
+        threads = (threads * 2 > max_threads) ? max_threads : threads * 2;
+    }
+
+    free(positions);
+    return 0;
+}
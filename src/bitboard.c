@@ -0,0 +1,384 @@
+#include "bitboard.h"
+#include "bitboard_simd.h"
+#include <pthread.h> // pthread_once()
+#include <assert.h>
+
+#if defined(BB_HAVE_X86_KERNELS)
+#include <immintrin.h> // _pdep_u32()
+#endif
+
+// ==========================================
+// [1] 내부 헬퍼 함수 (Internal Helper Functions)
+// ==========================================
+
+// 각 니블의 최상위 비트 / 최하위 비트 마스크
+#define NIBBLE_HI 0x8888888888888888ULL
+#define NIBBLE_LO 0x1111111111111111ULL
+
+// 행 이동 테이블: 16비트 행 값을 그대로 인덱스로 사용
+#ifdef BB_STATIC_TABLES
+// 빌드 시점에 gen_tables가 생성한 테이블 (make BB_STATIC_TABLES=1)
+static const BbRow row_table[BB_ROW_COUNT] = {
+#include "bb_tables.inc"
+};
+const BbRow *bb_rows = row_table;
+
+static void build_row_table(void) {
+}
+#else
+// 실행 시점에 bb_init()에서 채우는 테이블
+static BbRow row_table[BB_ROW_COUNT];
+const BbRow *bb_rows = row_table;
+
+// 한 행의 니블 순서를 뒤집음 (RIGHT 이동 = 뒤집고 LEFT 이동 후 다시 뒤집기)
+static uint16_t row_reverse(uint16_t row) {
+    return (uint16_t)((row >> 12) | ((row >> 4) & 0x00F0) |
+                      ((row << 4) & 0x0F00) | (row << 12));
+}
+
+static void build_row_table(void) {
+    for (int row = 0; row < BB_ROW_COUNT; row++) {
+        // LEFT/RIGHT 점수는 같으므로 RIGHT 쪽 점수는 버림
+        int score = 0, unused = 0;
+        uint16_t left = bb_row_left((uint16_t)row, &score);
+        uint16_t right = row_reverse(bb_row_left(row_reverse((uint16_t)row), &unused));
+
+        row_table[row].left = left;
+        row_table[row].right = right;
+        row_table[row].score = (uint32_t)score;
+        row_table[row].moved_left = (left != row);
+        row_table[row].moved_right = (right != row);
+    }
+}
+#endif
+
+// 모든 행에 LEFT 또는 RIGHT 이동 적용 (행마다 테이블 한 번 조회)
+static Board move_rows(Board b, bool reverse, int *score) {
+    Board out = 0;
+    int gained = 0;
+    for (int r = 0; r < 4; r++) {
+        const BbRow *e = &bb_rows[BB_ROW(b, r)];
+        out |= (Board)(reverse ? e->right : e->left) << (16 * r);
+        gained += e->score;
+    }
+    *score += gained;
+    return out;
+}
+
+// 모든 행 중 하나라도 해당 방향으로 움직이는지
+static bool rows_can_move(Board b, bool reverse) {
+    for (int r = 0; r < 4; r++) {
+        const BbRow *e = &bb_rows[BB_ROW(b, r)];
+        if (reverse ? e->moved_right : e->moved_left) return true;
+    }
+    return false;
+}
+
+// 칸(니블)마다 값이 0이면 그 니블의 최하위 비트만 1 (SWAR)
+static Board zero_nibble_bits(Board x) {
+    x |= x >> 1;
+    x |= x >> 2;
+    return ~x & NIBBLE_LO;
+}
+
+// 칸(니블)마다 값이 2^15(0xF)이면 그 니블의 최하위 비트만 1
+static Board max_nibble_bits(Board x) {
+    return x & (x >> 1) & (x >> 2) & (x >> 3) & NIBBLE_LO;
+}
+
+// 니블 최하위 비트 16개(비트 0, 4, 8, ... 60)를 16비트로 모음
+static uint16_t gather_nibble_bits(Board m) {
+    m = (m | (m >> 3))  & 0x0303030303030303ULL;
+    m = (m | (m >> 6))  & 0x000F000F000F000FULL;
+    m = (m | (m >> 12)) & 0x000000FF000000FFULL;
+    m = (m | (m >> 24)) & 0x000000000000FFFFULL;
+    return (uint16_t)m;
+}
+
+// k번째(0부터) 켜진 비트의 위치: BMI2가 있으면 pdep 한 번
+#if defined(BB_HAVE_X86_KERNELS)
+static bool have_bmi2 = false;
+
+__attribute__((target("bmi2")))
+static int select_bit_bmi2(uint32_t mask, int k) {
+    return __builtin_ctz(_pdep_u32(1u << k, mask));
+}
+#endif
+
+// BMI2가 없을 때: 바이트 단위로 건너뛴 뒤 최대 7번 하위 비트 지우기
+static int select_bit_portable(uint32_t mask, int k) {
+    int base = 0;
+    int low = __builtin_popcount(mask & 0xFF);
+    if (k >= low) {
+        k -= low;
+        mask >>= 8;
+        base = 8;
+    }
+    while (k-- > 0) mask &= mask - 1;
+    return base + __builtin_ctz(mask);
+}
+
+// 테이블만 쓰는 이동 (BB_KERNEL_SCALAR)
+static Board move_scalar(Board b, Direction dir, int *score) {
+    int gained = 0;
+    Board out = b;
+
+    switch (dir) {
+        case LEFT:  out = move_rows(b, false, &gained); break;
+        case RIGHT: out = move_rows(b, true, &gained);  break;
+        // 전치하면 열이 행이 되므로 UP = 전치 후 LEFT, DOWN = 전치 후 RIGHT
+        case UP:    out = bb_transpose(move_rows(bb_transpose(b), false, &gained)); break;
+        case DOWN:  out = bb_transpose(move_rows(bb_transpose(b), true, &gained));  break;
+    }
+
+    if (score) *score = gained;
+    return out;
+}
+
+static void move_all_scalar(Board b, Board out[4], int score[4]) {
+    for (int d = UP; d <= RIGHT; d++) {
+        out[d] = move_scalar(b, (Direction)d, &score[d]);
+    }
+}
+
+#if defined(BB_HAVE_X86_KERNELS)
+static void move_all_sse41(Board b, Board out[4], int score[4]) {
+    for (int d = UP; d <= RIGHT; d++) {
+        out[d] = bb_move_sse41(b, (Direction)d, &score[d]);
+    }
+}
+#endif
+
+// 선택된 커널 (bb_init / bb_set_kernel 에서 바꿈)
+static BbKernel kernel = BB_KERNEL_SCALAR;
+static Board (*move_fn)(Board, Direction, int *) = move_scalar;
+static void (*move_all_fn)(Board, Board[4], int[4]) = move_all_scalar;
+
+static pthread_once_t init_once = PTHREAD_ONCE_INIT;
+
+static void init_once_fn(void) {
+    build_row_table();
+
+#if defined(BB_HAVE_X86_KERNELS)
+    have_bmi2 = __builtin_cpu_supports("bmi2");
+#endif
+
+    // AVX2가 있으면 사용, SSE4.1 단독 커널은 테이블보다 느려서 자동으로는 고르지 않음
+    if (!bb_set_kernel(BB_KERNEL_AVX2)) {
+        bb_set_kernel(BB_KERNEL_SCALAR);
+    }
+}
+
+// 값이 0인 니블이 하나라도 있는지 (SWAR)
+static bool has_zero_nibble(Board x) {
+    return ((x - NIBBLE_LO) & ~x & NIBBLE_HI) != 0;
+}
+
+// ==========================================
+// [2] 공개 함수 구현
+// ==========================================
+
+void bb_init(void) {
+    pthread_once(&init_once, init_once_fn);
+}
+
+bool bb_kernel_supported(BbKernel k) {
+    switch (k) {
+        case BB_KERNEL_SCALAR: return true;
+#if defined(BB_HAVE_X86_KERNELS)
+        case BB_KERNEL_SSE41:  return __builtin_cpu_supports("sse4.1");
+        case BB_KERNEL_AVX2:   return __builtin_cpu_supports("avx2");
+#endif
+        default:               return false;
+    }
+}
+
+bool bb_set_kernel(BbKernel k) {
+    if (!bb_kernel_supported(k)) return false;
+
+    kernel = k;
+    switch (k) {
+#if defined(BB_HAVE_X86_KERNELS)
+        case BB_KERNEL_SSE41:
+            move_fn = bb_move_sse41;
+            move_all_fn = move_all_sse41;
+            break;
+        case BB_KERNEL_AVX2:
+            // 보드 하나/한 방향은 테이블 4번 조회가 SIMD 셔플 체인보다 빠름 (측정 기준 약 2배)
+            // 네 방향을 한꺼번에 계산할 때만 AVX2로 두 방향씩 처리
+            move_fn = move_scalar;
+            move_all_fn = bb_move_all_avx2;
+            break;
+#endif
+        default:
+            move_fn = move_scalar;
+            move_all_fn = move_all_scalar;
+            break;
+    }
+    return true;
+}
+
+BbKernel bb_get_kernel(void) {
+    return kernel;
+}
+
+const char *bb_kernel_name(BbKernel k) {
+    switch (k) {
+        case BB_KERNEL_SCALAR: return "scalar";
+        case BB_KERNEL_SSE41:  return "sse4.1";
+        case BB_KERNEL_AVX2:   return "avx2";
+    }
+    return "unknown";
+}
+
+uint16_t bb_row_left(uint16_t row, int *score) {
+    int cell[4];
+    int n = 0;
+
+    // 0이 아닌 지수만 앞으로 당김
+    for (int i = 0; i < 4; i++) {
+        int e = (row >> (4 * i)) & 0xF;
+        if (e != 0) cell[n++] = e;
+    }
+
+    uint16_t out = 0;
+    int pos = 0;
+    for (int i = 0; i < n; i++) {
+        int e = cell[i];
+        // 인접한 같은 지수 합치기 (2^15끼리는 표현 범위 밖이라 합치지 않음)
+        if (i + 1 < n && cell[i + 1] == e && e < BB_MAX_EXP) {
+            e++;
+            *score += 1 << e;
+            i++; // 합쳐진 칸 건너뜀
+        }
+        out |= (uint16_t)(e << (4 * pos++));
+    }
+    return out;
+}
+
+_Static_assert(MAX_TILE == 1 << BB_MAX_EXP, "the largest tile must fit in one nibble");
+
+Board bb_from_array(const int board[4][4]) {
+    Board b = 0;
+    for (int r = 0; r < 4; r++) {
+        for (int c = 0; c < 4; c++) {
+            int v = board[r][c];
+            // 니블 하나를 넘는 값은 옆 칸을 덮어쓰므로 받지 않음 (규칙상 MAX_TILE보다 큰 타일은 생기지 않음)
+            assert(v >= 0 && v <= MAX_TILE && (v & (v - 1)) == 0);
+            // 타일 값은 항상 2의 거듭제곱이므로 하위 0비트 개수가 곧 지수
+            Board e = (v > 0) ? (Board)__builtin_ctz((unsigned)v) : 0;
+            b |= e << (16 * r + 4 * c);
+        }
+    }
+    return b;
+}
+
+void bb_to_array(Board b, int board[4][4]) {
+    for (int r = 0; r < 4; r++) {
+        for (int c = 0; c < 4; c++) {
+            int e = BB_CELL(b, r, c);
+            board[r][c] = (e == 0) ? 0 : (1 << e);
+        }
+    }
+}
+
+Board bb_transpose(Board x) {
+    // 2x2 블록 단위로 대각 원소를 교환한 뒤, 블록끼리 교환
+    Board a1 = x & 0xF0F00F0FF0F00F0FULL;
+    Board a2 = x & 0x0000F0F00000F0F0ULL;
+    Board a3 = x & 0x0F0F00000F0F0000ULL;
+    Board a  = a1 | (a2 << 12) | (a3 >> 12);
+    Board b1 = a & 0xFF00FF0000FF00FFULL;
+    Board b2 = a & 0x00FF00FF00000000ULL;
+    Board b3 = a & 0x00000000FF00FF00ULL;
+    return b1 | (b2 >> 24) | (b3 << 24);
+}
+
+Board bb_move(Board b, Direction dir, int *score) {
+    return move_fn(b, dir, score);
+}
+
+void bb_move_all(Board b, Board out[4], int score[4]) {
+    move_all_fn(b, out, score);
+}
+
+bool bb_can_move(Board b, Direction dir) {
+    switch (dir) {
+        case LEFT:  return rows_can_move(b, false);
+        case RIGHT: return rows_can_move(b, true);
+        case UP:    return rows_can_move(bb_transpose(b), false);
+        case DOWN:  return rows_can_move(bb_transpose(b), true);
+    }
+    return false;
+}
+
+int bb_count_empty(Board b) {
+    return __builtin_popcountll(zero_nibble_bits(b));
+}
+
+uint16_t bb_empty_mask(Board b) {
+    return gather_nibble_bits(zero_nibble_bits(b));
+}
+
+uint16_t bb_match_mask(Board b, int exp) {
+    // exp와 XOR 하면 같은 칸만 0이 됨
+    return gather_nibble_bits(zero_nibble_bits(b ^ ((Board)exp * NIBBLE_LO)));
+}
+
+int bb_pick_cell(uint16_t mask, Rng *rng) {
+    if (mask == 0) return -1;
+
+    int k = (int)rng_below(rng, (uint32_t)__builtin_popcount(mask));
+#if defined(BB_HAVE_X86_KERNELS)
+    if (have_bmi2) return select_bit_bmi2(mask, k);
+#endif
+    return select_bit_portable(mask, k);
+}
+
+Board bb_spawn(Board b, Rng *rng) {
+    uint16_t empty = bb_empty_mask(b);
+    if (empty == 0) return b;
+
+    // 10% 확률로 4(지수 2), 90% 확률로 2(지수 1)
+    Board e = (rng_below(rng, 10) == 0) ? 2 : 1;
+    int i = bb_pick_cell(empty, rng);
+    return b | (e << (4 * i));
+}
+
+Board bb_place_attack(Board b, int exp, int *pos, Rng *rng) {
+    // 공격 가능한 칸: 빈칸이거나 공격 타일과 같은 타일 (칸 번호 순서는 game_execute_attack과 동일)
+    int i = bb_pick_cell(bb_empty_mask(b) | bb_match_mask(b, exp), rng);
+    if (pos) *pos = i;
+    if (i < 0) return b;
+
+    int e = (int)((b >> (4 * i)) & 0xF);
+    Board placed = (e == 0) ? (Board)exp : (Board)(exp + 1); // 빈칸에 생성 or 합체
+    return (b & ~(0xFULL << (4 * i))) | (placed << (4 * i));
+}
+
+bool bb_is_over(Board b) {
+    // 빈 칸이 있으면 false
+    if (has_zero_nibble(b)) return false;
+
+    // 2^15끼리는 합쳐지지 않으므로 같은 타일이 이웃해도 움직일 수 없음
+    Board stuck = max_nibble_bits(b);
+
+    // 가로로 인접한 같은 타일: 오른쪽 이웃과 XOR 했을 때 0인 니블 (행의 마지막 칸은 제외)
+    Board horiz = (b ^ (b >> 4)) | 0xF000F000F000F000ULL;
+    if (zero_nibble_bits(horiz) & ~stuck) return false;
+
+    // 세로로 인접한 같은 타일: 아래 이웃과 XOR (마지막 행은 제외)
+    Board vert = (b ^ (b >> 16)) | 0xFFFF000000000000ULL;
+    if (zero_nibble_bits(vert) & ~stuck) return false;
+
+    return true;
+}
+
+int bb_max_tile(Board b) {
+    int max_e = 0;
+    for (int i = 0; i < 16; i++) {
+        int e = (int)((b >> (4 * i)) & 0xF);
+        if (e > max_e) max_e = e;
+    }
+    return (max_e == 0) ? 0 : (1 << max_e);
+}
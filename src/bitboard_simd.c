@@ -0,0 +1,212 @@
+#include "bitboard_simd.h"
+
+#if defined(BB_HAVE_X86_KERNELS)
+#include <immintrin.h>
+
+// ==========================================
+// [1] 공통 상수
+// ==========================================
+// 보드는 16바이트(칸당 1바이트, 행 r은 바이트 4r~4r+3)로 펼쳐서 처리
+// 모든 방향은 바이트 셔플로 "왼쪽 이동"으로 바꾼 뒤 같은 커널을 거치고, 역셔플로 되돌림
+
+// 방향(Direction 순서: UP, DOWN, LEFT, RIGHT)별 정방향 셔플
+static const uint8_t perm_fwd[4][16] = {
+    {0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15},   // UP: 전치
+    {12, 8, 4, 0, 13, 9, 5, 1, 14, 10, 6, 2, 15, 11, 7, 3},   // DOWN: 전치 + 행 뒤집기
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},   // LEFT: 그대로
+    {3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12},   // RIGHT: 행 뒤집기
+};
+
+// 정방향 셔플의 역
+static const uint8_t perm_inv[4][16] = {
+    {0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15},
+    {3, 7, 11, 15, 2, 6, 10, 14, 1, 5, 9, 13, 0, 4, 8, 12},
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12},
+};
+
+// 합쳐진 칸의 점수 2^e 를 하위/상위 바이트로 나눈 표 (e = 0 은 합쳐진 칸이 아니므로 0)
+static const uint8_t pow_lo[16] = {0, 2, 4, 8, 16, 32, 64, 128, 0, 0, 0, 0, 0, 0, 0, 0};
+static const uint8_t pow_hi[16] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, 128};
+
+// ==========================================
+// [2] SSE4.1 커널 (보드 하나)
+// ==========================================
+#pragma GCC push_options
+#pragma GCC target("sse4.1")
+
+// 64비트 보드 -> 16바이트 (바이트 i = 칸 i의 지수)
+static inline __m128i unpack_sse(Board b) {
+    const __m128i lo_mask = _mm_set1_epi8(0x0F);
+    __m128i x = _mm_cvtsi64_si128((long long)b);
+    __m128i lo = _mm_and_si128(x, lo_mask);
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(x, 4), lo_mask);
+    return _mm_unpacklo_epi8(lo, hi);
+}
+
+// 16바이트 -> 64비트 보드 (이웃한 두 바이트를 lo + 16*hi 로 묶음)
+static inline Board pack_sse(__m128i cells) {
+    __m128i pairs = _mm_maddubs_epi16(cells, _mm_set1_epi16(0x1001));
+    return (Board)_mm_cvtsi128_si64(_mm_packus_epi16(pairs, pairs));
+}
+
+// 각 행(32비트 레인)의 0이 아닌 칸을 왼쪽으로 모음
+// 칸마다 "왼쪽에 있는 빈칸 수 d"를 구해 d의 비트별로 1칸, 2칸씩 옮김 (서로 겹치지 않음)
+static inline __m128i compact_sse(__m128i x) {
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i bit0 = _mm_set1_epi8(0x10);
+    const __m128i bit1 = _mm_set1_epi8(0x20);
+
+    __m128i nz = _mm_cmpgt_epi8(x, _mm_setzero_si128());
+    __m128i z = _mm_andnot_si128(nz, one);
+    __m128i t = _mm_slli_epi32(z, 8);
+    __m128i d = _mm_add_epi8(_mm_add_epi8(t, _mm_slli_epi32(t, 8)), _mm_slli_epi32(t, 16));
+    d = _mm_and_si128(d, nz);
+
+    // 지수(하위 4비트)와 이동 거리(비트 4~5)를 한 바이트에 같이 실어서 옮김
+    __m128i y = _mm_or_si128(x, _mm_slli_epi16(d, 4));
+
+    __m128i m = _mm_cmpeq_epi8(_mm_and_si128(y, bit0), bit0);
+    y = _mm_or_si128(_mm_andnot_si128(m, y), _mm_srli_epi32(_mm_and_si128(m, y), 8));
+    m = _mm_cmpeq_epi8(_mm_and_si128(y, bit1), bit1);
+    y = _mm_or_si128(_mm_andnot_si128(m, y), _mm_srli_epi32(_mm_and_si128(m, y), 16));
+
+    return _mm_and_si128(y, _mm_set1_epi8(0x0F));
+}
+
+// 모아진 행에서 왼쪽부터 같은 칸을 합치고, 얻은 점수를 64비트 레인 두 개에 나눠 돌려줌
+static inline __m128i merge_sse(__m128i x, __m128i *score) {
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i pos0 = _mm_set1_epi32(0x000000FF);
+    const __m128i pos1 = _mm_set1_epi32(0x0000FF00);
+    const __m128i pos2 = _mm_set1_epi32(0x00FF0000);
+
+    // 오른쪽 이웃과 같고, 빈칸/2^15가 아닌 칸
+    __m128i next = _mm_srli_epi32(x, 8);
+    __m128i eq = _mm_cmpeq_epi8(x, next);
+    eq = _mm_and_si128(eq, _mm_cmpgt_epi8(x, _mm_setzero_si128()));
+    eq = _mm_and_si128(eq, _mm_cmplt_epi8(x, _mm_set1_epi8(BB_MAX_EXP)));
+
+    // 왼쪽 칸이 먼저 합쳐지면 그 오른쪽 칸은 다시 합쳐지지 않음
+    __m128i e0 = _mm_and_si128(eq, pos0);
+    __m128i e1 = _mm_andnot_si128(_mm_slli_epi32(e0, 8), _mm_and_si128(eq, pos1));
+    __m128i e2 = _mm_andnot_si128(_mm_slli_epi32(e1, 8), _mm_and_si128(eq, pos2));
+    __m128i m = _mm_or_si128(e0, _mm_or_si128(e1, e2));
+
+    x = _mm_add_epi8(x, _mm_and_si128(m, one));
+    x = _mm_andnot_si128(_mm_slli_epi32(m, 8), x);
+
+    __m128i merged = _mm_and_si128(x, m);
+    __m128i lo = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)pow_lo), merged);
+    __m128i hi = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)pow_hi), merged);
+    __m128i zero = _mm_setzero_si128();
+    *score = _mm_add_epi64(_mm_sad_epu8(lo, zero), _mm_slli_epi64(_mm_sad_epu8(hi, zero), 8));
+    return x;
+}
+
+Board bb_move_sse41(Board b, Direction dir, int *score) {
+    __m128i cells = unpack_sse(b);
+    __m128i x = _mm_shuffle_epi8(cells, _mm_loadu_si128((const __m128i *)perm_fwd[dir]));
+
+    __m128i sc;
+    x = compact_sse(merge_sse(compact_sse(x), &sc));
+
+    x = _mm_shuffle_epi8(x, _mm_loadu_si128((const __m128i *)perm_inv[dir]));
+    if (score) *score = (int)(_mm_cvtsi128_si64(sc) + _mm_extract_epi64(sc, 1));
+    return pack_sse(x);
+}
+
+#pragma GCC pop_options
+
+// ==========================================
+// [3] AVX2 커널 (128비트 레인 두 개 = 방향 두 개)
+// ==========================================
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+// 두 방향의 셔플 표를 각 128비트 레인에 하나씩 실음
+static inline __m256i perm_pair(const uint8_t lo[16], const uint8_t hi[16]) {
+    return _mm256_set_m128i(_mm_loadu_si128((const __m128i *)hi),
+                            _mm_loadu_si128((const __m128i *)lo));
+}
+
+static inline __m256i compact_avx2(__m256i x) {
+    const __m256i one = _mm256_set1_epi8(1);
+    const __m256i bit0 = _mm256_set1_epi8(0x10);
+    const __m256i bit1 = _mm256_set1_epi8(0x20);
+
+    __m256i nz = _mm256_cmpgt_epi8(x, _mm256_setzero_si256());
+    __m256i z = _mm256_andnot_si256(nz, one);
+    __m256i t = _mm256_slli_epi32(z, 8);
+    __m256i d = _mm256_add_epi8(_mm256_add_epi8(t, _mm256_slli_epi32(t, 8)), _mm256_slli_epi32(t, 16));
+    d = _mm256_and_si256(d, nz);
+
+    __m256i y = _mm256_or_si256(x, _mm256_slli_epi16(d, 4));
+
+    __m256i m = _mm256_cmpeq_epi8(_mm256_and_si256(y, bit0), bit0);
+    y = _mm256_or_si256(_mm256_andnot_si256(m, y), _mm256_srli_epi32(_mm256_and_si256(m, y), 8));
+    m = _mm256_cmpeq_epi8(_mm256_and_si256(y, bit1), bit1);
+    y = _mm256_or_si256(_mm256_andnot_si256(m, y), _mm256_srli_epi32(_mm256_and_si256(m, y), 16));
+
+    return _mm256_and_si256(y, _mm256_set1_epi8(0x0F));
+}
+
+static inline __m256i merge_avx2(__m256i x, __m256i *score) {
+    const __m256i one = _mm256_set1_epi8(1);
+    const __m256i pos0 = _mm256_set1_epi32(0x000000FF);
+    const __m256i pos1 = _mm256_set1_epi32(0x0000FF00);
+    const __m256i pos2 = _mm256_set1_epi32(0x00FF0000);
+
+    __m256i next = _mm256_srli_epi32(x, 8);
+    __m256i eq = _mm256_cmpeq_epi8(x, next);
+    eq = _mm256_and_si256(eq, _mm256_cmpgt_epi8(x, _mm256_setzero_si256()));
+    eq = _mm256_and_si256(eq, _mm256_cmpgt_epi8(_mm256_set1_epi8(BB_MAX_EXP), x));
+
+    __m256i e0 = _mm256_and_si256(eq, pos0);
+    __m256i e1 = _mm256_andnot_si256(_mm256_slli_epi32(e0, 8), _mm256_and_si256(eq, pos1));
+    __m256i e2 = _mm256_andnot_si256(_mm256_slli_epi32(e1, 8), _mm256_and_si256(eq, pos2));
+    __m256i m = _mm256_or_si256(e0, _mm256_or_si256(e1, e2));
+
+    x = _mm256_add_epi8(x, _mm256_and_si256(m, one));
+    x = _mm256_andnot_si256(_mm256_slli_epi32(m, 8), x);
+
+    __m256i merged = _mm256_and_si256(x, m);
+    __m256i lo = _mm256_shuffle_epi8(perm_pair(pow_lo, pow_lo), merged);
+    __m256i hi = _mm256_shuffle_epi8(perm_pair(pow_hi, pow_hi), merged);
+    __m256i zero = _mm256_setzero_si256();
+    *score = _mm256_add_epi64(_mm256_sad_epu8(lo, zero), _mm256_slli_epi64(_mm256_sad_epu8(hi, zero), 8));
+    return x;
+}
+
+// 레인 0 = 방향 d0, 레인 1 = 방향 d1
+static inline void move_pair_avx2(__m256i cells, Direction d0, Direction d1,
+                                  Board *out0, Board *out1, int *score0, int *score1) {
+    __m256i x = _mm256_shuffle_epi8(cells, perm_pair(perm_fwd[d0], perm_fwd[d1]));
+
+    __m256i sc;
+    x = compact_avx2(merge_avx2(compact_avx2(x), &sc));
+
+    x = _mm256_shuffle_epi8(x, perm_pair(perm_inv[d0], perm_inv[d1]));
+    __m256i pairs = _mm256_maddubs_epi16(x, _mm256_set1_epi16(0x1001));
+    __m256i packed = _mm256_packus_epi16(pairs, pairs);
+
+    *out0 = (Board)_mm256_extract_epi64(packed, 0);
+    *out1 = (Board)_mm256_extract_epi64(packed, 2);
+    *score0 = (int)(_mm256_extract_epi64(sc, 0) + _mm256_extract_epi64(sc, 1));
+    *score1 = (int)(_mm256_extract_epi64(sc, 2) + _mm256_extract_epi64(sc, 3));
+}
+
+void bb_move_all_avx2(Board b, Board out[4], int score[4]) {
+    const __m128i lo_mask = _mm_set1_epi8(0x0F);
+    __m128i x = _mm_cvtsi64_si128((long long)b);
+    __m128i cells = _mm_unpacklo_epi8(_mm_and_si128(x, lo_mask),
+                                      _mm_and_si128(_mm_srli_epi16(x, 4), lo_mask));
+    __m256i both = _mm256_broadcastsi128_si256(cells);
+
+    move_pair_avx2(both, UP, DOWN, &out[UP], &out[DOWN], &score[UP], &score[DOWN]);
+    move_pair_avx2(both, LEFT, RIGHT, &out[LEFT], &out[RIGHT], &score[LEFT], &score[RIGHT]);
+}
+
+#pragma GCC pop_options
+
+#endif // BB_HAVE_X86_KERNELS
@@ -0,0 +1,142 @@
+#define _GNU_SOURCE
+#include "bot_pool.h"
+#include <stdlib.h>       // calloc(), free()
+#include <time.h>         // clock_gettime()
+#include <unistd.h>       // gettid()
+#include <pthread.h>
+#include <sys/resource.h> // setpriority()
+
+#define BOT_NICE 10 // 작업 스레드의 nice (루프 스레드는 0)
+
+typedef struct {
+    BotPool *pool;
+    AiSearch *ai;           // 이 스레드 전용 (ai_search는 한 스레드에서만)
+    pthread_t tid;
+} BotWorker;
+
+struct BotPool {
+    BotWorker *workers;
+    int threads;            // 시작한 스레드 수
+
+    pthread_mutex_t lock;   // 아래 필드 보호
+    pthread_cond_t cv;
+    BotJob *head, *tail;    // 기다리는 작업 (넣은 순서)
+    int queued;
+    int max_queued;
+    bool shutdown;
+    BotPoolStats stats;
+};
+
+static uint64_t thread_cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// 작업을 하나씩 꺼내 탐색, 종료 요청이 오고 대기열이 비면 끝
+static void *worker_main(void *arg) {
+    BotWorker *w = arg;
+    BotPool *pool = w->pool;
+
+    // 리눅스에서는 스레드마다 nice가 따로 있음 (실패해도 탐색은 그대로)
+    setpriority(PRIO_PROCESS, (id_t)gettid(), BOT_NICE);
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->head && !pool->shutdown) pthread_cond_wait(&pool->cv, &pool->lock);
+        BotJob *job = pool->head;
+        if (!job) break;
+        pool->head = job->next;
+        if (!pool->head) pool->tail = NULL;
+        pool->queued--;
+        pthread_mutex_unlock(&pool->lock);
+
+        uint64_t t0 = thread_cpu_ns();
+        job->result = ai_search(w->ai, job->board);
+        job->cpu_ns = thread_cpu_ns() - t0;
+
+        // 통계는 done 전에 (done 뒤에는 job이 해제될 수 있고, 결과를 받은 쪽이 통계에서 이 탐색을 보게)
+        pthread_mutex_lock(&pool->lock);
+        pool->stats.searches++;
+        pool->stats.cpu_ns += job->cpu_ns;
+        pthread_mutex_unlock(&pool->lock);
+        job->done(job);
+        pthread_mutex_lock(&pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+BotPool *bot_pool_create(int threads, int max_queued, const AiConfig *config) {
+    if (threads < 1) threads = 1;
+    BotPool *pool = calloc(1, sizeof(BotPool));
+    if (!pool) return NULL;
+    pool->workers = calloc((size_t)threads, sizeof(BotWorker));
+    if (!pool->workers) {
+        free(pool);
+        return NULL;
+    }
+    pool->max_queued = max_queued;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->cv, NULL);
+
+    // 탐색 하나는 한 스레드로 (동시에 여러 봇을 생각하는 것으로 코어를 채움)
+    AiConfig cfg = *config;
+    cfg.threads = 1;
+    for (int i = 0; i < threads; i++) {
+        BotWorker *w = &pool->workers[i];
+        w->pool = pool;
+        w->ai = ai_create(&cfg);
+        if (!w->ai) break;
+        if (pthread_create(&w->tid, NULL, worker_main, w) != 0) {
+            ai_destroy(w->ai);
+            break;
+        }
+        pool->threads++;
+    }
+    if (pool->threads == 0) {
+        bot_pool_destroy(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+int bot_pool_submit(BotPool *pool, BotJob *job) {
+    pthread_mutex_lock(&pool->lock);
+    if (pool->shutdown || pool->queued >= pool->max_queued) {
+        pool->stats.rejected++;
+        pthread_mutex_unlock(&pool->lock);
+        return -1;
+    }
+    job->next = NULL;
+    if (pool->tail) pool->tail->next = job;
+    else pool->head = job;
+    pool->tail = job;
+    pool->queued++;
+    pthread_cond_signal(&pool->cv);
+    pthread_mutex_unlock(&pool->lock);
+    return 0;
+}
+
+void bot_pool_destroy(BotPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = true;
+    pthread_cond_broadcast(&pool->cv);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->threads; i++) {
+        pthread_join(pool->workers[i].tid, NULL);
+        ai_destroy(pool->workers[i].ai);
+    }
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->cv);
+    free(pool->workers);
+    free(pool);
+}
+
+void bot_pool_stats(BotPool *pool, BotPoolStats *out) {
+    pthread_mutex_lock(&pool->lock);
+    *out = pool->stats;
+    out->queued = pool->queued;
+    pthread_mutex_unlock(&pool->lock);
+}
@@ -10,7 +10,12 @@
 #include <time.h>
 
 #include "protocol.h" 
+#include "wire.h"
+#include "recv_buf.h"
+#include "predict.h"
+#include "lockstep.h"
 #include "game.h"
+#include "bitboard.h"
 
 // 전역 변수
 
@@ -21,13 +26,21 @@ int server_port = 8080;        // 기본값 설정
 
 time_t hit_timer = 0;
 
+#define RECV_BUF_SIZE 4096 // 서버에서 받아 두는 버퍼 (압축 패킷 100개 이상, 예전 구조체 패킷 20개)
+
+// 서버와 정한 전송 형식 (draw_mutex로 보호)
+// -1: 서버 응답 전 (키 입력은 버림), 0: 예전 서버라 구조체 그대로, 1 이상: 압축 형식 버전
+int wire_version = -1;
+
+// 버전 4부터 키를 누르자마자 그리는 예측 상태 (draw_mutex로 보호)
+Predictor predictor;
+
 // 함수 선언
 
 void *recv_msg(void *arg);       
 void draw_game(S2C_Packet *pkt, int is_single_mode); 
 void init_ncurses_settings();    
 void cleanup_and_exit(int exit_code, const char *msg); 
-int recv_all(int sock, void *buffer, size_t len);
 void draw_waring(int screen_height, int screen_width);
 
 // 메뉴 및 모드 관련
@@ -52,6 +65,7 @@ int main(int argc, char *argv[]) {
     }
 
     sleep(1);
+    bb_init(); // 싱글 모드용 행 이동 테이블 미리 준비
 
     // 서버연결부분 추후에 실행
     init_ncurses_settings();
@@ -214,6 +228,17 @@ void run_multiplayer_mode() {
         return; // 메뉴로 복귀
     }
 
+    // 압축 형식 요청 (예전 서버는 첫 패킷을 그대로 보내므로 recv_msg에서 구분)
+    uint8_t hello[WIRE_HELLO_SIZE];
+    wire_hello(hello, WIRE_VERSION);
+    wire_version = -1;
+    predict_init(&predictor);
+    if (write(sock, hello, sizeof(hello)) != (ssize_t)sizeof(hello)) {
+        close(sock);
+        sock = -1;
+        return;
+    }
+
     pthread_create(&rcv_thread, NULL, recv_msg, (void *)&sock);
 
     while (1) {
@@ -237,7 +262,24 @@ void run_multiplayer_mode() {
 
         if (valid_input) {
             if(sock != -1) {
-                write(sock, &req, sizeof(req));
+                // 버전 4부터는 이동을 바로 내 보드에 적용해서 그리고, 번호를 붙여 보냄 (버전 5는 번호 없이 순서로 맞춤)
+                int seq = -1;
+                S2C_Packet view;
+                pthread_mutex_lock(&draw_mutex);
+                int version = wire_version;
+                if (version >= 4 && req.action != QUIT) {
+                    seq = predict_input(&predictor, (Direction)req.action);
+                    if (predict_view(&predictor, &view)) draw_game(&view, 0);
+                }
+                pthread_mutex_unlock(&draw_mutex);
+
+                if (version > 0) {
+                    uint8_t buf[WIRE_MAX_REQUEST];
+                    size_t len = wire_encode_request(buf, version, wire_encode_action(req.action), seq);
+                    write(sock, buf, len);
+                } else if (version == 0 || req.action == QUIT) {
+                    write(sock, &req, sizeof(req));
+                }
                 if(req.action == QUIT) {
                     // 서버에 종료 알리고 루프 탈출
                     pthread_cancel(rcv_thread);pthread_join(rcv_thread, NULL);
@@ -250,42 +292,155 @@ void run_multiplayer_mode() {
     }
 }
 
-int recv_all(int sock, void *buffer, size_t len) {
-    size_t received = 0;
-    char *ptr = (char *)buffer;
-    while (received < len) {
-        int ret = read(sock, ptr + received, len - received);
-        if (ret <= 0) return ret;
-        received += ret;
+// 받아 둔 바이트에서 완성된 패킷을 모두 꺼내 디코딩 (델타는 차례로 적용해야 하므로 전부 디코딩하고, 화면은 마지막 것만)
+// 완성된 패킷이 있으면 1 (packet = 마지막 상태), 없으면 0, 잘못된 패킷이면 -1
+// 델타를 적용할 수 없으면 그 패킷은 건너뛰고 키프레임을 요청
+static int recv_packets(RecvBuf *rb, int version, WireStream *rx, S2C_Packet *packet) {
+    int got = 0;
+    bool requested = false;
+
+    if (version == 0) {
+        while (rb->len >= sizeof(*packet)) {
+            recv_buf_peek(rb, packet, sizeof(*packet));
+            recv_buf_consume(rb, sizeof(*packet));
+            got = 1;
+        }
+        return got;
     }
-    return received;
+
+    uint8_t buf[WIRE_MAX_PACKET];
+    size_t avail;
+    while ((avail = recv_buf_peek(rb, buf, sizeof(buf))) > 0) {
+        if (buf[0] + 1 > WIRE_MAX_PACKET) return -1;
+        if (avail < (size_t)buf[0] + 1) break;
+
+        int ret = (version == 1) ? wire_decode_packet(buf, avail, packet)
+                                 : wire_decode_stream(rx, buf, avail, packet);
+        if (ret > 0) {
+            recv_buf_consume(rb, (size_t)ret);
+            got = 1;
+            continue;
+        }
+        if (version == 1) return -1;
+
+        recv_buf_consume(rb, (size_t)buf[0] + 1);
+        if (!requested) {
+            uint8_t req[WIRE_MAX_REQUEST];
+            size_t len = wire_encode_request(req, version, WIRE_KEYFRAME_REQUEST, -1);
+            if (write(sock, req, len) != (ssize_t)len) return -1;
+            requested = true;
+        }
+    }
+    return got;
 }
 
-void *recv_msg(void *arg) {
-    (void)arg;
+// 버전 5: 받아 둔 사건을 모두 차례로 적용 (화면은 마지막에 한 번)
+// 적용한 사건이 있으면 1, 없으면 0, 잘못된 사건이면 -1
+// 내 이동 요청이 처리될 때마다 acked를 하나씩 늘리고, 그 사이에 공격받았으면 hit
+// 상태를 놓쳐서 적용할 수 없는 사건이 오면 양쪽 게임 상태를 다시 요청
+static int recv_events(RecvBuf *rb, int version, Lockstep *ls, unsigned *acked, bool *hit) {
+    int got = 0;
+    bool requested = false;
+    uint8_t buf[WIRE_MAX_LOCK];
+    size_t avail;
+    while ((avail = recv_buf_peek(rb, buf, sizeof(buf))) > 0) {
+        LockEvent ev;
+        int ret = wire_decode_lock(buf, avail, &ev);
+        if (ret < 0) return -1;
+        if (ret == 0) break;
+        recv_buf_consume(rb, (size_t)ret);
+        got = 1;
+
+        if (lockstep_acks_input(&ev)) (*acked)++;
+        if (lockstep_apply(ls, &ev) < 0 && !requested) {
+            uint8_t req[WIRE_MAX_REQUEST];
+            size_t len = wire_encode_request(req, version, WIRE_KEYFRAME_REQUEST, -1);
+            if (write(sock, req, len) != (ssize_t)len) return -1;
+            requested = true;
+        }
+        *hit |= ls->hit;
+    }
+    return got;
+}
+
+// q로 나갈 때 수신 스레드는 취소되므로 버퍼는 취소 정리 함수로 해제
+static void free_recv_buf(void *arg) {
+    recv_buf_free(arg);
+}
+
+// 온 만큼 한 번에 받아서 완성된 패킷을 모두 처리 (서버가 끊거나 잘못된 패킷이 오면 돌아옴)
+static void recv_loop(RecvBuf *rb) {
     S2C_Packet packet;
-    int str_len;
+    WireStream rx;
+    Lockstep ls;
+    unsigned acked = 0; // 버전 5: 서버가 처리한 내 이동 요청 수
+    int version = -1;
+    wire_stream_init(&rx);
+    lockstep_init(&ls);
+
+    while (recv_buf_fill(rb, sock) > 0) {
+        // 첫 4바이트가 hello면 압축 형식, 아니면 예전 서버가 보낸 첫 패킷의 앞부분
+        if (version < 0) {
+            uint8_t first[WIRE_HELLO_SIZE];
+            if (recv_buf_peek(rb, first, sizeof(first)) < sizeof(first)) continue;
+            version = wire_parse_hello(first);
+            if (version >= 1) recv_buf_consume(rb, sizeof(first));
+            else version = 0;
 
-    while (1) {
-        str_len = recv_all(sock, &packet, sizeof(packet));
-        
-        if (str_len <= 0) {
-            // 서버 끊김 처리
             pthread_mutex_lock(&draw_mutex);
-            clear();
-            mvprintw(10, 20, "Server disconnected! Press 'q' to exit...");
-            refresh();
+            wire_version = version;
             pthread_mutex_unlock(&draw_mutex);
-            
-            // 메인 루프 종료를 유도하거나 여기서 대기
-            close(sock);
-            sock = -1;
-            break;
         }
+
+        int ack;
+        if (version >= WIRE_LOCKSTEP_VERSION) {
+            // 양쪽 게임을 직접 진행하고, 그 상태를 서버 상태로 보고 예측을 맞춤
+            // (n번째로 처리된 요청의 입력 번호가 n - 1)
+            bool hit = false;
+            int ret = recv_events(rb, version, &ls, &acked, &hit);
+            if (ret < 0) break;
+            if (ret == 0) continue;
+            lockstep_packet(&ls, &packet);
+            packet.is_hit = hit;
+            ack = acked > 0 ? (int)((acked - 1) & 0xFFFF) : -1;
+        } else {
+            int ret = recv_packets(rb, version, &rx, &packet);
+            if (ret < 0) break;
+            if (ret == 0) continue;
+            ack = rx.ack;
+        }
+
+        // 버전 4부터는 서버가 처리한 입력까지 버리고, 남은 입력을 서버 상태 위에 다시 적용해서 그림
         pthread_mutex_lock(&draw_mutex);
+        if (version >= 4) {
+            predict_server_state(&predictor, &packet, ack);
+            predict_view(&predictor, &packet);
+        }
         draw_game(&packet, 0);
         pthread_mutex_unlock(&draw_mutex);
     }
+}
+
+void *recv_msg(void *arg) {
+    (void)arg;
+    RecvBuf rb;
+
+    if (recv_buf_init(&rb, RECV_BUF_SIZE) == 0) {
+        pthread_cleanup_push(free_recv_buf, &rb);
+        recv_loop(&rb);
+        pthread_cleanup_pop(1);
+    }
+
+    // 서버 끊김 처리
+    pthread_mutex_lock(&draw_mutex);
+    clear();
+    mvprintw(10, 20, "Server disconnected! Press 'q' to exit...");
+    refresh();
+    pthread_mutex_unlock(&draw_mutex);
+
+    // 메인 루프 종료를 유도하거나 여기서 대기
+    close(sock);
+    sock = -1;
     return NULL;
 }
 
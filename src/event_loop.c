@@ -0,0 +1,204 @@
+#define _DEFAULT_SOURCE
+#include "event_loop.h"
+#include <stdlib.h>      // calloc(), free()
+#include <stddef.h>      // offsetof()
+#include <unistd.h>      // read(), write(), close()
+#include <time.h>        // clock_gettime()
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#define MAX_EVENTS 64    // epoll_wait 한 번에 받는 이벤트 수
+
+// 다른 스레드가 넘긴 일 (단일 연결 리스트)
+typedef struct PostItem {
+    PostFn fn;
+    void *arg;
+    struct PostItem *next;
+} PostItem;
+
+struct EventLoop {
+    int id;
+    int epfd;
+    pthread_t tid;
+
+    // 타이머 휠 (tick 0 = start_ns), 루프 스레드만 접근
+    uint64_t start_ns;
+    TimerWheel wheel;
+
+    // 처리 중인 epoll_wait 결과 (콜백이 같은 묶음의 다른 연결을 닫으면 그 이벤트를 지움)
+    struct epoll_event events[MAX_EVENTS];
+    int event_count, event_next;
+
+    // loop_post 대기열, eventfd로 루프를 깨움
+    Watcher wake;
+    pthread_mutex_t post_lock;
+    PostItem *post_head, *post_tail;
+};
+
+uint64_t loop_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// ==========================================
+// [1] 타이머 (1ms tick 타이머 휠)
+// ==========================================
+
+#define NS_PER_TICK 1000000ULL
+
+// 루프 시작부터 지난 tick (내림)
+static uint64_t current_tick(const EventLoop *loop) {
+    return (loop_now_ns() - loop->start_ns) / NS_PER_TICK;
+}
+
+void timer_init(Timer *t, TimerFn fn) {
+    wheel_timer_init(&t->node);
+    t->fn = fn;
+}
+
+bool timer_active(const Timer *t) {
+    return wheel_timer_active(&t->node);
+}
+
+void loop_timer_start(EventLoop *loop, Timer *t, uint64_t delay_ms) {
+    // 만료 tick은 올림 (tick이 바뀌는 순간이 아니라 tick 중간에 걸어도 delay_ms를 채움)
+    uint64_t elapsed = loop_now_ns() - loop->start_ns + delay_ms * NS_PER_TICK;
+    wheel_add(&loop->wheel, &t->node, (elapsed + NS_PER_TICK - 1) / NS_PER_TICK);
+}
+
+void loop_timer_stop(EventLoop *loop, Timer *t) {
+    wheel_del(&loop->wheel, &t->node);
+}
+
+// 만료된 타이머 실행 (콜백이 다시 걸면 다음 tick 이후에 처리)
+static void run_timers(EventLoop *loop) {
+    uint64_t now = current_tick(loop);
+    WheelTimer *node;
+    while ((node = wheel_expire(&loop->wheel, now)) != NULL) {
+        Timer *t = (Timer *)((char *)node - offsetof(Timer, node));
+        t->fn(loop, t);
+    }
+}
+
+// 휠이 다음에 일할 tick까지 남은 시간 (ms, 올림), 걸린 타이머가 없으면 -1 (무한 대기)
+static int next_timeout(EventLoop *loop) {
+    uint64_t tick;
+    if (!wheel_next(&loop->wheel, &tick)) return -1;
+    uint64_t deadline = loop->start_ns + tick * NS_PER_TICK;
+    uint64_t now = loop_now_ns();
+    if (deadline <= now) return 0;
+    return (int)((deadline - now + NS_PER_TICK - 1) / NS_PER_TICK);
+}
+
+// ==========================================
+// [2] 다른 스레드에서 넘어온 일
+// ==========================================
+
+int loop_post(EventLoop *loop, PostFn fn, void *arg) {
+    PostItem *item = malloc(sizeof(PostItem));
+    if (!item) return -1;
+    item->fn = fn;
+    item->arg = arg;
+    item->next = NULL;
+
+    pthread_mutex_lock(&loop->post_lock);
+    if (loop->post_tail) loop->post_tail->next = item;
+    else loop->post_head = item;
+    loop->post_tail = item;
+    pthread_mutex_unlock(&loop->post_lock);
+
+    uint64_t one = 1;
+    (void)!write(loop->wake.fd, &one, sizeof(one));
+    return 0;
+}
+
+static void on_wake(EventLoop *loop, Watcher *w, uint32_t events) {
+    (void)events;
+    uint64_t count;
+    (void)!read(w->fd, &count, sizeof(count));
+
+    // 한 번에 떼어 와서 잠금 밖에서 실행
+    pthread_mutex_lock(&loop->post_lock);
+    PostItem *item = loop->post_head;
+    loop->post_head = loop->post_tail = NULL;
+    pthread_mutex_unlock(&loop->post_lock);
+
+    while (item) {
+        PostItem *next = item->next;
+        item->fn(loop, item->arg);
+        free(item);
+        item = next;
+    }
+}
+
+// ==========================================
+// [3] 루프 본체 및 공개 함수
+// ==========================================
+
+static void *loop_main(void *arg) {
+    EventLoop *loop = arg;
+
+    for (;;) {
+        int n = epoll_wait(loop->epfd, loop->events, MAX_EVENTS, next_timeout(loop));
+        loop->event_count = n > 0 ? n : 0;
+        for (loop->event_next = 0; loop->event_next < loop->event_count; ) {
+            struct epoll_event *ev = &loop->events[loop->event_next++];
+            Watcher *w = ev->data.ptr;
+            if (w) w->fn(loop, w, ev->events);
+        }
+        loop->event_count = 0;
+        run_timers(loop);
+    }
+    return NULL;
+}
+
+EventLoop *loop_create(int id) {
+    EventLoop *loop = calloc(1, sizeof(EventLoop));
+    if (!loop) return NULL;
+    loop->id = id;
+    loop->start_ns = loop_now_ns();
+    wheel_init(&loop->wheel, 0);
+    loop->epfd = epoll_create1(EPOLL_CLOEXEC);
+    loop->wake.fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    loop->wake.fn = on_wake;
+    pthread_mutex_init(&loop->post_lock, NULL);
+
+    if (loop->epfd < 0 || loop->wake.fd < 0 || loop_add(loop, &loop->wake, EPOLLIN) < 0) {
+        if (loop->epfd >= 0) close(loop->epfd);
+        if (loop->wake.fd >= 0) close(loop->wake.fd);
+        pthread_mutex_destroy(&loop->post_lock);
+        free(loop);
+        return NULL;
+    }
+    return loop;
+}
+
+int loop_start(EventLoop *loop) {
+    if (pthread_create(&loop->tid, NULL, loop_main, loop) != 0) return -1;
+    pthread_detach(loop->tid);
+    return 0;
+}
+
+int loop_id(const EventLoop *loop) {
+    return loop->id;
+}
+
+int loop_add(EventLoop *loop, Watcher *w, uint32_t events) {
+    struct epoll_event ev = { .events = events, .data.ptr = w };
+    return epoll_ctl(loop->epfd, EPOLL_CTL_ADD, w->fd, &ev);
+}
+
+int loop_mod(EventLoop *loop, Watcher *w, uint32_t events) {
+    struct epoll_event ev = { .events = events, .data.ptr = w };
+    return epoll_ctl(loop->epfd, EPOLL_CTL_MOD, w->fd, &ev);
+}
+
+void loop_del(EventLoop *loop, Watcher *w) {
+    epoll_ctl(loop->epfd, EPOLL_CTL_DEL, w->fd, NULL);
+    // 이미 받아 둔 이벤트 중 아직 처리하지 않은 것은 버림 (호출한 쪽이 곧 w를 해제할 수 있음)
+    for (int i = loop->event_next; i < loop->event_count; i++) {
+        if (loop->events[i].data.ptr == w) loop->events[i].data.ptr = NULL;
+    }
+}
@@ -0,0 +1,282 @@
+#include "game_batch.h"
+#include "bitboard_simd.h" // BB_HAVE_X86_KERNELS
+#include <stdlib.h> // calloc(), free()
+#include <string.h> // memset()
+
+#if defined(BB_HAVE_X86_KERNELS)
+#include <immintrin.h>
+#endif
+
+// 한 번에 처리하는 게임 수 (임시 배열을 스택에 두기 위한 크기)
+#define BATCH_CHUNK 256
+
+// 방향 배열을 32비트 정수 4개씩 읽어서 벡터로 처리함
+_Static_assert(sizeof(Direction) == sizeof(int), "Direction must be int-sized");
+
+// ==========================================
+// [1] 스칼라 커널 (모든 CPU)
+// ==========================================
+
+static void move_chunk_scalar(const Board *before, const Direction *dirs, int n,
+                              Board *after, int *delta) {
+    for (int i = 0; i < n; i++) {
+        after[i] = bb_move(before[i], dirs[i], &delta[i]);
+    }
+}
+
+static void over_chunk_scalar(const Board *boards, int n, uint8_t *over) {
+    for (int i = 0; i < n; i++) {
+        over[i] = bb_is_over(boards[i]);
+    }
+}
+
+// ==========================================
+// [2] AVX2 커널 (게임 4개씩)
+// ==========================================
+#if defined(BB_HAVE_X86_KERNELS)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+// 64비트 레인마다 bb_transpose
+static inline __m256i transpose4(__m256i x) {
+    __m256i a1 = _mm256_and_si256(x, _mm256_set1_epi64x((long long)0xF0F00F0FF0F00F0FULL));
+    __m256i a2 = _mm256_and_si256(x, _mm256_set1_epi64x((long long)0x0000F0F00000F0F0ULL));
+    __m256i a3 = _mm256_and_si256(x, _mm256_set1_epi64x((long long)0x0F0F00000F0F0000ULL));
+    __m256i a = _mm256_or_si256(a1, _mm256_or_si256(_mm256_slli_epi64(a2, 12), _mm256_srli_epi64(a3, 12)));
+    __m256i b1 = _mm256_and_si256(a, _mm256_set1_epi64x((long long)0xFF00FF0000FF00FFULL));
+    __m256i b2 = _mm256_and_si256(a, _mm256_set1_epi64x((long long)0x00FF00FF00000000ULL));
+    __m256i b3 = _mm256_and_si256(a, _mm256_set1_epi64x((long long)0x00000000FF00FF00ULL));
+    return _mm256_or_si256(b1, _mm256_or_si256(_mm256_srli_epi64(b2, 24), _mm256_slli_epi64(b3, 24)));
+}
+
+// 16비트 행마다 니블 순서 뒤집기 (바이트 안 니블 교환 -> 행 안 바이트 교환)
+static inline __m256i reverse_rows4(__m256i x) {
+    const __m256i n_mask = _mm256_set1_epi8(0x0F);
+    __m256i y = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(x, n_mask), 4),
+                                _mm256_and_si256(_mm256_srli_epi16(x, 4), n_mask));
+    return _mm256_or_si256(_mm256_slli_epi16(y, 8), _mm256_srli_epi16(y, 8));
+}
+
+// 값이 0인 니블이 있는 레인은 0이 아닌 값
+static inline __m256i zero_nibbles4(__m256i x) {
+    __m256i t = _mm256_sub_epi64(x, _mm256_set1_epi64x(0x1111111111111111LL));
+    return _mm256_and_si256(_mm256_andnot_si256(x, t),
+                            _mm256_set1_epi64x((long long)0x8888888888888888ULL));
+}
+
+static void move_chunk_avx2(const Board *before, const Direction *dirs, int n,
+                            Board *after, int *delta) {
+    const int *table = (const int *)bb_rows; // BbRow = {left|right<<16, score|flags}
+    const __m256i row_mask = _mm256_set1_epi32(0xFFFF);
+    const __m256i score_mask = _mm256_set1_epi32(0x3FFFFFFF);
+    const __m256i game_order = _mm256_setr_epi32(0, 4, 1, 5, 0, 4, 1, 5);
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i b = _mm256_loadu_si256((const __m256i *)&before[i]);
+        __m256i dir = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)&dirs[i]));
+
+        // UP/DOWN은 전치, RIGHT/DOWN은 행 뒤집기로 모두 LEFT 이동으로 바꿈
+        __m256i is_up = _mm256_cmpeq_epi64(dir, _mm256_set1_epi64x(UP));
+        __m256i is_down = _mm256_cmpeq_epi64(dir, _mm256_set1_epi64x(DOWN));
+        __m256i is_right = _mm256_cmpeq_epi64(dir, _mm256_set1_epi64x(RIGHT));
+        __m256i need_t = _mm256_or_si256(is_up, is_down);
+        __m256i need_r = _mm256_or_si256(is_right, is_down);
+
+        __m256i x = _mm256_blendv_epi8(b, transpose4(b), need_t);
+        x = _mm256_blendv_epi8(x, reverse_rows4(x), need_r);
+
+        // 16개 행(게임 4개 x 4행)을 테이블에서 gather
+        __m256i idx_lo = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(x));      // 게임 0, 1
+        __m256i idx_hi = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(x, 1)); // 게임 2, 3
+        __m256i rows_lo = _mm256_and_si256(_mm256_i32gather_epi32(table, idx_lo, 8), row_mask);
+        __m256i rows_hi = _mm256_and_si256(_mm256_i32gather_epi32(table, idx_hi, 8), row_mask);
+        __m256i sc_lo = _mm256_and_si256(_mm256_i32gather_epi32(table + 1, idx_lo, 8), score_mask);
+        __m256i sc_hi = _mm256_and_si256(_mm256_i32gather_epi32(table + 1, idx_hi, 8), score_mask);
+
+        // 16비트로 다시 묶으면 레인 순서가 (0, 2, 1, 3)이 되므로 되돌림
+        __m256i o = _mm256_permute4x64_epi64(_mm256_packus_epi32(rows_lo, rows_hi), 0xD8);
+
+        // 원래 방향으로 되돌림 (역순: 행 뒤집기 -> 전치)
+        o = _mm256_blendv_epi8(o, reverse_rows4(o), need_r);
+        o = _mm256_blendv_epi8(o, transpose4(o), need_t);
+        _mm256_storeu_si256((__m256i *)&after[i], o);
+
+        // 행 4개 점수 합: hadd 두 번 후 게임 순서로 정렬
+        __m256i s = _mm256_hadd_epi32(sc_lo, sc_hi);
+        s = _mm256_permutevar8x32_epi32(_mm256_hadd_epi32(s, s), game_order);
+        _mm_storeu_si128((__m128i *)&delta[i], _mm256_castsi256_si128(s));
+    }
+
+    move_chunk_scalar(before + i, dirs + i, n - i, after + i, delta + i);
+}
+
+static void over_chunk_avx2(const Board *boards, int n, uint8_t *over) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i b = _mm256_loadu_si256((const __m256i *)&boards[i]);
+
+        // 빈칸, 가로로 같은 이웃, 세로로 같은 이웃 중 하나라도 있으면 게임 진행 가능
+        __m256i horiz = _mm256_or_si256(_mm256_xor_si256(b, _mm256_srli_epi64(b, 4)),
+                                        _mm256_set1_epi64x((long long)0xF000F000F000F000ULL));
+        __m256i vert = _mm256_or_si256(_mm256_xor_si256(b, _mm256_srli_epi64(b, 16)),
+                                       _mm256_set1_epi64x((long long)0xFFFF000000000000ULL));
+        __m256i any = _mm256_or_si256(zero_nibbles4(b),
+                                      _mm256_or_si256(zero_nibbles4(horiz), zero_nibbles4(vert)));
+
+        int done = _mm256_movemask_pd(_mm256_castsi256_pd(
+            _mm256_cmpeq_epi64(any, _mm256_setzero_si256())));
+        for (int k = 0; k < 4; k++) {
+            over[i + k] = (done >> k) & 1;
+        }
+    }
+
+    over_chunk_scalar(boards + i, n - i, over + i);
+}
+
+#pragma GCC pop_options
+#endif // BB_HAVE_X86_KERNELS
+
+// ==========================================
+// [3] 공개 함수 구현
+// ==========================================
+
+int game_batch_init(GameBatch *batch, int count, uint64_t seed) {
+    memset(batch, 0, sizeof(GameBatch));
+    bb_init();
+
+    batch->count = count;
+    batch->boards = calloc(count, sizeof(Board));
+    batch->scores = calloc(count, sizeof(int));
+    batch->game_over = calloc(count, sizeof(uint8_t));
+    batch->rngs = calloc(count, sizeof(Rng));
+    batch->attack_cnt = calloc(count, sizeof(uint8_t));
+    batch->attack_queue = calloc((size_t)count * MAX_ATTACK_QUEUE, sizeof(uint8_t));
+
+    if (!batch->boards || !batch->scores || !batch->game_over || !batch->rngs ||
+        !batch->attack_cnt || !batch->attack_queue) {
+        game_batch_free(batch);
+        return -1;
+    }
+
+    // game_init과 같이 시작 타일 두 개
+    for (int i = 0; i < count; i++) {
+        rng_seed(&batch->rngs[i], seed, (uint64_t)i);
+        batch->boards[i] = bb_spawn(bb_spawn(0, &batch->rngs[i]), &batch->rngs[i]);
+    }
+    return 0;
+}
+
+void game_batch_free(GameBatch *batch) {
+    free(batch->boards);
+    free(batch->scores);
+    free(batch->game_over);
+    free(batch->rngs);
+    free(batch->attack_cnt);
+    free(batch->attack_queue);
+    memset(batch, 0, sizeof(GameBatch));
+}
+
+void game_batch_step(GameBatch *batch, const Direction *dirs,
+                     int *score_delta, uint8_t *moved, uint8_t *over) {
+    Board after[BATCH_CHUNK];
+    int delta[BATCH_CHUNK];
+    uint8_t now_over[BATCH_CHUNK];
+
+#if defined(BB_HAVE_X86_KERNELS)
+    bool use_avx2 = (bb_get_kernel() == BB_KERNEL_AVX2);
+#endif
+
+    for (int base = 0; base < batch->count; base += BATCH_CHUNK) {
+        int n = batch->count - base;
+        if (n > BATCH_CHUNK) n = BATCH_CHUNK;
+
+        Board *boards = batch->boards + base;
+
+        // 1. 이동 (벡터)
+#if defined(BB_HAVE_X86_KERNELS)
+        if (use_avx2) move_chunk_avx2(boards, dirs + base, n, after, delta);
+        else
+#endif
+        move_chunk_scalar(boards, dirs + base, n, after, delta);
+
+        // 2. 타일 생성, 공격 실행 (게임마다 자기 난수 생성기를 쓰므로 스칼라)
+        for (int k = 0; k < n; k++) {
+            int i = base + k;
+            bool game_moved = false;
+
+            if (batch->game_over[i]) {
+                delta[k] = 0;
+            } else {
+                game_moved = (after[k] != boards[k]);
+                Board b = game_moved ? bb_spawn(after[k], &batch->rngs[i]) : after[k];
+
+                if (batch->attack_cnt[i] > 0) {
+                    uint8_t *queue = &batch->attack_queue[(size_t)i * MAX_ATTACK_QUEUE];
+                    int pos;
+                    b = bb_place_attack(b, queue[0], &pos, &batch->rngs[i]);
+                    // 놓을 곳이 없으면 대기열 유지
+                    if (pos >= 0) {
+                        memmove(queue, queue + 1, MAX_ATTACK_QUEUE - 1);
+                        queue[--batch->attack_cnt[i]] = 0;
+                    }
+                }
+
+                boards[k] = b;
+                batch->scores[i] += delta[k];
+            }
+
+            if (score_delta) score_delta[i] = delta[k];
+            if (moved) moved[i] = game_moved;
+        }
+
+        // 3. 게임 오버 판정 (벡터)
+#if defined(BB_HAVE_X86_KERNELS)
+        if (use_avx2) over_chunk_avx2(boards, n, now_over);
+        else
+#endif
+        over_chunk_scalar(boards, n, now_over);
+
+        for (int k = 0; k < n; k++) {
+            int i = base + k;
+            batch->game_over[i] |= now_over[k];
+            if (over) over[i] = batch->game_over[i];
+        }
+    }
+}
+
+void game_batch_queue_attack(GameBatch *batch, int idx, int value) {
+    if (batch->attack_cnt[idx] < MAX_ATTACK_QUEUE) {
+        int exp = (value == 4) ? 2 : 1;
+        batch->attack_queue[(size_t)idx * MAX_ATTACK_QUEUE + batch->attack_cnt[idx]++] = (uint8_t)exp;
+    }
+}
+
+void game_batch_get(const GameBatch *batch, int idx, GameState *state) {
+    memset(state, 0, sizeof(GameState));
+
+    bb_to_array(batch->boards[idx], state->board);
+    state->score = batch->scores[idx];
+    state->game_over = batch->game_over[idx];
+    state->attack_cnt = batch->attack_cnt[idx];
+    for (int k = 0; k < state->attack_cnt; k++) {
+        state->attack_queue[k] = 1 << batch->attack_queue[(size_t)idx * MAX_ATTACK_QUEUE + k];
+    }
+    state->highlight_r = -1;
+    state->highlight_c = -1;
+    state->rng = batch->rngs[idx];
+}
+
+void game_batch_set(GameBatch *batch, int idx, const GameState *state) {
+    batch->boards[idx] = bb_from_array(state->board);
+    batch->scores[idx] = state->score;
+    batch->game_over[idx] = state->game_over;
+    batch->rngs[idx] = state->rng;
+    batch->attack_cnt[idx] = (uint8_t)state->attack_cnt;
+
+    uint8_t *queue = &batch->attack_queue[(size_t)idx * MAX_ATTACK_QUEUE];
+    memset(queue, 0, MAX_ATTACK_QUEUE);
+    for (int k = 0; k < state->attack_cnt; k++) {
+        queue[k] = (uint8_t)__builtin_ctz((unsigned)state->attack_queue[k]);
+    }
+}
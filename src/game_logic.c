@@ -1,69 +1,38 @@
 #include "game.h"
-#include <stdlib.h> // rand(), srand()
-#include <string.h> // memset(), memcpy()
-#include <time.h>   // time()
+#include "bitboard.h"
+#include <string.h> // memset()
 
 // ==========================================
 // [1] 내부 헬퍼 함수 (Internal Helper Functions)
 // ==========================================
 
 /**
- * @brief 4칸짜리 1차원 배열을 "왼쪽"으로 밀고 합치는 핵심 로직
- * @return 이번 줄에서 합쳐져서 획득한 점수
+ * @brief 값이 0이거나 value인 칸의 마스크 (칸 번호 4*r + c 비트), value = 0이면 빈칸만
+ * 분기 없이 16칸을 한 번씩만 확인
  */
-static int process_line(int *line) {
-    int score = 0;
-    int temp[4] = {0};
-    int temp_idx = 0;
-
-    // 0이 아닌 숫자들을 앞으로 당김
-    for (int i = 0; i < 4; i++) {
-        if (line[i] != 0) {
-            temp[temp_idx++] = line[i];
-        }
-    }
-
-    // 인접한 같은 숫자 합치기
-    for (int i = 0; i < temp_idx - 1; i++) {
-        if (temp[i] != 0 && temp[i] == temp[i+1]) {
-            temp[i] *= 2;      // 합체
-            score += temp[i];  // 점수 획득
-            temp[i+1] = 0;     // 뒷자리 비움
-            i++;               // 합쳐진 칸 건너뜀
-        }
-    }
-
-    // 합쳐진 후 생긴 빈 공간 정리
-    int final_idx = 0;
-    for (int i = 0; i < 4; i++) {
-        if (temp[i] != 0) {
-            line[final_idx++] = temp[i];
-        }
-    }
-    // 남은 뒷부분 0 채우기
-    while (final_idx < 4) {
-        line[final_idx++] = 0;
-    }
-    return score;
-}
-
-/**
- * @brief 빈 칸(0)이 하나라도 있는지 확인
- */
-static bool can_spawn(GameState *state) {
+static uint16_t cell_mask(GameState *state, int value) {
+    uint16_t mask = 0;
     for(int i=0; i<4; i++) {
         for(int j=0; j<4; j++) {
-            if (state->board[i][j] == 0) return true;
+            int v = state->board[i][j];
+            mask |= (uint16_t)((v == 0 || v == value) << (4 * i + j));
         }
     }
-    return false;
+    return mask;
 }
 
 // 공개 함수 구현
 void game_init(GameState *state) {
+    // 게임마다 운영체제 난수로 시드 (같은 초에 시작해도 수열이 겹치지 않음)
+    game_init_seeded(state, rng_entropy_seed(), 0);
+}
+
+void game_init_seeded(GameState *state, uint64_t seed, uint64_t stream) {
     memset(state, 0, sizeof(GameState));
-    
-    srand(time(NULL)); 
+
+    bb_init(); // 행 이동 테이블 준비 (이미 되어 있으면 바로 리턴)
+
+    rng_seed(&state->rng, seed, stream);
 
     game_spawn_tile(state);
     game_spawn_tile(state);
@@ -77,77 +46,40 @@ void game_init(GameState *state) {
 }
 
 void game_spawn_tile(GameState *state) {
-    if (!can_spawn(state)) return;
+    uint16_t empty = cell_mask(state, 0);
+    if (empty == 0) return;
     
     // 10% 확률로 4, 90% 확률로 2
-    int value = (rand() % 10 == 0) ? 4 : 2; 
+    int value = (rng_below(&state->rng, 10) == 0) ? 4 : 2; 
     
-    while(1) {
-        int r = rand() % 4;
-        int c = rand() % 4;
-        if (state->board[r][c] == 0) {
-            state->board[r][c] = value;
-            break;
-        }
-    }
+    // 빈칸 중 하나를 난수 한 번으로 고름 (꽉 찬 보드에서도 재시도 없음)
+    int cell = bb_pick_cell(empty, &state->rng);
+    state->board[cell / 4][cell % 4] = value;
 }
 
 int game_move(GameState *state, Direction dir) {
-    int total_score = 0;
-    int temp_line[4]; 
-    
-    // 이동 전 상태 백업
-    int old_board[4][4]; 
-    memcpy(old_board, state->board, sizeof(old_board));
-    
     // 하이라이트 리셋 (이동하면 사라짐)
     state->highlight_r = -1;
     state->highlight_c = -1;
-    
-    for (int i = 0; i < 4; i++) {
-        // 방향에 따라 한 줄 추출
-        for (int j = 0; j < 4; j++) {
-            switch(dir) {
-                case UP:    temp_line[j] = state->board[j][i];     break;
-                case DOWN:  temp_line[j] = state->board[3-j][i];   break;
-                case LEFT:  temp_line[j] = state->board[i][j];     break;
-                case RIGHT: temp_line[j] = state->board[i][3-j];   break;
-            }
-        }
-        
-        // 핵심 로직 실행
-        total_score += process_line(temp_line);
-        
-        // 다시 보드에 복사
-        for (int j = 0; j < 4; j++) {
-            switch(dir) {
-                case UP:    state->board[j][i]     = temp_line[j]; break;
-                case DOWN:  state->board[3-j][i]   = temp_line[j]; break;
-                case LEFT:  state->board[i][j]     = temp_line[j]; break;
-                case RIGHT: state->board[i][3-j]   = temp_line[j]; break;
-            }
-        }
-    }
 
-    // 이동 여부 확인
-    state->moved = false;
-    for (int i = 0; i < 4; i++) {
-        for (int j = 0; j < 4; j++) {
-            if (old_board[i][j] != state->board[i][j]) {
-                state->moved = true;
-                goto check_end; // 2중 루프 탈출
-            }
-        }
+    // 비트보드로 변환해서 한 번에 이동 (보드 백업, 칸 단위 분기 없음)
+    Board before = bb_from_array(state->board);
+    int total_score = 0;
+    Board after = bb_move(before, dir, &total_score);
+
+    // 이동 여부 확인: 64비트 비교 한 번
+    state->moved = (after != before);
+    if (state->moved) {
+        bb_to_array(after, state->board);
     }
-check_end:
-    
+
     state->score += total_score;
     return total_score;
 }
 
 // 공격 예약
 void game_queue_attack(GameState *state, int value) {
-    if (state->attack_cnt < 10) {
+    if (state->attack_cnt < MAX_ATTACK_QUEUE) {
         state->attack_queue[state->attack_cnt++] = value;
     }
 }
@@ -166,23 +98,10 @@ void game_execute_attack(GameState *state) {
 
     // 공격 가능한 위치 찾기
     // 조건: 빈칸(0) 이거나, 공격 값과 같은 숫자인 곳
-    typedef struct { int r; int c; } Pos;
-    Pos targets[16];
-    int target_cnt = 0;
-
-    for(int i=0; i<4; i++) {
-        for(int j=0; j<4; j++) {
-            
-            if (state->board[i][j] == 0 || state->board[i][j] == attack_value) {
-                targets[target_cnt].r = i;
-                targets[target_cnt].c = j;
-                target_cnt++;
-            }
-        }
-    }
+    uint16_t targets = cell_mask(state, attack_value);
 
     // 공격할 공간이 전혀 없으면 리턴 (공격 큐 유지)
-    if (target_cnt == 0) return;
+    if (targets == 0) return;
 
     // 이제 실제로 큐에서 꺼내기
     for (int i = 0; i < state->attack_cnt - 1; i++) {
@@ -192,9 +111,9 @@ void game_execute_attack(GameState *state) {
     state->attack_queue[state->attack_cnt] = 0;
 
     // 랜덤 위치에 공격 적용
-    int idx = rand() % target_cnt;
-    int r = targets[idx].r;
-    int c = targets[idx].c;
+    int cell = bb_pick_cell(targets, &state->rng);
+    int r = cell / 4;
+    int c = cell % 4;
 
     if (state->board[r][c] == 0) {
         state->board[r][c] = attack_value; // 빈칸에 생성
@@ -207,14 +126,38 @@ void game_execute_attack(GameState *state) {
     state->highlight_c = c;
 }
 
+int game_send_attack(GameState *attacker, GameState *target, int score_gained) {
+    if (score_gained < ATTACK_THRESHOLD) return 0;
+
+    int attack_count = score_gained / ATTACK_THRESHOLD;
+    if (attack_count > MAX_ATTACK_PER_MOVE) attack_count = MAX_ATTACK_PER_MOVE;
+    for (int i = 0; i < attack_count; i++) {
+        int attack_value = (rng_below(&attacker->rng, 10) == 0) ? 4 : 2;
+        game_queue_attack(target, attack_value);
+    }
+    return attack_count;
+}
+
+int game_play_move(GameState *me, GameState *opp, Direction dir) {
+    int score_gained = game_move(me, dir);
+    if (me->moved) {
+        game_spawn_tile(me);
+    }
+    game_execute_attack(me);
+    game_is_over(me);
+    return game_send_attack(me, opp, score_gained);
+}
+
 bool game_is_over(GameState *state) {
     // 빈 칸이 있으면 false
-    if (can_spawn(state)) return false;
+    if (cell_mask(state, 0) != 0) return false;
     
     // 인접한 같은 숫자 있으면 false
     for (int i = 0; i < 4; i++) {
         for (int j = 0; j < 4; j++) {
             int current = state->board[i][j];
+            // 가장 큰 타일끼리는 합쳐지지 않으므로 이웃해도 움직일 수 없음
+            if (current == MAX_TILE) continue;
             // 오른쪽 확인
             if (j < 3 && current == state->board[i][j+1]) return false;
             // 아래쪽 확인
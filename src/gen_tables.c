@@ -0,0 +1,17 @@
+// 행 이동 테이블을 C 초기화 목록으로 출력하는 빌드 도구
+// make BB_STATIC_TABLES=1 빌드에서 obj/bb_tables.inc 를 만들 때 사용
+// (실행 시점 bb_init()과 같은 코드로 만든 테이블을 그대로 덤프)
+#include <stdio.h>
+#include "bitboard.h"
+
+int main(void) {
+    bb_init();
+
+    printf("// gen_tables가 생성한 파일, 직접 수정하지 말 것\n");
+    for (int row = 0; row < BB_ROW_COUNT; row++) {
+        const BbRow *e = &bb_rows[row];
+        printf("{0x%04x,0x%04x,%u,%u,%u},\n", e->left, e->right,
+               (unsigned)e->score, (unsigned)e->moved_left, (unsigned)e->moved_right);
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "hist.h"
+
+// 칸에 들어가는 가장 큰 값
+static uint64_t bucket_high(int idx) {
+    if (idx < HIST_SUB) return (uint64_t)idx;
+    int k = idx - HIST_SUB;
+    int shift = k / HIST_HALF + 1;
+    uint64_t top = (uint64_t)(k % HIST_HALF + HIST_HALF);
+    return ((top + 1) << shift) - 1;
+}
+
+void hist_reset(Hist *h) {
+    for (int i = 0; i < HIST_BUCKETS; i++) atomic_store_explicit(&h->counts[i], 0, memory_order_relaxed);
+    atomic_store_explicit(&h->total, 0, memory_order_relaxed);
+    atomic_store_explicit(&h->sum, 0, memory_order_relaxed);
+    atomic_store_explicit(&h->max, 0, memory_order_relaxed);
+}
+
+void hist_merge(Hist *dst, const Hist *src) {
+    // total은 칸을 더한 값으로 (기록 중인 src를 읽으면 칸과 total이 조금 어긋날 수 있음)
+    uint64_t total = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        uint64_t n = atomic_load_explicit(&src->counts[i], memory_order_relaxed);
+        if (!n) continue;
+        total += n;
+        atomic_store_explicit(&dst->counts[i], atomic_load_explicit(&dst->counts[i], memory_order_relaxed) + n,
+                              memory_order_relaxed);
+    }
+    atomic_store_explicit(&dst->total, atomic_load_explicit(&dst->total, memory_order_relaxed) + total,
+                          memory_order_relaxed);
+    atomic_store_explicit(&dst->sum, atomic_load_explicit(&dst->sum, memory_order_relaxed) +
+                          atomic_load_explicit(&src->sum, memory_order_relaxed), memory_order_relaxed);
+    uint64_t max = atomic_load_explicit(&src->max, memory_order_relaxed);
+    if (max > atomic_load_explicit(&dst->max, memory_order_relaxed)) atomic_store_explicit(&dst->max, max, memory_order_relaxed);
+}
+
+uint64_t hist_count(const Hist *h) {
+    return atomic_load_explicit(&h->total, memory_order_relaxed);
+}
+
+uint64_t hist_percentile(const Hist *h, double p) {
+    uint64_t total = hist_count(h);
+    if (total == 0) return 0;
+    // p번째 값의 순위 (1부터), p = 0이면 가장 작은 값
+    uint64_t rank = (uint64_t)(p * (double)total + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > total) rank = total;
+
+    uint64_t max = atomic_load_explicit(&h->max, memory_order_relaxed);
+    uint64_t seen = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        seen += atomic_load_explicit(&h->counts[i], memory_order_relaxed);
+        if (seen >= rank) {
+            uint64_t high = bucket_high(i);
+            return high < max ? high : max;
+        }
+    }
+    return max;
+}
+
+double hist_mean(const Hist *h) {
+    uint64_t total = hist_count(h);
+    return total ? (double)atomic_load_explicit(&h->sum, memory_order_relaxed) / (double)total : 0.0;
+}
@@ -0,0 +1,489 @@
+// 헤드리스 부하 생성기: 실행 중인 서버에 연결 수천 개를 열고 연결마다 정해진 속도로 무작위(또는 스크립트) 이동을 보내면서
+// 클라이언트가 본 "이동 전송 -> 그 이동의 갱신 수신" 지연(p50/p99/p999), 처리량, 오류 수를 출력
+// 서버 용량 계획과 확장성 회귀 확인용 (room_bench는 방 수에 따른 지연, 이쪽은 연결 수와 입력 속도에 따른 부하)
+// 사용법: ./bin/loadgen [-h IP] [-p 포트] [-c 연결 수=1000] [-t 스레드 수] [-r 연결당 초당 이동=5] [-d 초=10]
+//                       [-s 이동 스크립트 (UDLR을 연결마다 다른 위치부터 반복)] [-v 버전]
+// 기본은 예전 구조체 형식 (C2S_Packet/S2C_Packet 그대로), -v N이면 압축 형식 버전 N
+// 연결은 접속 순서대로 두 개씩 같은 방에 앉으므로 서로가 상대 (연결 수가 홀수면 하나는 상대를 기다림)
+//
+// 갱신과 이동 짝 맞추기: 버전 4는 상태에 붙어 오는 입력 번호로, 버전 5는 내 이동/건너뜀 사건으로 정확히 맞추고,
+// 구조체 형식과 버전 3 이하는 보낸 뒤 처음 받은 갱신을 그 이동의 결과로 봄 (상대 이동의 갱신이 먼저 오면 짧게 잼)
+// 연결마다 답을 기다리는 이동은 하나뿐이고, 기다리는 동안 보낼 때가 되면 답이 오자마자 보내되
+// 지연은 원래 보내려던 시각부터 잼 (서버가 밀려서 덜 보내게 되어도 지연이 작게 나오지 않게)
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>         // clock_gettime()
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>       // offsetof()
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <netinet/tcp.h>  // TCP_NODELAY
+
+#include "protocol.h"
+#include "wire.h"
+#include "recv_buf.h"
+#include "timer_wheel.h"
+#include "rng.h"
+#include "hist.h"
+
+#define LOADGEN_RECV_BUF   512   // 연결마다 받아 두는 버퍼 (예전 구조체 패킷 2개)
+#define CONNECT_INFLIGHT   64    // 스레드마다 동시에 진행하는 접속 수 (서버의 accept 대기열을 넘치게 하지 않게)
+#define MOVE_TIMEOUT_NS    (5ULL * 1000000000ULL) // 이만큼 답이 없으면 시간 초과로 세고 다음 이동으로
+#define MAX_EVENTS         256
+
+typedef enum {
+    CONN_IDLE,          // 아직 접속하지 않음
+    CONN_CONNECTING,    // 논블로킹 connect 진행 중
+    CONN_HELLO,         // hello를 보내고 서버가 고른 버전을 기다림
+    CONN_READY,         // 방에 들어감 (상대가 있으면 이동을 보냄)
+    CONN_CLOSED
+} ConnState;
+
+typedef struct {
+    WheelTimer timer;   // 다음 이동을 보낼 시각
+    int fd;
+    ConnState state;
+    int version;        // 서버가 고른 압축 형식 버전, 구조체 형식이면 0
+    RecvBuf rx;
+    WireStream stream;  // 델타 기준 상태 (버전 2 이상)
+    bool playing;       // 상대가 있음 (없으면 서버가 이동을 처리하지 않음)
+    bool waiting;       // 보낸 이동의 답을 기다리는 중
+    bool due;           // 기다리는 동안 보낼 때가 됨 (답이 오면 바로 보냄)
+    uint64_t sent_ns;   // 기다리는 이동을 보내려던 시각 (지연은 여기서부터)
+    uint64_t due_ns;
+    int seq;            // 마지막으로 보낸 입력 번호 (버전 4)
+    int script_pos;
+} Conn;
+
+// 스레드 하나가 맡은 연결들 (epoll, 타이머 휠, 통계는 스레드마다 따로, main은 relaxed로 읽기만)
+typedef struct {
+    pthread_t tid;
+    Conn *conns;
+    int count;
+    int next_connect;   // 다음에 접속할 연결
+    int connecting;     // 진행 중인 접속 수
+    int epfd;
+    TimerWheel wheel;   // 1 tick = 1ms, start_ns부터
+    uint64_t start_ns;
+    Rng rng;
+
+    Hist lat;           // 이동 -> 갱신 지연 (ns)
+    _Atomic uint64_t connected, moves, updates, skipped;
+    _Atomic uint64_t err_connect, err_closed, err_decode, err_timeout;
+} Worker;
+
+static const char *ip = "127.0.0.1";
+static int port = 8080;
+static int hello_version;           // 0이면 구조체 형식
+static uint64_t interval_ms = 200;  // 연결마다 이동 간격
+static const char *script;          // 이동 스크립트 (NULL이면 무작위)
+static struct sockaddr_in addr;
+static atomic_bool stop;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// 통계는 그 스레드만 쓰므로 원자적 더하기 없이 (main이 읽는 값이 찢어지지만 않으면 됨)
+static void bump(_Atomic uint64_t *c) {
+    atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + 1, memory_order_relaxed);
+}
+
+static uint64_t peek(_Atomic uint64_t *c) {
+    return atomic_load_explicit(c, memory_order_relaxed);
+}
+
+static void conn_fail(Worker *w, Conn *c, _Atomic uint64_t *err) {
+    if (c->state == CONN_CONNECTING) w->connecting--;
+    bump(err);
+    wheel_del(&w->wheel, &c->timer);
+    epoll_ctl(w->epfd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    c->state = CONN_CLOSED;
+}
+
+static int conn_start(Worker *w, Conn *c) {
+    c->fd = socket(PF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (c->fd < 0) return -1;
+    int one = 1;
+    setsockopt(c->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(c->fd, (const struct sockaddr *)&addr, sizeof(addr)) < 0 && errno != EINPROGRESS) {
+        close(c->fd);
+        return -1;
+    }
+    struct epoll_event ev = { .events = EPOLLOUT, .data.ptr = c };
+    if (epoll_ctl(w->epfd, EPOLL_CTL_ADD, c->fd, &ev) < 0) {
+        close(c->fd);
+        return -1;
+    }
+    c->state = CONN_CONNECTING;
+    w->connecting++;
+    return 0;
+}
+
+// 방에 들어간 연결은 첫 이동을 간격 안의 무작위 시각에 걸어서 연결끼리 보내는 시각을 흩뜨림
+static void conn_ready(Worker *w, Conn *c) {
+    c->state = CONN_READY;
+    bump(&w->connected);
+    uint64_t tick = (now_ns() - w->start_ns) / 1000000;
+    wheel_add(&w->wheel, &c->timer, tick + 1 + rng_below(&w->rng, (uint32_t)interval_ms));
+}
+
+static void send_move(Worker *w, Conn *c, uint64_t intended) {
+    ClientAction action;
+    if (script) {
+        switch (script[c->script_pos++ % (int)strlen(script)]) {
+            case 'U': action = MOVE_UP; break;
+            case 'D': action = MOVE_DOWN; break;
+            case 'L': action = MOVE_LEFT; break;
+            default: action = MOVE_RIGHT; break;
+        }
+    } else {
+        action = (ClientAction)rng_below(&w->rng, 4);
+    }
+
+    uint8_t buf[WIRE_MAX_REQUEST];
+    size_t len;
+    if (c->version == 0) {
+        C2S_Packet req = { .action = action };
+        memcpy(buf, &req, sizeof(req));
+        len = sizeof(req);
+    } else {
+        c->seq = (c->seq + 1) & 0xFFFF;
+        len = wire_encode_request(buf, c->version, wire_encode_action(action), c->seq);
+    }
+    // 요청은 몇 바이트라 소켓 버퍼가 찰 일이 없음, 못 쓰면 서버가 읽지 않는 것
+    if (write(c->fd, buf, len) != (ssize_t)len) {
+        conn_fail(w, c, &w->err_closed);
+        return;
+    }
+    c->waiting = true;
+    c->sent_ns = intended;
+    bump(&w->moves);
+}
+
+// 기다리던 이동의 답이 옴
+static void move_answered(Worker *w, Conn *c, uint64_t now) {
+    hist_record(&w->lat, now - c->sent_ns);
+    c->waiting = false;
+    if (c->due) {
+        c->due = false;
+        send_move(w, c, c->due_ns);
+    }
+}
+
+// 상태 패킷 하나 (구조체 형식, 압축 버전 1 ~ 4)
+static void on_state(Worker *w, Conn *c, const S2C_Packet *pkt, bool mine, uint64_t now) {
+    bump(&w->updates);
+    c->playing = pkt->game_status != GAME_WAITING;
+    if (c->waiting && mine) move_answered(w, c, now);
+    // 상대가 나가서 기다리는 상태가 되면 그 뒤에 도착한 이동은 서버가 처리하지 않음
+    else if (c->waiting && !c->playing) c->waiting = c->due = false;
+}
+
+// 록스텝 사건 하나 (버전 5), 건너뜀 사건도 이동의 답
+static void on_event(Worker *w, Conn *c, const LockEvent *ev, uint64_t now) {
+    bump(&w->updates);
+    if (ev->who == 1 && (ev->type == LOCK_SEED || ev->type == LOCK_STATE)) c->playing = true;
+    else if (ev->who == 1 && ev->type == LOCK_LEAVE) c->playing = false;
+    if (ev->who == 0 && (ev->type == LOCK_MOVE || ev->type == LOCK_SKIP) && c->waiting) move_answered(w, c, now);
+}
+
+// 받아 둔 바이트에서 완성된 메시지를 모두 꺼내 처리
+// @return 성공 0, 잘못된 메시지면 -1
+static int conn_parse(Worker *w, Conn *c, uint64_t now) {
+    while (c->state == CONN_HELLO || c->state == CONN_READY) {
+        if (c->state == CONN_HELLO) {
+            uint8_t hello[WIRE_HELLO_SIZE];
+            if (recv_buf_peek(&c->rx, hello, sizeof(hello)) < sizeof(hello)) return 0;
+            recv_buf_consume(&c->rx, sizeof(hello));
+            if ((c->version = wire_parse_hello(hello)) < 1) return -1;
+            conn_ready(w, c);
+            continue;
+        }
+        if (c->version == 0) {
+            S2C_Packet pkt;
+            if (recv_buf_peek(&c->rx, &pkt, sizeof(pkt)) < sizeof(pkt)) return 0;
+            recv_buf_consume(&c->rx, sizeof(pkt));
+            on_state(w, c, &pkt, true, now);
+        } else if (c->version >= WIRE_LOCKSTEP_VERSION) {
+            uint8_t buf[WIRE_MAX_LOCK];
+            LockEvent ev;
+            size_t avail = recv_buf_peek(&c->rx, buf, sizeof(buf));
+            int ret = wire_decode_lock(buf, avail, &ev);
+            if (ret <= 0) return ret;
+            recv_buf_consume(&c->rx, (size_t)ret);
+            on_event(w, c, &ev, now);
+        } else {
+            uint8_t buf[WIRE_MAX_PACKET];
+            S2C_Packet pkt;
+            size_t avail = recv_buf_peek(&c->rx, buf, sizeof(buf));
+            if (avail == 0) return 0;
+            size_t len = (size_t)buf[0] + 1;
+            if (len > WIRE_MAX_PACKET) return -1;
+            if (avail < len) return 0;
+            recv_buf_consume(&c->rx, len);
+            int ret = (c->version >= 2) ? wire_decode_stream(&c->stream, buf, len, &pkt) : wire_decode_packet(buf, len, &pkt);
+            if (ret < 0) return -1;
+            // 버전 4: 내 이동을 처리한 뒤의 상태에는 그 입력 번호가 붙어 옴
+            on_state(w, c, &pkt, c->version < 4 || c->stream.ack == c->seq, now);
+        }
+    }
+    return 0;
+}
+
+static void on_conn_event(Worker *w, Conn *c, uint32_t events, uint64_t now) {
+    if (c->state == CONN_CONNECTING) {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        if (getsockopt(c->fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0 || err != 0) {
+            conn_fail(w, c, &w->err_connect);
+            return;
+        }
+        w->connecting--;
+        struct epoll_event ev = { .events = EPOLLIN, .data.ptr = c };
+        epoll_ctl(w->epfd, EPOLL_CTL_MOD, c->fd, &ev);
+        if (hello_version > 0) {
+            uint8_t hello[WIRE_HELLO_SIZE];
+            wire_hello(hello, hello_version);
+            if (write(c->fd, hello, sizeof(hello)) != (ssize_t)sizeof(hello)) {
+                conn_fail(w, c, &w->err_connect);
+                return;
+            }
+            c->state = CONN_HELLO;
+        } else {
+            // 구조체 형식: 서버는 hello를 잠깐 기다렸다가 예전 클라이언트로 보고 방에 앉힘
+            conn_ready(w, c);
+        }
+        return;
+    }
+    if (!(events & (EPOLLIN | EPOLLHUP | EPOLLERR))) return;
+
+    ssize_t n = recv_buf_fill(&c->rx, c->fd);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+    if (n <= 0) {
+        conn_fail(w, c, &w->err_closed);
+        return;
+    }
+    if (conn_parse(w, c, now) < 0) conn_fail(w, c, &w->err_decode);
+}
+
+// 보낼 시각이 된 연결: 답을 기다리는 중이면 답이 올 때 보내도록 미뤄 두고, 이미 미뤄 둔 이동이 있으면 이번 것은 건너뜀
+static void on_tick(Worker *w, Conn *c, uint64_t now) {
+    if (c->state != CONN_READY) return;
+    uint64_t intended = w->start_ns + c->timer.expires * 1000000ULL;
+    wheel_add(&w->wheel, &c->timer, c->timer.expires + interval_ms);
+
+    if (c->waiting && now - c->sent_ns > MOVE_TIMEOUT_NS) {
+        bump(&w->err_timeout);
+        c->waiting = c->due = false;
+    }
+    if (!c->playing) return;
+    if (c->waiting) {
+        if (c->due) {
+            bump(&w->skipped);
+        } else {
+            c->due = true;
+            c->due_ns = intended;
+        }
+        return;
+    }
+    send_move(w, c, intended);
+}
+
+static void *worker_main(void *arg) {
+    Worker *w = arg;
+    struct epoll_event events[MAX_EVENTS];
+
+    while (!atomic_load_explicit(&stop, memory_order_relaxed)) {
+        // 접속은 조금씩 (한꺼번에 수천 개를 걸면 SYN이 넘쳐서 재전송을 기다리느라 느려짐)
+        while (w->next_connect < w->count && w->connecting < CONNECT_INFLIGHT) {
+            Conn *c = &w->conns[w->next_connect++];
+            if (conn_start(w, c) < 0) {
+                bump(&w->err_connect);
+                c->state = CONN_CLOSED;
+            }
+        }
+
+        uint64_t now = now_ns();
+        uint64_t tick = (now - w->start_ns) / 1000000;
+        WheelTimer *t;
+        while ((t = wheel_expire(&w->wheel, tick))) on_tick(w, (Conn *)((char *)t - offsetof(Conn, timer)), now);
+
+        // 다음 타이머까지 기다리되, 종료를 확인할 수 있게 길어야 100ms
+        int timeout = 100;
+        uint64_t next;
+        if (wheel_next(&w->wheel, &next)) timeout = (next <= tick) ? 0 : (next - tick < 100 ? (int)(next - tick) : 100);
+        int n = epoll_wait(w->epfd, events, MAX_EVENTS, timeout);
+        now = now_ns();
+        for (int i = 0; i < n; i++) on_conn_event(w, events[i].data.ptr, events[i].events, now);
+    }
+
+    for (int i = 0; i < w->count; i++) {
+        Conn *c = &w->conns[i];
+        if (c->state != CONN_IDLE && c->state != CONN_CLOSED) close(c->fd);
+        recv_buf_free(&c->rx);
+    }
+    close(w->epfd);
+    return NULL;
+}
+
+typedef struct {
+    uint64_t connected, moves, updates, skipped, errors;
+} Totals;
+
+static void sum_workers(Worker *workers, int threads, Totals *t, Hist *lat) {
+    memset(t, 0, sizeof(*t));
+    if (lat) hist_reset(lat);
+    for (int i = 0; i < threads; i++) {
+        Worker *w = &workers[i];
+        t->connected += peek(&w->connected);
+        t->moves += peek(&w->moves);
+        t->updates += peek(&w->updates);
+        t->skipped += peek(&w->skipped);
+        t->errors += peek(&w->err_connect) + peek(&w->err_closed) + peek(&w->err_decode) + peek(&w->err_timeout);
+        if (lat) hist_merge(lat, &w->lat);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int conns = 1000, duration = 10;
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    double rate = 5.0;
+    if (threads > 4) threads = 4;
+    if (threads < 1) threads = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "h:p:c:t:r:d:s:v:")) != -1) {
+        switch (opt) {
+            case 'h': ip = optarg; break;
+            case 'p': port = atoi(optarg); break;
+            case 'c': conns = atoi(optarg); break;
+            case 't': threads = atoi(optarg); break;
+            case 'r': rate = atof(optarg); break;
+            case 'd': duration = atoi(optarg); break;
+            case 's': script = optarg; break;
+            case 'v': hello_version = atoi(optarg); break;
+            default:
+                fprintf(stderr, "Usage : %s [-h IP] [-p port] [-c connections] [-t threads] [-r moves_per_sec] "
+                                "[-d seconds] [-s UDLR_script] [-v version]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (conns < 1) conns = 1;
+    if (threads < 1) threads = 1;
+    if (threads > conns) threads = conns;
+    if (duration < 1) duration = 1;
+    if (rate <= 0) rate = 1;
+    interval_ms = (uint64_t)(1000.0 / rate + 0.5);
+    if (interval_ms < 1) interval_ms = 1;
+    if (script && (!script[0] || strspn(script, "UDLR") != strlen(script))) {
+        fprintf(stderr, "스크립트는 U, D, L, R로만\n");
+        return 1;
+    }
+
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = inet_addr(ip);
+    addr.sin_port = htons(port);
+
+    Conn *all = calloc((size_t)conns, sizeof(Conn));
+    Worker *workers = calloc((size_t)threads, sizeof(Worker));
+    Hist *lat = malloc(sizeof(Hist));
+    if (!all || !workers || !lat) return 1;
+
+    printf("연결 %d개 (스레드 %d개), 연결당 %.1f이동/초, %d초, 서버 %s:%d, %s 형식, %s 이동\n", conns, threads,
+           1000.0 / (double)interval_ms, duration, ip, port,
+           hello_version == 0 ? "구조체" : hello_version >= WIRE_LOCKSTEP_VERSION ? "록스텝 사건" : "압축",
+           script ? "스크립트" : "무작위");
+
+    uint64_t start = now_ns();
+    for (int i = 0; i < threads; i++) {
+        Worker *w = &workers[i];
+        int first = (int)((long)conns * i / threads), last = (int)((long)conns * (i + 1) / threads);
+        w->conns = all + first;
+        w->count = last - first;
+        w->start_ns = start;
+        w->epfd = epoll_create1(0);
+        wheel_init(&w->wheel, 0);
+        rng_seed(&w->rng, rng_entropy_seed(), (uint64_t)i);
+        hist_reset(&w->lat);
+        for (int k = 0; k < w->count; k++) {
+            Conn *c = &w->conns[k];
+            wheel_timer_init(&c->timer);
+            c->script_pos = first + k;
+            wire_stream_init(&c->stream);
+            if (recv_buf_init(&c->rx, LOADGEN_RECV_BUF) < 0) return 1;
+        }
+        if (w->epfd < 0 || pthread_create(&w->tid, NULL, worker_main, w) != 0) {
+            fprintf(stderr, "스레드 생성 실패\n");
+            return 1;
+        }
+    }
+
+    // 1초마다 그동안의 처리량과 지금까지의 p99
+    printf("%6s %8s %12s %12s %10s %8s\n", "sec", "conns", "moves/s", "updates/s", "p99 us", "errors");
+    Totals prev = {0}, cur;
+    for (int s = 1; s <= duration; s++) {
+        struct timespec next = { .tv_sec = 0, .tv_nsec = 0 };
+        uint64_t target = start + (uint64_t)s * 1000000000ULL;
+        uint64_t now = now_ns();
+        if (target > now) {
+            next.tv_sec = (time_t)((target - now) / 1000000000ULL);
+            next.tv_nsec = (long)((target - now) % 1000000000ULL);
+            nanosleep(&next, NULL);
+        }
+        sum_workers(workers, threads, &cur, lat);
+        printf("%6d %8llu %12llu %12llu %10.1f %8llu\n", s, (unsigned long long)cur.connected,
+               (unsigned long long)(cur.moves - prev.moves), (unsigned long long)(cur.updates - prev.updates),
+               (double)hist_percentile(lat, 0.99) * 1e-3, (unsigned long long)cur.errors);
+        fflush(stdout);
+        prev = cur;
+    }
+
+    atomic_store(&stop, true);
+    for (int i = 0; i < threads; i++) pthread_join(workers[i].tid, NULL);
+    double elapsed = (double)(now_ns() - start) * 1e-9;
+
+    sum_workers(workers, threads, &cur, lat);
+    uint64_t err_connect = 0, err_closed = 0, err_decode = 0, err_timeout = 0;
+    for (int i = 0; i < threads; i++) {
+        err_connect += peek(&workers[i].err_connect);
+        err_closed += peek(&workers[i].err_closed);
+        err_decode += peek(&workers[i].err_decode);
+        err_timeout += peek(&workers[i].err_timeout);
+    }
+
+    printf("\n결과 (%.1f초)\n", elapsed);
+    printf("  연결        %llu / %d\n", (unsigned long long)cur.connected, conns);
+    printf("  이동        %llu (초당 %.0f)\n", (unsigned long long)cur.moves, (double)cur.moves / elapsed);
+    printf("  갱신        %llu (초당 %.0f)\n", (unsigned long long)cur.updates, (double)cur.updates / elapsed);
+    printf("  지연 us     p50 %.1f  p99 %.1f  p999 %.1f  max %.1f  평균 %.1f (답을 받은 이동 %llu개)\n",
+           (double)hist_percentile(lat, 0.5) * 1e-3, (double)hist_percentile(lat, 0.99) * 1e-3,
+           (double)hist_percentile(lat, 0.999) * 1e-3, (double)hist_percentile(lat, 1.0) * 1e-3,
+           hist_mean(lat) * 1e-3, (unsigned long long)hist_count(lat));
+    printf("  건너뜀      %llu (답을 기다리느라 보내지 못한 이동)\n", (unsigned long long)cur.skipped);
+    printf("  오류        접속 %llu, 끊김 %llu, 잘못된 메시지 %llu, 시간 초과 %llu\n", (unsigned long long)err_connect,
+           (unsigned long long)err_closed, (unsigned long long)err_decode, (unsigned long long)err_timeout);
+
+    free(all);
+    free(workers);
+    free(lat);
+    // 오류가 있으면 실패로 (CI에서 확장성 회귀 확인용)
+    return cur.errors ? 1 : 0;
+}
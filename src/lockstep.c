@@ -0,0 +1,86 @@
+#include "lockstep.h"
+#include <string.h> // memset(), memcpy()
+
+void lockstep_init(Lockstep *ls) {
+    memset(ls, 0, sizeof(*ls));
+}
+
+int lockstep_apply(Lockstep *ls, const LockEvent *ev) {
+    GameState *g = &ls->games[ev->who];
+    GameState *other = &ls->games[1 - ev->who];
+    ls->hit = false;
+
+    switch (ev->type) {
+        case LOCK_SEED:
+            game_init_seeded(g, ev->seed, (uint64_t)ev->stream);
+            ls->present[ev->who] = true;
+            return 0;
+        case LOCK_STATE:
+            *g = ev->state;
+            g->moved = false;
+            ls->present[ev->who] = true;
+            return 0;
+        case LOCK_LEAVE:
+            ls->present[ev->who] = false;
+            return 0;
+        case LOCK_SKIP:
+            return 0;
+        default:
+            break;
+    }
+
+    // 이동과 대기 공격은 양쪽 게임이 모두 있어야 적용할 수 있음
+    if (!ls->present[0] || !ls->present[1]) return -1;
+    if (ev->type == LOCK_IDLE) {
+        game_execute_attack(g);
+        game_is_over(g);
+        return 0;
+    }
+    int attacks = game_play_move(g, other, ev->dir);
+    if (ev->who == 1) ls->hit = attacks > 0;
+    return 0;
+}
+
+bool lockstep_acks_input(const LockEvent *ev) {
+    return ev->who == 0 && (ev->type == LOCK_MOVE || ev->type == LOCK_SKIP);
+}
+
+void lockstep_packet(const Lockstep *ls, S2C_Packet *pkt) {
+    lockstep_compose_packet(&ls->games[0], &ls->games[1], ls->present[1], pkt);
+    pkt->is_hit = ls->hit;
+}
+
+void lockstep_compose_packet(const GameState *me, const GameState *other, bool opp_present, S2C_Packet *pkt) {
+    // 패킷 메모리 초기화
+    memset(pkt, 0, sizeof(S2C_Packet));
+
+    // 내 정보 채우기
+    memcpy(pkt->my_board, me->board, sizeof(int) * 16);
+    pkt->my_score = me->score;
+
+    // 상대방 정보 (없으면 0)
+    if (opp_present) {
+        memcpy(pkt->opp_board, other->board, sizeof(int) * 16);
+        pkt->opp_score = other->score;
+    }
+
+    // 공격 정보
+    memcpy(pkt->pending_attacks, me->attack_queue, sizeof(int) * MAX_ATTACK_QUEUE);
+    pkt->attack_count = me->attack_cnt;
+    pkt->highlight_r = me->highlight_r;
+    pkt->highlight_c = me->highlight_c;
+
+    pkt->is_hit = false;
+
+    // 게임 상태 판정
+    if (!opp_present) {
+        pkt->game_status = GAME_WAITING;
+    } else if (me->game_over && other->game_over) {
+        // 무승부=패배 처리
+        pkt->game_status = (me->score > other->score) ? GAME_WIN : GAME_LOSE;
+    } else if (me->game_over) {
+        pkt->game_status = GAME_OVER_WAIT;
+    } else {
+        pkt->game_status = GAME_PLAYING;
+    }
+}
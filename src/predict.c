@@ -0,0 +1,53 @@
+#include "predict.h"
+#include <string.h> // memset(), memcpy()
+
+void predict_init(Predictor *p) {
+    memset(p, 0, sizeof(*p));
+}
+
+int predict_input(Predictor *p, Direction dir) {
+    uint16_t seq = p->next_seq++;
+    // 넘치면 기록하지 않음 (그 입력은 서버 상태가 와야 보임)
+    if (p->count < PREDICT_MAX_PENDING) {
+        PredictInput *in = &p->pending[(p->head + p->count) % PREDICT_MAX_PENDING];
+        in->seq = seq;
+        in->dir = dir;
+        p->count++;
+    }
+    return seq;
+}
+
+void predict_server_state(Predictor *p, const S2C_Packet *pkt, int ack) {
+    p->server = *pkt;
+    p->has_server = true;
+    if (ack < 0) return;
+
+    // 번호는 65535 다음 0으로 돌므로 차이의 부호로 앞뒤를 비교
+    while (p->count > 0 && (int16_t)(p->pending[p->head].seq - (uint16_t)ack) <= 0) {
+        p->head = (p->head + 1) % PREDICT_MAX_PENDING;
+        p->count--;
+    }
+}
+
+bool predict_view(const Predictor *p, S2C_Packet *out) {
+    if (!p->has_server) return false;
+    *out = p->server;
+    if (p->count == 0 || out->game_status != GAME_PLAYING) return true;
+
+    GameState state;
+    memset(&state, 0, sizeof(state));
+    memcpy(state.board, out->my_board, sizeof(state.board));
+    state.score = out->my_score;
+    state.highlight_r = out->highlight_r;
+    state.highlight_c = out->highlight_c;
+
+    for (int i = 0; i < p->count; i++) {
+        game_move(&state, p->pending[(p->head + i) % PREDICT_MAX_PENDING].dir);
+    }
+
+    memcpy(out->my_board, state.board, sizeof(out->my_board));
+    out->my_score = state.score;
+    out->highlight_r = state.highlight_r;
+    out->highlight_c = state.highlight_c;
+    return true;
+}
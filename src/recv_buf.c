@@ -0,0 +1,68 @@
+#define _DEFAULT_SOURCE
+#include "recv_buf.h"
+#include <stdlib.h>  // malloc(), free()
+#include <string.h>  // memcpy()
+#include <errno.h>
+#include <sys/uio.h> // readv()
+
+int recv_buf_init(RecvBuf *rb, size_t cap) {
+    size_t n = 16;
+    while (n < cap) n *= 2;
+    rb->data = malloc(n);
+    rb->cap = rb->data ? n : 0;
+    rb->head = rb->len = 0;
+    return rb->data ? 0 : -1;
+}
+
+void recv_buf_free(RecvBuf *rb) {
+    free(rb->data);
+    rb->data = NULL;
+    rb->cap = rb->head = rb->len = 0;
+}
+
+ssize_t recv_buf_fill(RecvBuf *rb, int fd) {
+    if (rb->len == rb->cap) {
+        errno = ENOBUFS;
+        return -1;
+    }
+
+    // 빈 자리: tail부터 끝까지, 그리고 (링이 돌았으면) 처음부터 head까지
+    size_t tail = (rb->head + rb->len) & (rb->cap - 1);
+    struct iovec iov[2];
+    int cnt = 1;
+    if (tail >= rb->head) {
+        iov[0].iov_base = rb->data + tail;
+        iov[0].iov_len = rb->cap - tail;
+        if (rb->head > 0) {
+            iov[1].iov_base = rb->data;
+            iov[1].iov_len = rb->head;
+            cnt = 2;
+        }
+    } else {
+        iov[0].iov_base = rb->data + tail;
+        iov[0].iov_len = rb->head - tail;
+    }
+
+    ssize_t n;
+    do {
+        n = readv(fd, iov, cnt);
+    } while (n < 0 && errno == EINTR);
+    if (n > 0) rb->len += (size_t)n;
+    return n;
+}
+
+size_t recv_buf_peek(const RecvBuf *rb, void *out, size_t n) {
+    if (n > rb->len) n = rb->len;
+    size_t first = rb->cap - rb->head;
+    if (first > n) first = n;
+    memcpy(out, rb->data + rb->head, first);
+    memcpy((uint8_t *)out + first, rb->data, n - first);
+    return n;
+}
+
+void recv_buf_consume(RecvBuf *rb, size_t n) {
+    if (n > rb->len) n = rb->len;
+    rb->head = (rb->head + n) & (rb->cap - 1);
+    rb->len -= n;
+    if (rb->len == 0) rb->head = 0; // 비면 처음부터 (다음 read가 한 조각으로)
+}
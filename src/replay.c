@@ -0,0 +1,352 @@
+#define _DEFAULT_SOURCE
+#include "replay.h"
+#include "bitboard.h" // bb_from_array()
+#include <stdlib.h>   // malloc(), realloc()
+#include <string.h>   // memcpy()
+#include <time.h>     // clock_gettime()
+#include <fcntl.h>    // open()
+#include <unistd.h>   // close()
+#include <sys/mman.h> // mmap()
+#include <sys/stat.h> // fstat()
+
+#define REPLAY_INITIAL_CAP 4096 // 처음 할당하는 버퍼 크기 (짧은 경기는 늘리지 않고 끝남)
+
+// ==========================================
+// [1] 리틀 엔디언 / varint
+// ==========================================
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (i * 8));
+}
+
+static void put_u64(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) p[i] = (uint8_t)(v >> (i * 8));
+}
+
+static uint8_t *put_varint(uint8_t *p, uint32_t v) {
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t get_u64(const uint8_t *p) {
+    return (uint64_t)get_u32(p) | ((uint64_t)get_u32(p + 4) << 32);
+}
+
+// @return 다음 위치, 잘렸거나 32비트를 넘으면 NULL
+static const uint8_t *get_varint(const uint8_t *p, const uint8_t *end, uint32_t *v) {
+    uint32_t x = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (p >= end) return NULL;
+        uint8_t b = *p++;
+        x |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *v = x;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// ==========================================
+// [2] 기록 (방의 루프 스레드)
+// ==========================================
+
+Replay *replay_begin(uint64_t id, uint32_t room_id) {
+    Replay *r = malloc(sizeof(Replay) + REPLAY_INITIAL_CAP);
+    if (!r) return NULL;
+    r->next = NULL;
+    r->start_ns = now_ns();
+    r->last_ms = 0;
+    r->cap = REPLAY_INITIAL_CAP;
+    r->len = REPLAY_HEADER_SIZE;
+
+    struct timespec wall;
+    clock_gettime(CLOCK_REALTIME, &wall);
+    put_u32(r->data, REPLAY_MAGIC);
+    put_u32(r->data + 4, 0);  // 본문 크기, 체크섬은 replay_seal에서
+    put_u32(r->data + 8, 0);
+    put_u32(r->data + 12, room_id);
+    put_u64(r->data + 16, id);
+    put_u64(r->data + 24, (uint64_t)wall.tv_sec * 1000 + (uint64_t)wall.tv_nsec / 1000000);
+    return r;
+}
+
+// 사건 틀 하나 (버전 5 사건과 같은 모양) 인코딩
+static size_t encode_event(const ReplayEvent *ev, uint8_t *out) {
+    uint8_t code = (uint8_t)(ev->type << 4) | (uint8_t)((ev->seat & 1) << 2);
+    uint8_t *p = out + 2;
+
+    switch (ev->type) {
+        case REPLAY_SEED:
+        case REPLAY_STATE: {
+            LockEvent lock = { .type = (LockEventType)ev->type, .who = ev->seat, .seed = ev->seed, .stream = ev->stream };
+            if (ev->type == REPLAY_STATE) lock.state = ev->state;
+            return wire_encode_lock(&lock, out);
+        }
+        case REPLAY_MOVE:
+            code |= (uint8_t)(ev->dir & 0x3);
+            break;
+        case REPLAY_ATTACK:
+            *p++ = (uint8_t)ev->attacks;
+            break;
+        case REPLAY_END:
+            *p++ = (uint8_t)ev->reason;
+            *p++ = (uint8_t)ev->winner;
+            p = put_varint(p, (uint32_t)ev->scores[0]);
+            p = put_varint(p, (uint32_t)ev->scores[1]);
+            put_u64(p, ev->boards[0]);
+            put_u64(p + 8, ev->boards[1]);
+            p += 16;
+            break;
+        default:
+            break;
+    }
+    out[0] = (uint8_t)(p - out - 1);
+    out[1] = code;
+    return (size_t)(p - out);
+}
+
+int replay_append(Replay **r, const ReplayEvent *ev) {
+    Replay *cur = *r;
+    if (cur->cap - cur->len < REPLAY_MAX_EVENT) {
+        Replay *grown = realloc(cur, sizeof(Replay) + cur->cap * 2);
+        if (!grown) return -1;
+        grown->cap *= 2;
+        *r = cur = grown;
+    }
+
+    uint32_t t_ms = (uint32_t)((now_ns() - cur->start_ns) / 1000000);
+    uint8_t *p = put_varint(cur->data + cur->len, t_ms - cur->last_ms);
+    p += encode_event(ev, p);
+    cur->last_ms = t_ms;
+    cur->len = (size_t)(p - cur->data);
+    return 0;
+}
+
+uint32_t replay_checksum(const uint8_t *data, size_t len) {
+    uint32_t h = 2166136261U;
+    for (size_t i = 0; i < len; i++) {
+        h ^= data[i];
+        h *= 16777619U;
+    }
+    return h;
+}
+
+void replay_seal(Replay *r) {
+    size_t body = r->len - REPLAY_HEADER_SIZE;
+    put_u32(r->data + 4, (uint32_t)body);
+    put_u32(r->data + 8, replay_checksum(r->data + REPLAY_HEADER_SIZE, body));
+}
+
+// ==========================================
+// [3] 읽기 (mmap, 복사 없음)
+// ==========================================
+
+int replay_open(ReplayFile *f, const char *path) {
+    f->base = NULL;
+    f->size = 0;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return -1;
+    }
+    if (st.st_size > 0) {
+        void *base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (base == MAP_FAILED) {
+            close(fd);
+            return -1;
+        }
+        // 처음부터 끝까지 한 번 훑으므로 미리 읽어 두게
+        madvise(base, (size_t)st.st_size, MADV_SEQUENTIAL);
+        f->base = base;
+        f->size = (size_t)st.st_size;
+    }
+    close(fd); // 매핑은 fd를 닫아도 남음
+    return 0;
+}
+
+void replay_close(ReplayFile *f) {
+    if (f->base) munmap((void *)f->base, f->size);
+    f->base = NULL;
+    f->size = 0;
+}
+
+long replay_block_size(const uint8_t *p, size_t avail) {
+    if (avail < REPLAY_HEADER_SIZE) return 0;
+    if (get_u32(p) != REPLAY_MAGIC) return -1;
+    return (long)REPLAY_HEADER_SIZE + (long)get_u32(p + 4);
+}
+
+int replay_next_match(const ReplayFile *f, size_t *off, ReplayMatch *m) {
+    if (*off >= f->size) return 0;
+
+    const uint8_t *h = f->base + *off;
+    long size = replay_block_size(h, f->size - *off);
+    if (size <= 0 || (size_t)size > f->size - *off) return -1;
+    size_t body = (size_t)size - REPLAY_HEADER_SIZE;
+    if (replay_checksum(h + REPLAY_HEADER_SIZE, body) != get_u32(h + 8)) return -1;
+
+    m->room_id = get_u32(h + 12);
+    m->id = get_u64(h + 16);
+    m->start_ms = get_u64(h + 24);
+    m->body = h + REPLAY_HEADER_SIZE;
+    m->len = body;
+    *off += REPLAY_HEADER_SIZE + body;
+    return 1;
+}
+
+int replay_next_event(const ReplayMatch *m, ReplayCursor *cur, ReplayEvent *ev) {
+    if (cur->off >= m->len) return 0;
+    const uint8_t *p = m->body + cur->off, *end = m->body + m->len;
+
+    uint32_t dt;
+    if (!(p = get_varint(p, end, &dt)) || end - p < 2) return -1;
+    size_t size = (size_t)p[0] + 1;
+    if (size > (size_t)(end - p) || p[0] < 1) return -1;
+
+    uint8_t code = p[1];
+    ReplayEventType type = (ReplayEventType)(code >> 4);
+    memset(ev, 0, sizeof(*ev));
+    ev->type = type;
+    ev->seat = (code >> 2) & 1;
+    ev->dir = (Direction)(code & 0x3);
+    if (type != REPLAY_MOVE && (code & 0x3)) return -1;
+
+    const uint8_t *q = p + 2, *stop = p + size;
+    switch (type) {
+        case REPLAY_SEED:
+        case REPLAY_STATE: {
+            LockEvent lock;
+            if (wire_decode_lock(p, size, &lock) != (int)size) return -1;
+            ev->seed = lock.seed;
+            ev->stream = lock.stream;
+            ev->state = lock.state;
+            break;
+        }
+        case REPLAY_MOVE:
+        case REPLAY_IDLE:
+            if (q != stop) return -1;
+            break;
+        case REPLAY_ATTACK:
+            if (stop - q != 1) return -1;
+            ev->attacks = *q;
+            break;
+        case REPLAY_END: {
+            uint32_t s0, s1;
+            if (stop - q < 2) return -1;
+            ev->reason = (ReplayReason)q[0];
+            ev->winner = q[1] == REPLAY_NO_WINNER ? -1 : q[1];
+            if (ev->reason > REPLAY_SPLIT || (ev->winner > 1)) return -1;
+            q += 2;
+            if (!(q = get_varint(q, stop, &s0)) || !(q = get_varint(q, stop, &s1)) || stop - q != 16) return -1;
+            ev->scores[0] = (int)s0;
+            ev->scores[1] = (int)s1;
+            ev->boards[0] = get_u64(q);
+            ev->boards[1] = get_u64(q + 8);
+            break;
+        }
+        default:
+            return -1;
+    }
+
+    cur->t_ms += dt;
+    ev->t_ms = cur->t_ms;
+    cur->off = (size_t)(stop - m->body);
+    return 1;
+}
+
+// ==========================================
+// [4] 검증 (다시 진행해서 기록과 비교)
+// ==========================================
+
+static ReplayVerdict diverge(ReplayCheck *out, ReplayVerdict v, uint64_t recorded, uint64_t replayed) {
+    out->verdict = v;
+    out->recorded = recorded;
+    out->replayed = replayed;
+    return v;
+}
+
+ReplayVerdict replay_verify(const ReplayMatch *m, ReplayCheck *out) {
+    GameState g[2];
+    bool have[2] = { false, false }, ended = false;
+    int expect_attack = 0, ret; // 방금 이동이 보낸 공격 수 (다음 사건이 그 공격이어야 함)
+    ReplayCursor cur = {0};
+    ReplayEvent ev;
+
+    memset(out, 0, sizeof(*out));
+    while ((ret = replay_next_event(m, &cur, &ev)) > 0) {
+        out->event++;
+        out->seat = ev.seat;
+        out->t_ms = ev.t_ms;
+        if (ended) return diverge(out, REPLAY_BAD_FORMAT, 0, 0);
+        if (expect_attack > 0 && ev.type != REPLAY_ATTACK) return diverge(out, REPLAY_BAD_ATTACK, 0, (uint64_t)expect_attack);
+
+        GameState *me = &g[ev.seat];
+        switch (ev.type) {
+            case REPLAY_SEED:
+                game_init_seeded(me, ev.seed, (uint64_t)ev.stream);
+                have[ev.seat] = true;
+                break;
+            case REPLAY_STATE:
+                *me = ev.state;
+                have[ev.seat] = true;
+                break;
+            case REPLAY_MOVE:
+                if (!have[0] || !have[1]) return diverge(out, REPLAY_BAD_FORMAT, 0, 0);
+                if (me->game_over) return diverge(out, REPLAY_BAD_MOVE, 0, 0);
+                expect_attack = game_play_move(me, &g[1 - ev.seat], ev.dir);
+                out->moves++;
+                break;
+            case REPLAY_ATTACK:
+                if (ev.attacks != expect_attack) return diverge(out, REPLAY_BAD_ATTACK, (uint64_t)ev.attacks, (uint64_t)expect_attack);
+                expect_attack = 0;
+                break;
+            case REPLAY_IDLE:
+                if (!have[0] || !have[1]) return diverge(out, REPLAY_BAD_FORMAT, 0, 0);
+                game_execute_attack(me);
+                game_is_over(me);
+                break;
+            case REPLAY_END:
+                if (!have[0] || !have[1]) return diverge(out, REPLAY_BAD_FORMAT, 0, 0);
+                for (int i = 0; i < 2; i++) {
+                    out->seat = i;
+                    if (ev.scores[i] != g[i].score) return diverge(out, REPLAY_BAD_SCORE, (uint64_t)ev.scores[i], (uint64_t)g[i].score);
+                    uint64_t board = bb_from_array(g[i].board);
+                    if (ev.boards[i] != board) return diverge(out, REPLAY_BAD_BOARD, ev.boards[i], board);
+                }
+                out->seat = ev.seat;
+                // 둘 다 끝났을 때만 이긴 쪽이 있음 (동점은 없음)
+                bool over = g[0].game_over && g[1].game_over;
+                int winner = (ev.reason == REPLAY_FINISHED && g[0].score != g[1].score) ? (g[0].score > g[1].score ? 0 : 1) : -1;
+                if ((ev.reason == REPLAY_FINISHED) != over || ev.winner != winner) {
+                    return diverge(out, REPLAY_BAD_RESULT, (uint64_t)(ev.winner + 1), (uint64_t)(winner + 1));
+                }
+                ended = true;
+                break;
+        }
+    }
+    if (ret < 0 || !ended) return diverge(out, REPLAY_BAD_FORMAT, 0, 0);
+    return REPLAY_OK;
+}
+
+const char *replay_verdict_name(ReplayVerdict v) {
+    static const char *names[] = { "ok", "format", "move", "attack", "score", "board", "result" };
+    return (v >= REPLAY_OK && v <= REPLAY_BAD_RESULT) ? names[v] : "?";
+}
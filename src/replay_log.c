@@ -0,0 +1,136 @@
+#define _DEFAULT_SOURCE
+#include "replay_log.h"
+#include <stdio.h>    // perror()
+#include <stdlib.h>   // calloc(), free()
+#include <stdbool.h>  // for bool type
+#include <errno.h>
+#include <fcntl.h>    // open()
+#include <unistd.h>   // write(), lseek(), ftruncate(), fdatasync(), close()
+#include <pthread.h>
+
+struct ReplayLog {
+    int fd;
+    pthread_t tid;
+
+    pthread_mutex_t lock;   // 아래 필드 보호
+    pthread_cond_t cv;
+    Replay *head, *tail;    // 쓸 경기 (끝난 순서)
+    size_t pending;         // 대기열의 바이트 수
+    size_t max_pending;
+    bool shutdown;
+    ReplayLogStats stats;
+};
+
+static int write_all(int fd, const uint8_t *p, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// 대기열을 통째로 가져와서 쓰고 fdatasync 한 번, 종료 요청이 오고 대기열이 비면 끝
+static void *writer_main(void *arg) {
+    ReplayLog *log = arg;
+
+    pthread_mutex_lock(&log->lock);
+    for (;;) {
+        while (!log->head && !log->shutdown) pthread_cond_wait(&log->cv, &log->lock);
+        if (!log->head) break;
+
+        Replay *batch = log->head;
+        log->head = log->tail = NULL;
+        log->pending = 0;
+        pthread_mutex_unlock(&log->lock);
+
+        uint64_t matches = 0, bytes = 0, dropped = 0;
+        while (batch) {
+            Replay *r = batch;
+            batch = r->next;
+            replay_seal(r);
+            off_t end = lseek(log->fd, 0, SEEK_END);
+            if (write_all(log->fd, r->data, r->len) < 0) {
+                // 덜 쓴 덩어리를 남기면 그 뒤의 경기를 읽을 수 없으므로 잘라 냄
+                perror("[Replay] write");
+                if (end >= 0 && ftruncate(log->fd, end) < 0) perror("[Replay] ftruncate");
+                dropped++;
+            } else {
+                matches++;
+                bytes += r->len;
+            }
+            free(r);
+        }
+        if (fdatasync(log->fd) < 0) perror("[Replay] fdatasync");
+
+        pthread_mutex_lock(&log->lock);
+        log->stats.matches += matches;
+        log->stats.bytes += bytes;
+        log->stats.dropped += dropped;
+        log->stats.syncs++;
+    }
+    pthread_mutex_unlock(&log->lock);
+    return NULL;
+}
+
+ReplayLog *replay_log_open(const char *path, size_t max_pending) {
+    ReplayLog *log = calloc(1, sizeof(ReplayLog));
+    if (!log) return NULL;
+    log->fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (log->fd < 0) {
+        free(log);
+        return NULL;
+    }
+    log->max_pending = max_pending;
+    pthread_mutex_init(&log->lock, NULL);
+    pthread_cond_init(&log->cv, NULL);
+    if (pthread_create(&log->tid, NULL, writer_main, log) != 0) {
+        close(log->fd);
+        pthread_mutex_destroy(&log->lock);
+        pthread_cond_destroy(&log->cv);
+        free(log);
+        return NULL;
+    }
+    return log;
+}
+
+int replay_log_submit(ReplayLog *log, Replay *r) {
+    pthread_mutex_lock(&log->lock);
+    if (log->max_pending && log->pending + r->len > log->max_pending) {
+        log->stats.dropped++;
+        pthread_mutex_unlock(&log->lock);
+        free(r);
+        return -1;
+    }
+    r->next = NULL;
+    if (log->tail) log->tail->next = r;
+    else log->head = r;
+    log->tail = r;
+    log->pending += r->len;
+    pthread_cond_signal(&log->cv);
+    pthread_mutex_unlock(&log->lock);
+    return 0;
+}
+
+void replay_log_close(ReplayLog *log) {
+    pthread_mutex_lock(&log->lock);
+    log->shutdown = true;
+    pthread_cond_signal(&log->cv);
+    pthread_mutex_unlock(&log->lock);
+    pthread_join(log->tid, NULL);
+
+    close(log->fd);
+    pthread_mutex_destroy(&log->lock);
+    pthread_cond_destroy(&log->cv);
+    free(log);
+}
+
+void replay_log_stats(ReplayLog *log, ReplayLogStats *out) {
+    pthread_mutex_lock(&log->lock);
+    *out = log->stats;
+    pthread_mutex_unlock(&log->lock);
+}
@@ -0,0 +1,414 @@
+// 경기 기록 대량 검증기: 서버가 남긴 기록 파일(replay.h)을 모든 코어로 다시 진행해서
+// 기록된 공격 수, 끝 점수/보드/결과가 다시 진행한 값과 다른 경기를 찾아 출력 (부정행위/서버 버그 감사)
+// 사용법: ./bin/replay_verify [-t 스레드 수] [-q] 파일... ('-'는 표준 입력)
+//         ./bin/replay_verify -g 경기 수 [-s 시드] [-x N] 출력 파일   (벤치마크용 기록 생성, -x: N경기마다 점수 하나를 조작)
+//
+// 파일은 통째로 읽지 않고 CHUNK_SIZE 덩어리로 차례로 읽어서 (끝이 잘린 경기는 다음 덩어리 앞으로 옮김)
+// 경기 경계에 맞춘 덩어리를 작업 대기열로 넘기고, 스레드마다 덩어리 하나씩 가져가서 검증함
+// 덩어리 수가 정해져 있으므로 파일이 아무리 커도 메모리는 CHUNK_SIZE x (스레드 수 x 2 + 2)를 넘지 않음
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <fcntl.h>      // open()
+#include <time.h>       // clock_gettime()
+#include <unistd.h>     // read(), write(), sysconf(), getopt()
+#include <pthread.h>
+#include "game.h"
+#include "bitboard.h"
+#include "replay.h"
+
+#define CHUNK_SIZE (4 * 1024 * 1024) // 경기 하나(최대 REPLAY_SPLIT_BYTES 남짓)가 항상 들어가는 크기
+
+_Static_assert(CHUNK_SIZE >= 2 * REPLAY_SPLIT_BYTES, "a chunk must hold the largest match block");
+
+// 경기 경계에 맞춰 자른 입력 조각
+typedef struct Chunk {
+    struct Chunk *next;
+    const char *file;       // 출력용
+    size_t file_off;        // 파일 안에서 data[0]의 위치
+    size_t len;
+    uint8_t data[];
+} Chunk;
+
+// 읽는 스레드(main)와 검증 스레드 사이의 대기열, 빈 덩어리 목록
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t work_cv;     // 검증할 덩어리가 생김 (또는 입력 끝)
+    pthread_cond_t free_cv;     // 빈 덩어리가 생김
+    Chunk *work_head, *work_tail;
+    Chunk *free_list;
+    bool done;
+} ChunkQueue;
+
+// 스레드별 집계 (다른 스레드와 캐시 라인을 나눠 쓰지 않도록 정렬)
+typedef struct {
+    long matches;
+    long moves;
+    long bytes;
+    long flagged;           // 기록과 다시 진행한 결과가 다른 경기
+    long corrupt;           // 체크섬이 맞지 않는 덩어리
+    long verdicts[REPLAY_BAD_RESULT + 1];
+    double busy;            // 검증하는 데 쓴 시간 (s)
+} __attribute__((aligned(64))) VerifyStats;
+
+typedef struct {
+    int id;
+    ChunkQueue *q;
+    bool quiet;
+    VerifyStats stats;
+} VerifyWorker;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// ==========================================
+// [1] 덩어리 대기열
+// ==========================================
+
+static Chunk *take_free(ChunkQueue *q) {
+    pthread_mutex_lock(&q->lock);
+    while (!q->free_list) pthread_cond_wait(&q->free_cv, &q->lock);
+    Chunk *c = q->free_list;
+    q->free_list = c->next;
+    pthread_mutex_unlock(&q->lock);
+    return c;
+}
+
+static void give_free(ChunkQueue *q, Chunk *c) {
+    pthread_mutex_lock(&q->lock);
+    c->next = q->free_list;
+    q->free_list = c;
+    pthread_cond_signal(&q->free_cv);
+    pthread_mutex_unlock(&q->lock);
+}
+
+static void push_work(ChunkQueue *q, Chunk *c) {
+    pthread_mutex_lock(&q->lock);
+    c->next = NULL;
+    if (q->work_tail) q->work_tail->next = c;
+    else q->work_head = c;
+    q->work_tail = c;
+    pthread_cond_signal(&q->work_cv);
+    pthread_mutex_unlock(&q->lock);
+}
+
+// 검증할 덩어리 하나, 입력이 끝나고 대기열도 비었으면 NULL
+static Chunk *pop_work(ChunkQueue *q) {
+    pthread_mutex_lock(&q->lock);
+    while (!q->work_head && !q->done) pthread_cond_wait(&q->work_cv, &q->lock);
+    Chunk *c = q->work_head;
+    if (c) {
+        q->work_head = c->next;
+        if (!q->work_head) q->work_tail = NULL;
+    }
+    pthread_mutex_unlock(&q->lock);
+    return c;
+}
+
+// ==========================================
+// [2] 검증 스레드
+// ==========================================
+
+static void *worker_main(void *arg) {
+    VerifyWorker *w = arg;
+    Chunk *c;
+
+    while ((c = pop_work(w->q))) {
+        double t0 = now_sec();
+        ReplayFile f = { c->data, c->len };
+        ReplayMatch m;
+        size_t off = 0;
+        int ret;
+
+        // 경계는 읽는 쪽에서 맞췄으므로 -1은 체크섬이 틀린 덩어리, 건너뛰고 계속
+        while ((ret = replay_next_match(&f, &off, &m)) != 0) {
+            if (ret < 0) {
+                w->stats.corrupt++;
+                printf("[%s @%zu] 체크섬 불일치, 경기 하나 건너뜀\n", c->file, c->file_off + off);
+                off += (size_t)replay_block_size(c->data + off, c->len - off);
+                continue;
+            }
+
+            ReplayCheck check;
+            ReplayVerdict v = replay_verify(&m, &check);
+            w->stats.matches++;
+            w->stats.moves += check.moves;
+            w->stats.bytes += (long)(m.len + REPLAY_HEADER_SIZE);
+            w->stats.verdicts[v]++;
+            if (v == REPLAY_OK) continue;
+
+            w->stats.flagged++;
+            if (!w->quiet) {
+                printf("[불일치] 경기 %llu (방 %u, 시작 %llu ms) 사건 %d, %d.%03us, P%d %s: 기록 %llu / 다시 진행 %llu\n",
+                       (unsigned long long)m.id, m.room_id, (unsigned long long)m.start_ms, check.event,
+                       check.t_ms / 1000, check.t_ms % 1000, check.seat + 1, replay_verdict_name(v),
+                       (unsigned long long)check.recorded, (unsigned long long)check.replayed);
+            }
+        }
+        w->stats.busy += now_sec() - t0;
+        give_free(w->q, c);
+    }
+    return NULL;
+}
+
+// ==========================================
+// [3] 입력 읽기 (경기 경계에 맞춰 자름)
+// ==========================================
+
+// data[0, len)에서 통째로 들어 있는 경기들의 끝 위치 (경기 덩어리가 아닌 곳이 나오면 *bad = true, 그 위치)
+static size_t complete_prefix(const uint8_t *data, size_t len, bool *bad) {
+    size_t off = 0;
+    *bad = false;
+    for (;;) {
+        long size = replay_block_size(data + off, len - off);
+        if (size < 0) *bad = true;
+        if (size <= 0 || (size_t)size > len - off) return off;
+        off += (size_t)size;
+    }
+}
+
+// 파일 하나를 덩어리로 나눠 대기열에 넣음
+// @return 성공 0, 읽기 실패 또는 깨진 파일이면 -1 (그 앞까지는 검증함)
+static int feed_file(ChunkQueue *q, const char *path) {
+    int fd = strcmp(path, "-") == 0 ? STDIN_FILENO : open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    if (fd != STDIN_FILENO) posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    int result = 0;
+    size_t file_off = 0;
+    Chunk *c = take_free(q);
+    c->file = path;
+    c->file_off = 0;
+    c->len = 0;
+    for (;;) {
+        ssize_t n = read(fd, c->data + c->len, CHUNK_SIZE - c->len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            perror(path);
+            result = -1;
+            break;
+        }
+        c->len += (size_t)n;
+        // 덩어리를 다 채운 뒤에 넘김 (파이프에서 조금씩 와도 작은 덩어리가 많아지지 않게)
+        if (n > 0 && c->len < CHUNK_SIZE) continue;
+
+        bool bad;
+        size_t end = complete_prefix(c->data, c->len, &bad);
+        if (bad || (end == 0 && c->len == CHUNK_SIZE)) {
+            fprintf(stderr, "[%s @%zu] 경기 기록이 아닌 데이터, 이 파일은 여기까지만 검증\n", path, file_off + end);
+            c->len = end;
+            result = -1;
+            break;
+        }
+        if (n == 0) {
+            if (end < c->len) {
+                fprintf(stderr, "[%s @%zu] 파일 끝의 경기가 덜 써짐 (%zu바이트 무시)\n", path, file_off + end, c->len - end);
+            }
+            c->len = end;
+            break;
+        }
+
+        // 끝이 잘린 경기는 다음 덩어리 앞으로
+        Chunk *next = take_free(q);
+        size_t tail = c->len - end;
+        memcpy(next->data, c->data + end, tail);
+        next->file = path;
+        next->file_off = file_off + end;
+        next->len = tail;
+        c->len = end;
+        push_work(q, c);
+        file_off = next->file_off;
+        c = next;
+    }
+
+    if (c->len > 0) push_work(q, c);
+    else give_free(q, c);
+    if (fd != STDIN_FILENO) close(fd);
+    return result;
+}
+
+// ==========================================
+// [4] 벤치마크용 기록 생성
+// ==========================================
+
+// 무작위로 두는 1:1 경기 count개를 서버와 같은 모양으로 기록 (every > 0이면 every경기마다 끝 점수 하나를 조작)
+static int generate(const char *path, long count, uint64_t seed, long every) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        perror(path);
+        return 1;
+    }
+    Rng rng;
+    rng_seed(&rng, seed, 0x5EED);
+    size_t bytes = 0;
+
+    for (long k = 0; k < count; k++) {
+        Replay *r = replay_begin((uint64_t)k + 1, (uint32_t)(k % 1000) + 1);
+        GameState g[2];
+        bool oom = !r;
+        for (int seat = 0; seat < 2 && !oom; seat++) {
+            ReplayEvent ev = { .type = REPLAY_SEED, .seat = seat, .seed = seed + (uint64_t)k, .stream = seat };
+            game_init_seeded(&g[seat], ev.seed, (uint64_t)seat);
+            oom |= replay_append(&r, &ev) < 0;
+        }
+        while (!oom && !(g[0].game_over && g[1].game_over)) {
+            int seat = (int)rng_below(&rng, 2);
+            ReplayEvent ev = { .type = REPLAY_MOVE, .seat = seat, .dir = (Direction)rng_below(&rng, 4) };
+            if (g[seat].game_over) continue;
+            ev.attacks = game_play_move(&g[seat], &g[1 - seat], ev.dir);
+            oom |= replay_append(&r, &ev) < 0;
+            if (ev.attacks > 0) {
+                ev.type = REPLAY_ATTACK;
+                oom |= replay_append(&r, &ev) < 0;
+            }
+        }
+        if (oom) {
+            fprintf(stderr, "메모리 할당 실패\n");
+            close(fd);
+            return 1;
+        }
+
+        ReplayEvent end = { .type = REPLAY_END, .reason = REPLAY_FINISHED, .winner = -1,
+                            .scores = { g[0].score, g[1].score },
+                            .boards = { bb_from_array(g[0].board), bb_from_array(g[1].board) } };
+        if (g[0].score != g[1].score) end.winner = g[0].score > g[1].score ? 0 : 1;
+        if (every > 0 && (k + 1) % every == 0) end.scores[1] += 4;
+        if (replay_append(&r, &end) < 0) oom = true;
+
+        replay_seal(r);
+        size_t len = r->len;
+        bool ok = !oom && write(fd, r->data, len) == (ssize_t)len;
+        free(r);
+        if (!ok) {
+            perror(path);
+            close(fd);
+            return 1;
+        }
+        bytes += len;
+    }
+    close(fd);
+    printf("경기 %ld개 기록, %.1f MB -> %s\n", count, (double)bytes / 1e6, path);
+    return 0;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage : %s [-t threads] [-q] file... ('-' = stdin)\n", prog);
+    fprintf(stderr, "        %s -g matches [-s seed] [-x every] out_file\n", prog);
+    exit(1);
+}
+
+int main(int argc, char *argv[]) {
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    bool quiet = false;
+    long gen_count = 0, tamper_every = 0;
+    uint64_t seed = 2048;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "t:qg:s:x:")) != -1) {
+        switch (opt) {
+            case 't': threads = atoi(optarg); break;
+            case 'q': quiet = true; break;
+            case 'g': gen_count = atol(optarg); break;
+            case 's': seed = strtoull(optarg, NULL, 0); break;
+            case 'x': tamper_every = atol(optarg); break;
+            default: usage(argv[0]);
+        }
+    }
+    if (optind >= argc) usage(argv[0]);
+    if (threads < 1) threads = 1;
+
+    bb_init();
+    if (gen_count > 0) return generate(argv[optind], gen_count, seed, tamper_every);
+
+    // 읽는 쪽이 두 개(채우는 중, 다음)를 쥐고, 스레드마다 검증 중 하나와 대기 하나
+    int chunks = threads * 2 + 2;
+    ChunkQueue q = { .lock = PTHREAD_MUTEX_INITIALIZER, .work_cv = PTHREAD_COND_INITIALIZER, .free_cv = PTHREAD_COND_INITIALIZER };
+    for (int i = 0; i < chunks; i++) {
+        Chunk *c = malloc(sizeof(Chunk) + CHUNK_SIZE);
+        if (!c) {
+            fprintf(stderr, "메모리 할당 실패\n");
+            return 1;
+        }
+        c->next = q.free_list;
+        q.free_list = c;
+    }
+    VerifyWorker *workers = aligned_alloc(64, sizeof(VerifyWorker) * (size_t)threads);
+    pthread_t *tids = calloc((size_t)threads, sizeof(pthread_t));
+    if (!workers || !tids) {
+        fprintf(stderr, "메모리 할당 실패\n");
+        return 1;
+    }
+
+    printf("파일 %d개, 스레드 %d개, 읽기 덩어리 %d MB x %d개 (메모리 상한 %d MB)\n", argc - optind, threads,
+           CHUNK_SIZE >> 20, chunks, (CHUNK_SIZE >> 20) * chunks);
+
+    double t0 = now_sec();
+    for (int i = 0; i < threads; i++) {
+        memset(&workers[i], 0, sizeof(VerifyWorker));
+        workers[i].id = i;
+        workers[i].q = &q;
+        workers[i].quiet = quiet;
+        if (pthread_create(&tids[i], NULL, worker_main, &workers[i]) != 0) {
+            fprintf(stderr, "pthread_create 실패\n");
+            return 1;
+        }
+    }
+
+    int read_errors = 0;
+    for (int i = optind; i < argc; i++) read_errors += feed_file(&q, argv[i]) < 0;
+    pthread_mutex_lock(&q.lock);
+    q.done = true;
+    pthread_cond_broadcast(&q.work_cv);
+    pthread_mutex_unlock(&q.lock);
+    for (int i = 0; i < threads; i++) pthread_join(tids[i], NULL);
+    double elapsed = now_sec() - t0;
+
+    VerifyStats total;
+    memset(&total, 0, sizeof(total));
+    printf("\n[스레드별]\n");
+    printf("  %3s %10s %12s %8s %12s %12s %8s\n", "T", "matches", "moves", "busy%", "matches/s", "moves/s", "MB/s");
+    for (int i = 0; i < threads; i++) {
+        VerifyStats *s = &workers[i].stats;
+        double busy = s->busy > 0 ? s->busy : 1e-9;
+        printf("  %3d %10ld %12ld %7.1f%% %12.0f %12.0f %8.1f\n", i, s->matches, s->moves,
+               100.0 * s->busy / elapsed, (double)s->matches / busy, (double)s->moves / busy, (double)s->bytes / busy / 1e6);
+        total.matches += s->matches;
+        total.moves += s->moves;
+        total.bytes += s->bytes;
+        total.flagged += s->flagged;
+        total.corrupt += s->corrupt;
+        for (int v = 0; v <= REPLAY_BAD_RESULT; v++) total.verdicts[v] += s->verdicts[v];
+    }
+
+    printf("\n[전체]\n");
+    printf("  경과 시간     %.3f s\n", elapsed);
+    printf("  경기          %ld (%.1f MB)\n", total.matches, (double)total.bytes / 1e6);
+    printf("  matches/s     %.0f (시간당 %.1f만)\n", (double)total.matches / elapsed, (double)total.matches / elapsed * 3600 / 1e4);
+    printf("  moves/s       %.0f\n", (double)total.moves / elapsed);
+    printf("  불일치        %ld", total.flagged);
+    for (int v = REPLAY_BAD_FORMAT; v <= REPLAY_BAD_RESULT; v++) {
+        if (total.verdicts[v]) printf(" (%s %ld)", replay_verdict_name((ReplayVerdict)v), total.verdicts[v]);
+    }
+    printf("\n  깨진 덩어리   %ld\n", total.corrupt);
+
+    free(tids);
+    free(workers);
+    while (q.free_list) {
+        Chunk *c = q.free_list;
+        q.free_list = c->next;
+        free(c);
+    }
+    if (read_errors || total.corrupt) return 1;
+    return total.flagged ? 2 : 0;
+}
@@ -0,0 +1,35 @@
+#define _DEFAULT_SOURCE
+#include "rng.h"
+#include <time.h>       // clock_gettime()
+#include <sys/random.h> // getrandom()
+
+void rng_seed(Rng *rng, uint64_t seed, uint64_t stream) {
+    // PCG 권장 초기화 순서
+    rng->state = 0;
+    rng->inc = (stream << 1u) | 1u;
+    rng_next(rng);
+    rng->state += seed;
+    rng_next(rng);
+}
+
+// splitmix64: 비슷한 입력도 전혀 다른 64비트 값으로 섞음
+static uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+uint64_t rng_entropy_seed(void) {
+    uint64_t seed;
+    if (getrandom(&seed, sizeof(seed), GRND_NONBLOCK) == (ssize_t)sizeof(seed)) {
+        return seed;
+    }
+
+    // getrandom 실패 시: 나노초 시각 + 호출마다 증가하는 카운터
+    static _Atomic uint64_t counter = 0;
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return mix64((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec) ^
+           mix64(counter++);
+}
@@ -0,0 +1,165 @@
+#define _DEFAULT_SOURCE
+#include "room.h"
+#include "lockstep.h"
+#include "stats.h"
+#include <stdlib.h> // calloc(), free()
+#include <pthread.h>
+
+// 매칭 대기열 (한 명이 기다리는 방, 먼저 온 순서), 방 수 통계
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static Room *queue_head, *queue_tail;
+static Room *all_head;
+static int live_rooms, waiting_rooms;
+static int next_room_id = 1;
+
+// 대기열 잠금을 잡고 기다린 시간을 부른 스레드의 통계에 기록
+static void queue_lock_take(void) {
+    uint64_t t0 = stats_now();
+    pthread_mutex_lock(&queue_lock);
+    stats_since(STATS_LOCK_WAIT, t0);
+}
+
+static void queue_push(Room *room) {
+    room->prev = queue_tail;
+    room->next = NULL;
+    if (queue_tail) queue_tail->next = room;
+    else queue_head = room;
+    queue_tail = room;
+    room->queued = true;
+    waiting_rooms++;
+}
+
+static void queue_remove(Room *room) {
+    if (!room->queued) return;
+    if (room->prev) room->prev->next = room->next;
+    else queue_head = room->next;
+    if (room->next) room->next->prev = room->prev;
+    else queue_tail = room->prev;
+    room->prev = room->next = NULL;
+    room->queued = false;
+    waiting_rooms--;
+}
+
+static void all_remove(Room *room) {
+    if (room->all_prev) room->all_prev->all_next = room->all_next;
+    else all_head = room->all_next;
+    if (room->all_next) room->all_next->all_prev = room->all_prev;
+    live_rooms--;
+}
+
+Room *room_match(EventLoop *new_room_loop) {
+    queue_lock_take();
+    Room *room = queue_head;
+    if (room) {
+        queue_remove(room);
+    } else {
+        room = calloc(1, sizeof(Room));
+        if (!room) {
+            pthread_mutex_unlock(&queue_lock);
+            return NULL;
+        }
+        room->id = next_room_id++;
+        room->loop = new_room_loop;
+        room->all_next = all_head;
+        if (all_head) all_head->all_prev = room;
+        all_head = room;
+        live_rooms++;
+    }
+
+    // 아직 한 명이면 상대를 기다림
+    room->members++;
+    if (room->members < ROOM_SEATS) queue_push(room);
+    pthread_mutex_unlock(&queue_lock);
+    return room;
+}
+
+bool room_claim(Room *room) {
+    queue_lock_take();
+    bool ok = room->members < ROOM_SEATS;
+    if (ok) {
+        queue_remove(room);
+        room->members++;
+    }
+    pthread_mutex_unlock(&queue_lock);
+    return ok;
+}
+
+int room_sit(Room *room, Client *c) {
+    int seat = room->seats[0] ? 1 : 0;
+    room->seats[seat] = c;
+    room->players++;
+    // 시드는 서버가 정하고 록스텝 클라이언트에게 그대로 알려 줌 (자리 번호가 난수 스트림)
+    room->seeds[seat] = rng_entropy_seed();
+    game_init_seeded(&room->games[seat], room->seeds[seat], (uint64_t)seat);
+    room->fresh[seat] = true;
+    return seat;
+}
+
+int room_leave(Room *room, int seat) {
+    room->seats[seat] = NULL;
+    room->players--;
+
+    queue_lock_take();
+    int members = --room->members;
+    bool release = false;
+    if (members == 0) {
+        queue_remove(room);
+        if (room->watch_refs == 0) {
+            all_remove(room);
+            release = true;
+        }
+    } else if (!room->queued && members < ROOM_SEATS) {
+        // 남은 사람은 보드를 유지한 채 새 상대를 기다림
+        queue_push(room);
+    }
+    pthread_mutex_unlock(&queue_lock);
+
+    if (release) free(room);
+    return members;
+}
+
+Room *room_watch(int id) {
+    queue_lock_take();
+    // 새 방이 앞쪽에 있으므로 id 0은 처음 만나는 꽉 찬 방
+    Room *room = all_head;
+    while (room && (room->members == 0 || (id ? room->id != id : room->members < ROOM_SEATS))) {
+        room = room->all_next;
+    }
+    if (room) room->watch_refs++;
+    pthread_mutex_unlock(&queue_lock);
+    return room;
+}
+
+void room_unwatch(Room *room) {
+    queue_lock_take();
+    bool release = (--room->watch_refs == 0 && room->members == 0);
+    if (release) all_remove(room);
+    pthread_mutex_unlock(&queue_lock);
+    if (release) free(room);
+}
+
+int room_members(Room *room) {
+    queue_lock_take();
+    int n = room->members;
+    pthread_mutex_unlock(&queue_lock);
+    return n;
+}
+
+void room_compose_packet(const Room *room, int seat, S2C_Packet *pkt) {
+    int opp = (seat + 1) % ROOM_SEATS;
+    lockstep_compose_packet(&room->games[seat], &room->games[opp], room->seats[opp] != NULL, pkt);
+}
+
+int room_count(void) {
+    queue_lock_take();
+    int n = live_rooms;
+    pthread_mutex_unlock(&queue_lock);
+    return n;
+}
+
+int room_waiting_count(void) {
+    queue_lock_take();
+    int n = waiting_rooms;
+    pthread_mutex_unlock(&queue_lock);
+    return n;
+}
@@ -0,0 +1,293 @@
+// 방 수에 따른 이동 지연 벤치마크: 실행 중인 서버에 접속해서 방을 활성 방 수부터 4배씩 늘려 가며
+// 고정된 수의 방(활성 방)에서만 이동을 보내고 "이동 전송 -> 내 갱신 패킷 수신" 왕복 시간을 잼
+// 나머지 방은 접속만 해 둔 채 가만히 있으므로, 방끼리 잠금을 다투지 않는다면 방 수와 무관하게 지연이 일정해야 함
+// 사용법: ./bin/room_bench [-h IP] [-p 포트] [-r 최대 방 수=4096] [-a 활성 방 수=16] [-n 방당 이동 수=200] [-l] [-v 버전]
+// (빈 서버에 대고 실행, 접속 순서대로 두 명씩 같은 방에 앉는다고 가정)
+// 기본은 압축 형식(wire.h), -l이면 예전 구조체 형식으로 비교 (서버가 hello를 기다리느라 접속마다 0.1초씩 걸리므로 -r을 작게)
+// -v로 요청할 압축 형식 버전을 고름 (기본은 최신 = 록스텝 사건, 4 이하면 상태 프레임)
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>         // clock_gettime()
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <netinet/tcp.h>  // TCP_NODELAY
+
+#include "protocol.h"
+#include "wire.h"
+#include "recv_buf.h"
+
+typedef struct {
+    int mover;      // 이동을 보내는 쪽 소켓 (방에 먼저 들어간 사람)
+    int partner;    // 상대 소켓 (갱신 패킷만 받아서 버림)
+    uint64_t sent_ns;
+    int moves;
+    WireStream mover_rx, partner_rx; // 델타 기준 상태
+    RecvBuf mover_buf, partner_buf;  // 받아 두고 아직 꺼내지 않은 바이트
+} BenchRoom;
+
+#define BENCH_RECV_BUF 512     // 연결마다 받아 두는 버퍼 (예전 구조체 패킷 2개)
+
+static bool compact = true;    // 압축 형식 사용 여부
+static int hello_version = WIRE_VERSION; // 요청할 압축 형식 버전
+static int wire_version;       // 서버가 고른 압축 형식 버전
+static uint64_t bytes_received; // 갱신 패킷으로 받은 바이트 수
+static bool mine_only;         // 마지막 록스텝 사건이 건너뜀 (게임에 반영되지 않은 이동이라 상대에게는 가지 않음)
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int connect_to(const struct sockaddr_in *addr, RecvBuf *rb) {
+    int sock = socket(PF_INET, SOCK_STREAM, 0);
+    if (sock < 0) return -1;
+    int one = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(sock, (const struct sockaddr *)addr, sizeof(*addr)) < 0) {
+        close(sock);
+        return -1;
+    }
+    if (compact) {
+        // hello를 보내고 서버가 고른 버전을 받음
+        uint8_t hello[WIRE_HELLO_SIZE];
+        wire_hello(hello, hello_version);
+        bool ok = write(sock, hello, sizeof(hello)) == (ssize_t)sizeof(hello);
+        while (ok && rb->len < sizeof(hello)) ok = recv_buf_fill(rb, sock) > 0;
+        if (ok) {
+            recv_buf_peek(rb, hello, sizeof(hello));
+            recv_buf_consume(rb, sizeof(hello));
+        }
+        if (!ok || (wire_version = wire_parse_hello(hello)) < 1) {
+            fprintf(stderr, "서버가 압축 형식을 지원하지 않음 (-l로 실행)\n");
+            close(sock);
+            return -1;
+        }
+    }
+    return sock;
+}
+
+// 록스텝 사건 하나 받기
+static int recv_event(int sock, RecvBuf *rb, LockEvent *ev) {
+    for (;;) {
+        uint8_t buf[WIRE_MAX_LOCK];
+        size_t avail = recv_buf_peek(rb, buf, sizeof(buf));
+        int ret = wire_decode_lock(buf, avail, ev);
+        if (ret < 0) return -1;
+        if (ret > 0) {
+            recv_buf_consume(rb, (size_t)ret);
+            bytes_received += (uint64_t)ret;
+            return 1;
+        }
+        if (recv_buf_fill(rb, sock) <= 0) return -1;
+    }
+}
+
+// 갱신 패킷 하나 받기 (받아 둔 바이트에 완성된 패킷이 없을 때만 소켓에서 읽음)
+// 록스텝이면 사건 하나를 갱신 하나로 셈 (pkt는 채우지 않음)
+static int recv_packet(int sock, RecvBuf *rb, WireStream *rx, S2C_Packet *pkt) {
+    if (compact && wire_version >= WIRE_LOCKSTEP_VERSION) {
+        LockEvent ev;
+        int ret = recv_event(sock, rb, &ev);
+        mine_only = ret > 0 && ev.type == LOCK_SKIP;
+        return ret;
+    }
+    for (;;) {
+        if (!compact) {
+            if (rb->len >= sizeof(*pkt)) {
+                recv_buf_peek(rb, pkt, sizeof(*pkt));
+                recv_buf_consume(rb, sizeof(*pkt));
+                bytes_received += sizeof(*pkt);
+                return 1;
+            }
+        } else {
+            uint8_t buf[WIRE_MAX_PACKET];
+            size_t avail = recv_buf_peek(rb, buf, sizeof(buf));
+            if (avail > 0 && buf[0] + 1 > WIRE_MAX_PACKET) return -1;
+            if (avail > 0 && avail >= (size_t)buf[0] + 1) {
+                size_t len = (size_t)buf[0] + 1;
+                recv_buf_consume(rb, len);
+                bytes_received += len;
+                if (wire_version >= 2) return wire_decode_stream(rx, buf, len, pkt);
+                return wire_decode_packet(buf, len, pkt);
+            }
+        }
+        if (recv_buf_fill(rb, sock) <= 0) return -1;
+    }
+}
+
+// 두 명을 차례로 접속시켜 방 하나를 채우고 시작 패킷까지 받음
+static int open_room(const struct sockaddr_in *addr, BenchRoom *room) {
+    S2C_Packet pkt;
+    wire_stream_init(&room->mover_rx);
+    wire_stream_init(&room->partner_rx);
+    if (recv_buf_init(&room->mover_buf, BENCH_RECV_BUF) < 0 || recv_buf_init(&room->partner_buf, BENCH_RECV_BUF) < 0) return -1;
+    room->mover = connect_to(addr, &room->mover_buf);
+    if (room->mover < 0 || recv_packet(room->mover, &room->mover_buf, &room->mover_rx, &pkt) <= 0) return -1;
+    room->partner = connect_to(addr, &room->partner_buf);
+    if (room->partner < 0 || recv_packet(room->partner, &room->partner_buf, &room->partner_rx, &pkt) <= 0) return -1;
+
+    bool seated;
+    if (compact && wire_version >= WIRE_LOCKSTEP_VERSION) {
+        // 록스텝: 나중에 앉은 쪽은 내 시드 다음에 상대 상태를, 먼저 앉은 쪽은 상대 시드를 받음
+        LockEvent ev;
+        if (recv_event(room->partner, &room->partner_buf, &ev) <= 0) return -1;
+        seated = ev.type == LOCK_STATE;
+        if (recv_event(room->mover, &room->mover_buf, &ev) <= 0) return -1;
+        seated = seated && ev.type == LOCK_SEED && ev.who == 1;
+    } else {
+        if (recv_packet(room->mover, &room->mover_buf, &room->mover_rx, &pkt) <= 0) return -1;
+        seated = pkt.game_status != GAME_WAITING;
+    }
+    if (!seated) {
+        fprintf(stderr, "두 연결이 같은 방에 앉지 않음 (빈 서버에서 실행해야 함)\n");
+        return -1;
+    }
+    return 0;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static int send_move(BenchRoom *r) {
+    C2S_Packet req = { .action = (ClientAction)(r->moves % 4) };
+    r->sent_ns = now_ns();
+    if (compact) {
+        uint8_t buf[WIRE_MAX_REQUEST];
+        size_t len = wire_encode_request(buf, wire_version, wire_encode_action(req.action), r->moves & 0xFFFF);
+        return write(r->mover, buf, len) == (ssize_t)len ? 0 : -1;
+    }
+    return write(r->mover, &req, sizeof(req)) == (ssize_t)sizeof(req) ? 0 : -1;
+}
+
+// 활성 방마다 이동 하나씩을 계속 보내 두고, 내 갱신이 도착하는 대로 지연을 기록하고 다음 이동을 보냄
+static int run_active(BenchRoom *active, int count, int moves, uint64_t *lat, double *elapsed) {
+    int epfd = epoll_create1(0);
+    if (epfd < 0) return -1;
+    for (int i = 0; i < count; i++) {
+        struct epoll_event ev = { .events = EPOLLIN, .data.u32 = (uint32_t)i };
+        epoll_ctl(epfd, EPOLL_CTL_ADD, active[i].mover, &ev);
+        active[i].moves = 0;
+    }
+
+    int done = 0, n_lat = 0;
+    uint64_t t0 = now_ns();
+    for (int i = 0; i < count; i++) {
+        if (send_move(&active[i]) < 0) return -1;
+    }
+
+    struct epoll_event events[64];
+    while (done < count) {
+        int n = epoll_wait(epfd, events, 64, 5000);
+        if (n <= 0) {
+            fprintf(stderr, "서버 응답 없음\n");
+            close(epfd);
+            return -1;
+        }
+        for (int k = 0; k < n; k++) {
+            BenchRoom *r = &active[events[k].data.u32];
+            S2C_Packet pkt;
+            if (recv_packet(r->mover, &r->mover_buf, &r->mover_rx, &pkt) <= 0) return -1;
+            lat[n_lat++] = now_ns() - r->sent_ns;
+            // 상대도 같은 이동의 갱신을 받으므로 비워 둠
+            if (!mine_only && recv_packet(r->partner, &r->partner_buf, &r->partner_rx, &pkt) <= 0) return -1;
+
+            if (++r->moves == moves) {
+                done++;
+                epoll_ctl(epfd, EPOLL_CTL_DEL, r->mover, NULL);
+            } else if (send_move(r) < 0) {
+                return -1;
+            }
+        }
+    }
+    *elapsed = (double)(now_ns() - t0) * 1e-9;
+    close(epfd);
+    return n_lat;
+}
+
+int main(int argc, char *argv[]) {
+    const char *ip = "127.0.0.1";
+    int port = 8080, max_rooms = 4096, active_rooms = 16, moves = 200;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "h:p:r:a:n:lv:")) != -1) {
+        switch (opt) {
+            case 'h': ip = optarg; break;
+            case 'p': port = atoi(optarg); break;
+            case 'r': max_rooms = atoi(optarg); break;
+            case 'a': active_rooms = atoi(optarg); break;
+            case 'n': moves = atoi(optarg); break;
+            case 'l': compact = false; break;
+            case 'v': hello_version = atoi(optarg); break;
+            default:
+                fprintf(stderr, "Usage : %s [-h IP] [-p port] [-r max_rooms] [-a active_rooms] [-n moves] [-l] [-v version]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (active_rooms < 1) active_rooms = 1;
+    if (max_rooms < active_rooms) max_rooms = active_rooms;
+    if (moves < 1) moves = 1;
+
+    // 방 하나에 소켓 두 개
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = inet_addr(ip);
+    addr.sin_port = htons(port);
+
+    BenchRoom *rooms = calloc((size_t)max_rooms, sizeof(BenchRoom));
+    uint64_t *lat = malloc(sizeof(uint64_t) * (size_t)active_rooms * (size_t)moves);
+    if (!rooms || !lat) return 1;
+
+    printf("활성 방 %d개 x 방당 이동 %d번, 서버 %s:%d, %s 형식\n", active_rooms, moves, ip, port,
+           !compact ? "구조체" : hello_version >= WIRE_LOCKSTEP_VERSION ? "록스텝 사건" : "압축");
+    printf("%10s %12s %10s %10s %10s %10s\n", "rooms", "moves/s", "p50 us", "p99 us", "max us", "B/update");
+
+    int open_rooms = 0;
+    for (int target = active_rooms; ; target *= 4) {
+        if (target > max_rooms) target = max_rooms;
+        // 앞쪽 방들이 활성 방이고 나머지는 가만히 있는 방
+        while (open_rooms < target) {
+            if (open_room(&addr, &rooms[open_rooms]) < 0) {
+                fprintf(stderr, "방 %d 접속 실패\n", open_rooms + 1);
+                return 1;
+            }
+            open_rooms++;
+        }
+
+        double elapsed = 0;
+        bytes_received = 0;
+        int n = run_active(rooms, active_rooms, moves, lat, &elapsed);
+        if (n < 0) return 1;
+        qsort(lat, (size_t)n, sizeof(uint64_t), cmp_u64);
+        // 이동 하나에 갱신 두 개 (나, 상대), 록스텝에서 게임 오버 뒤의 이동은 하나
+        printf("%10d %12.0f %10.1f %10.1f %10.1f %10.1f\n", open_rooms, (double)n / elapsed,
+               (double)lat[n / 2] * 1e-3, (double)lat[(size_t)n * 99 / 100] * 1e-3,
+               (double)lat[n - 1] * 1e-3, (double)bytes_received / (2.0 * n));
+
+        if (target == max_rooms) break;
+    }
+
+    for (int i = 0; i < open_rooms; i++) {
+        close(rooms[i].mover);
+        close(rooms[i].partner);
+        recv_buf_free(&rooms[i].mover_buf);
+        recv_buf_free(&rooms[i].partner_buf);
+    }
+    free(rooms);
+    free(lat);
+    return 0;
+}
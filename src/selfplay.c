@@ -0,0 +1,296 @@
+// 헤드리스 셀프플레이 시뮬레이터: 화면/네트워크 없이 완전한 게임 M개를 스레드 T개로 끝까지 진행하고
+// 처리량(초당 게임/이동 수), 점수와 최대 타일 분포, 공격 발생 빈도(ATTACK_THRESHOLD점 이상 이동)를 출력
+// game_logic.c 성능 측정과 공격 규칙 밸런스 확인의 기준 도구
+// 사용법: ./bin/selfplay [-n 게임 수] [-t 스레드 수] [-p random|greedy|ai] [-s 시드] [-d AI 깊이] [-v]
+//   -v: 1:1 대전 모드, 게임 두 개씩 짝지어 번갈아 두고 공격을 서버와 같은 규칙으로 주고받음
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>       // clock_gettime()
+#include <unistd.h>     // sysconf(), getopt()
+#include <pthread.h>
+#include <stdatomic.h>
+#include "game.h"
+#include "bitboard.h"
+#include "ai.h"
+
+typedef enum {
+    POLICY_RANDOM,  // 무작위 방향
+    POLICY_GREEDY,  // 이번 이동 점수가 가장 큰 방향 (같으면 빈칸이 많이 남는 쪽)
+    POLICY_AI       // Expectimax (ai.c)
+} Policy;
+
+static const char *policy_names[] = {"random", "greedy", "ai"};
+
+typedef struct {
+    int games;
+    int threads;
+    Policy policy;
+    uint64_t seed;
+    int ai_depth;
+    bool versus;
+} SimConfig;
+
+// 스레드별 집계 (다른 스레드와 캐시 라인을 나눠 쓰지 않도록 정렬)
+typedef struct {
+    long games;
+    long moves;             // 보드가 실제로 바뀐 이동 수
+    long attack_moves;      // ATTACK_THRESHOLD점 이상 얻은 이동 수
+    long attack_tiles;      // 보낸 방해 타일 수
+    long max_tile[BB_MAX_EXP + 1]; // 최대 타일 지수별 게임 수
+} __attribute__((aligned(64))) SimStats;
+
+typedef struct {
+    const SimConfig *config;
+    int id;
+    atomic_int *next;       // 다음에 가져갈 작업 번호 (게임 또는 대전)
+    int *scores;            // [games] 게임별 최종 점수 (게임 번호 자리에 기록)
+    SimStats stats;
+} SimWorker;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// 정책으로 다음 이동 선택, 움직일 수 있는 방향이 없으면 false
+static bool choose_move(const SimConfig *config, AiSearch *ai, Rng *rng,
+                        const GameState *g, Direction *dir) {
+    Board b = bb_from_array(g->board);
+
+    if (config->policy == POLICY_AI) {
+        AiResult r = ai_search(ai, b);
+        *dir = r.move;
+        return r.valid;
+    }
+
+    Board out[4];
+    int score[4];
+    bb_move_all(b, out, score);
+
+    if (config->policy == POLICY_RANDOM) {
+        // 움직이는 방향 중에서 고름 (막힌 방향을 계속 눌러 시간을 버리지 않도록)
+        int valid[4], n = 0;
+        for (int d = 0; d < 4; d++) {
+            if (out[d] != b) valid[n++] = d;
+        }
+        if (n == 0) return false;
+        *dir = (Direction)valid[rng_below(rng, (uint32_t)n)];
+        return true;
+    }
+
+    int best = -1, best_score = -1, best_empty = -1;
+    for (int d = 0; d < 4; d++) {
+        if (out[d] == b) continue;
+        int empty = bb_count_empty(out[d]);
+        if (score[d] > best_score || (score[d] == best_score && empty > best_empty)) {
+            best = d;
+            best_score = score[d];
+            best_empty = empty;
+        }
+    }
+    if (best < 0) return false;
+    *dir = (Direction)best;
+    return true;
+}
+
+// 한 턴 진행 (서버, 록스텝 클라이언트와 같은 game_play_move), 게임이 끝났거나 움직일 수 없으면 false
+static bool play_turn(SimWorker *w, AiSearch *ai, Rng *rng, GameState *me, GameState *opp) {
+    if (me->game_over) return false;
+
+    Direction dir;
+    if (!choose_move(w->config, ai, rng, me, &dir)) {
+        // 어느 쪽으로도 움직일 수 없으면 게임 오버
+        me->game_over = true;
+        return false;
+    }
+
+    // 혼자 두는 게임은 버리는 대기열로 보냄 (공격자 난수 소비는 서버와 같게)
+    GameState sink = {0};
+    int attacks = game_play_move(me, opp ? opp : &sink, dir);
+    if (me->moved) w->stats.moves++;
+    if (attacks > 0) {
+        w->stats.attack_moves++;
+        w->stats.attack_tiles += attacks;
+    }
+    return true;
+}
+
+static void record_game(SimWorker *w, int idx, const GameState *g) {
+    w->scores[idx] = g->score;
+    w->stats.games++;
+    int top = bb_max_tile(bb_from_array(g->board));
+    w->stats.max_tile[top ? __builtin_ctz((unsigned)top) : 0]++;
+}
+
+static void *worker_main(void *arg) {
+    SimWorker *w = arg;
+    const SimConfig *config = w->config;
+
+    AiSearch *ai = NULL;
+    if (config->policy == POLICY_AI) {
+        AiConfig ai_config;
+        ai_default_config(&ai_config);
+        ai_config.depth = config->ai_depth;
+        ai = ai_create(&ai_config);
+        if (!ai) {
+            fprintf(stderr, "[T%d] ai_create 실패\n", w->id);
+            return NULL;
+        }
+    }
+
+    // 작업 번호마다 시드를 정하므로 결과는 스레드 수와 무관하게 같음
+    int per_job = config->versus ? 2 : 1;
+    int jobs = (config->games + per_job - 1) / per_job;
+    for (;;) {
+        int job = atomic_fetch_add(w->next, 1);
+        if (job >= jobs) break;
+
+        Rng policy_rng;
+        rng_seed(&policy_rng, config->seed ^ 0x5DEECE66DULL, (uint64_t)job);
+
+        if (!config->versus) {
+            GameState g;
+            game_init_seeded(&g, config->seed, (uint64_t)job);
+            while (play_turn(w, ai, &policy_rng, &g, NULL)) {}
+            record_game(w, job, &g);
+            continue;
+        }
+
+        GameState g[2];
+        game_init_seeded(&g[0], config->seed, (uint64_t)job * 2);
+        game_init_seeded(&g[1], config->seed, (uint64_t)job * 2 + 1);
+        while (!g[0].game_over || !g[1].game_over) {
+            play_turn(w, ai, &policy_rng, &g[0], &g[1]);
+            play_turn(w, ai, &policy_rng, &g[1], &g[0]);
+        }
+        record_game(w, job * 2, &g[0]);
+        record_game(w, job * 2 + 1, &g[1]);
+    }
+
+    ai_destroy(ai);
+    return NULL;
+}
+
+static int cmp_int(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage : %s [-n games] [-t threads] [-p random|greedy|ai] [-s seed] [-d ai_depth] [-v]\n", prog);
+    exit(1);
+}
+
+int main(int argc, char *argv[]) {
+    SimConfig config = {
+        .games = 10000,
+        .threads = (int)sysconf(_SC_NPROCESSORS_ONLN),
+        .policy = POLICY_GREEDY,
+        .seed = 2048,
+        .ai_depth = 2,
+        .versus = false,
+    };
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:t:p:s:d:v")) != -1) {
+        switch (opt) {
+            case 'n': config.games = atoi(optarg); break;
+            case 't': config.threads = atoi(optarg); break;
+            case 's': config.seed = strtoull(optarg, NULL, 0); break;
+            case 'd': config.ai_depth = atoi(optarg); break;
+            case 'v': config.versus = true; break;
+            case 'p':
+                if (strcmp(optarg, "random") == 0) config.policy = POLICY_RANDOM;
+                else if (strcmp(optarg, "greedy") == 0) config.policy = POLICY_GREEDY;
+                else if (strcmp(optarg, "ai") == 0) config.policy = POLICY_AI;
+                else usage(argv[0]);
+                break;
+            default: usage(argv[0]);
+        }
+    }
+    if (config.games < 1) config.games = 1;
+    // 대전은 두 게임씩 두므로 짝수로 올림 (두 게임의 이동과 공격을 모두 세므로 게임 수도 같이 맞춤)
+    bool rounded = config.versus && config.games % 2;
+    if (rounded) config.games++;
+    if (config.threads < 1) config.threads = 1;
+
+    bb_init();
+    int *scores = calloc((size_t)config.games, sizeof(int));
+    SimWorker *workers = aligned_alloc(64, sizeof(SimWorker) * (size_t)config.threads);
+    pthread_t *tids = calloc((size_t)config.threads, sizeof(pthread_t));
+    if (!scores || !workers || !tids) {
+        fprintf(stderr, "메모리 할당 실패\n");
+        return 1;
+    }
+
+    printf("게임 %d개%s, 스레드 %d개, 정책 %s%s, 시드 %llu, 커널 %s\n", config.games,
+           rounded ? " (대전이라 짝수로 올림)" : "", config.threads, policy_names[config.policy],
+           config.versus ? " (1:1 대전)" : "",
+           (unsigned long long)config.seed, bb_kernel_name(bb_get_kernel()));
+
+    atomic_int next = 0;
+    double t0 = now_sec();
+    for (int i = 0; i < config.threads; i++) {
+        memset(&workers[i], 0, sizeof(SimWorker));
+        workers[i].config = &config;
+        workers[i].id = i;
+        workers[i].next = &next;
+        workers[i].scores = scores;
+        if (pthread_create(&tids[i], NULL, worker_main, &workers[i]) != 0) {
+            fprintf(stderr, "pthread_create 실패\n");
+            return 1;
+        }
+    }
+    for (int i = 0; i < config.threads; i++) pthread_join(tids[i], NULL);
+    double elapsed = now_sec() - t0;
+
+    SimStats total;
+    memset(&total, 0, sizeof(total));
+    for (int i = 0; i < config.threads; i++) {
+        SimStats *s = &workers[i].stats;
+        total.games += s->games;
+        total.moves += s->moves;
+        total.attack_moves += s->attack_moves;
+        total.attack_tiles += s->attack_tiles;
+        for (int e = 0; e <= BB_MAX_EXP; e++) total.max_tile[e] += s->max_tile[e];
+    }
+    if (total.games == 0) return 1;
+
+    printf("\n[처리량]\n");
+    printf("  경과 시간     %.3f s\n", elapsed);
+    printf("  games/s       %.1f\n", (double)total.games / elapsed);
+    printf("  moves/s       %.0f\n", (double)total.moves / elapsed);
+    printf("  moves/game    %.1f\n", (double)total.moves / (double)total.games);
+
+    qsort(scores, (size_t)total.games, sizeof(int), cmp_int);
+    double sum = 0;
+    for (long i = 0; i < total.games; i++) sum += scores[i];
+    printf("\n[점수]\n");
+    printf("  %8s %8s %8s %8s %8s %8s %8s\n", "min", "p10", "p50", "p90", "p99", "max", "mean");
+    printf("  %8d %8d %8d %8d %8d %8d %8.0f\n", scores[0],
+           scores[total.games * 10 / 100], scores[total.games * 50 / 100],
+           scores[total.games * 90 / 100], scores[total.games * 99 / 100],
+           scores[total.games - 1], sum / (double)total.games);
+
+    printf("\n[최대 타일]\n");
+    for (int e = 0; e <= BB_MAX_EXP; e++) {
+        if (total.max_tile[e] == 0) continue;
+        printf("  %6d %10ld %6.2f%%\n", e ? 1 << e : 0, total.max_tile[e],
+               100.0 * (double)total.max_tile[e] / (double)total.games);
+    }
+
+    printf("\n[공격 (한 번 이동 %d점 이상)]\n", ATTACK_THRESHOLD);
+    printf("  발생 이동     %ld (이동의 %.3f%%)\n", total.attack_moves,
+           total.moves ? 100.0 * (double)total.attack_moves / (double)total.moves : 0.0);
+    printf("  게임당 발생   %.2f\n", (double)total.attack_moves / (double)total.games);
+    printf("  방해 타일     %ld (게임당 %.2f)\n", total.attack_tiles,
+           (double)total.attack_tiles / (double)total.games);
+
+    free(tids);
+    free(workers);
+    free(scores);
+    return 0;
+}
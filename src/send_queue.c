@@ -0,0 +1,131 @@
+#define _DEFAULT_SOURCE
+#include "send_queue.h"
+#include <stdlib.h>     // malloc(), realloc(), free()
+#include <string.h>     // memcpy()
+#include <errno.h>
+#include <sys/socket.h> // send(), sendmsg()
+#include <sys/uio.h>    // struct iovec
+
+#define MAX_IOV 64      // sendmsg 한 번에 넘기는 버퍼 수
+
+// ==========================================
+// [1] 공유 버퍼
+// ==========================================
+
+SharedBuf *shared_buf_new(const void *data, size_t len) {
+    SharedBuf *b = malloc(sizeof(SharedBuf) + len);
+    if (!b) return NULL;
+    b->refs = 1;
+    b->len = len;
+    memcpy(b->data, data, len);
+    return b;
+}
+
+SharedBuf *shared_buf_ref(SharedBuf *b) {
+    b->refs++;
+    return b;
+}
+
+void shared_buf_unref(SharedBuf *b) {
+    if (--b->refs == 0) free(b);
+}
+
+// ==========================================
+// [2] 전송 대기열
+// ==========================================
+
+void send_queue_init(SendQueue *q, size_t limit) {
+    q->bufs = NULL;
+    q->head = q->count = q->cap = 0;
+    q->offset = 0;
+    q->bytes = 0;
+    q->limit = limit;
+}
+
+void send_queue_free(SendQueue *q) {
+    for (int i = 0; i < q->count; i++) shared_buf_unref(q->bufs[(q->head + i) % q->cap]);
+    free(q->bufs);
+    send_queue_init(q, q->limit);
+}
+
+int send_queue_push(SendQueue *q, SharedBuf *b) {
+    if (q->limit && q->bytes + b->len > q->limit) return -1;
+    if (q->count == q->cap) {
+        // 원형 배열을 펴면서 두 배로
+        int cap = q->cap ? q->cap * 2 : 8;
+        SharedBuf **bufs = malloc(sizeof(SharedBuf *) * (size_t)cap);
+        if (!bufs) return -1;
+        for (int i = 0; i < q->count; i++) bufs[i] = q->bufs[(q->head + i) % q->cap];
+        free(q->bufs);
+        q->bufs = bufs;
+        q->head = 0;
+        q->cap = cap;
+    }
+    q->bufs[(q->head + q->count) % q->cap] = shared_buf_ref(b);
+    q->count++;
+    q->bytes += b->len;
+    return 0;
+}
+
+int send_queue_write(SendQueue *q, int fd, const void *data, size_t len) {
+    const uint8_t *p = data;
+    if (q->count == 0) {
+        ssize_t n;
+        do {
+            n = send(fd, p, len, MSG_NOSIGNAL);
+        } while (n < 0 && errno == EINTR);
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) return -1;
+            n = 0;
+        }
+        p += n;
+        len -= (size_t)n;
+        if (len == 0) return 1;
+    }
+
+    SharedBuf *b = shared_buf_new(p, len);
+    if (!b) return -1;
+    int ret = send_queue_push(q, b);
+    shared_buf_unref(b);
+    return ret < 0 ? -1 : 0;
+}
+
+int send_queue_flush(SendQueue *q, int fd) {
+    while (q->count > 0) {
+        struct iovec iov[MAX_IOV];
+        int n = q->count < MAX_IOV ? q->count : MAX_IOV;
+        for (int i = 0; i < n; i++) {
+            SharedBuf *b = q->bufs[(q->head + i) % q->cap];
+            size_t skip = (i == 0) ? q->offset : 0;
+            iov[i].iov_base = b->data + skip;
+            iov[i].iov_len = b->len - skip;
+        }
+
+        struct msghdr msg = { .msg_iov = iov, .msg_iovlen = (size_t)n };
+        ssize_t sent = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        q->bytes -= (size_t)sent;
+
+        // 다 보낸 버퍼는 참조를 놓고, 일부만 보낸 버퍼는 offset으로 기억
+        size_t left = (size_t)sent;
+        while (q->count > 0) {
+            SharedBuf *b = q->bufs[q->head];
+            size_t remain = b->len - q->offset;
+            if (left < remain) {
+                q->offset += left;
+                break;
+            }
+            left -= remain;
+            q->offset = 0;
+            q->head = (q->head + 1) % q->cap;
+            q->count--;
+            shared_buf_unref(b);
+        }
+        if (q->count > 0 && q->offset > 0) return 0; // 소켓 버퍼가 참
+    }
+    return 1;
+}
@@ -1,402 +1,1061 @@
+#define _DEFAULT_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h> // offsetof()
 #include <string.h>
 #include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <arpa/inet.h>
+#include <netinet/tcp.h> // TCP_NODELAY
 #include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
 #include <pthread.h>
-#include <sys/select.h>
 #include <signal.h>
 
 #include "protocol.h"
 #include "game.h"
+#include "bitboard.h"
+#include "event_loop.h"
+#include "room.h"
+#include "wire.h"
+#include "send_queue.h"
+#include "recv_buf.h"
+#include "replay_log.h"
+#include "ai.h"
+#include "bot_pool.h"
+#include "stats.h"
 
-#define MAX_CLNT 2
+#define IDLE_ATTACK_MS 5000 // 공격이 대기 중일 때 이 시간 동안 입력이 없으면 강제로 실행 (기본값)
+#define HELLO_WAIT_MS  100  // 접속 후 이 시간 안에 hello가 오지 않으면 예전 클라이언트(raw 형식)로 봄
+#define WATCH_VERSION  2    // 관전은 버전 2 (델타) 이상만
+#define SEND_HIGH_WATER (64 * 1024) // 연결마다 못 보내고 쌓아 둘 수 있는 최대 바이트 수, 넘으면 느린 연결로 보고 끊음
+#define SOCKET_SNDBUF   (32 * 1024) // 커널 송신 버퍼 (자동 조정에 맡기면 수 MB까지 커져서 느린 연결을 늦게 알아챔)
+#define RECV_BUF_SIZE   256         // 연결마다 받아 두는 버퍼 (요청은 길어야 8바이트, 몰아서 온 키 입력을 한 번에 받을 만큼)
+#define REPLAY_LOG_PATH "replay.log" // 경기 기록 파일 (기본값, "-"면 기록 안 함)
+#define REPLAY_MAX_PENDING (64 * 1024 * 1024) // 디스크에 아직 못 쓴 경기 기록의 상한, 넘으면 그 경기는 버림
+#define BOT_MOVE_MS     300 // 봇이 두는 간격 (기본값)
+#define BOT_CPU_PCT     25  // 방마다 봇이 탐색에 쓸 수 있는 CPU (코어 하나의 %, 기본값)
+#define BOT_QUEUE_PER_THREAD 4 // 봇 탐색 대기열 길이 = 탐색 스레드 수 x 이 값
+#define STATS_SOCKET_PATH "stats.sock" // 통계 JSON을 주는 유닉스 소켓 (기본값, "-"면 소켓 없음, SIGUSR1 덤프는 그대로)
+
+// hello와 예전 요청을 같은 4바이트로 읽어서 구분
+_Static_assert(WIRE_HELLO_SIZE == sizeof(C2S_Packet), "hello must be as long as a raw request");
+_Static_assert(WIRE_WATCH_SIZE <= WIRE_MAX_REQUEST, "request buffer must hold a watch hello");
+
+// 연결의 전송 형식 (접속 직후 협상)
+typedef enum {
+    FORMAT_PENDING,         // 아직 모름 (방에 들어가기 전)
+    FORMAT_RAW,             // S2C_Packet 구조체를 그대로 (예전 클라이언트)
+    FORMAT_COMPACT          // wire.h 압축 형식
+} WireFormat;
+
+// 접속한 클라이언트 하나 (소켓, 받는 중인 요청, 전송 대기열, 대기 공격 타이머)
+// 접속하면 먼저 아무 루프에서 형식을 협상하고, 플레이어는 방에 앉고 관전자는 방을 구경하러 방의 루프로 옮겨 감
+struct Client {
+    Watcher w;              // 소켓 감시 (w.fd = 소켓)
+    Room *room;             // 앉은 (관전하는) 방, 협상 중에는 NULL
+    int seat;               // 방 안의 자리 번호 (0, 1)
+    bool watching;          // 관전자
+    Client *watch_prev, *watch_next; // 방의 관전자 목록
+
+    WireFormat format;
+    int version;            // 압축 형식 버전 (2 이상이면 델타)
+    WireStream tx;          // 이 연결에 마지막으로 보낸 상태 (델타 기준)
+    int input_seq;          // 마지막으로 처리한 입력 번호 (버전 4, 보내는 상태에 붙여 클라이언트 예측을 맞춤), 없으면 -1
+    RecvBuf rx;             // 받아 두고 아직 처리하지 않은 요청 (한 번에 다 오지 않은 요청의 앞부분 포함)
+
+    SendQueue sq;           // 소켓 버퍼가 차서 아직 못 보낸 데이터 (관전 프레임은 모든 관전자가 같은 버퍼를 참조)
+    S2C_Packet pending;     // 대기열이 빌 때 보낼 최신 상태 (그 사이에 온 상태는 이것으로 합쳐짐)
+    bool has_pending;
+    bool closing;           // 대기열이 상한을 넘어서 끊는 중 (더는 보내지 않음)
+
+    Timer idle;             // 대기 공격 타이머 (공격이 대기 중일 때만 걸려 있음)
+    Timer hello;            // 형식 협상 대기 타이머
+    Timer bot;              // 사람: 혼자 기다린 지 bot_wait_ms가 지나면 봇을 앉힘, 봇: 다음 수 탐색 시작
+
+    // 봇 자리 (소켓 없이 앉아서 작업 풀이 고른 수를 사람과 같은 handle_action으로 둠)
+    bool is_bot;
+    bool thinking;          // 탐색 작업이 풀에 가 있음 (돌아올 때까지 해제하지 않음)
+    bool gone;              // 자리에서 나갔음 (탐색이 돌아오면 해제)
+    BotJob job;
+    uint64_t since_ns;      // 앉은 시각
+    uint64_t cpu_ns;        // 지금까지 탐색에 쓴 CPU 시간 (방마다 봇은 하나이므로 방의 봇 CPU)
+    long moves;
+};
 
 // 전역 변수
-int clnt_socks[MAX_CLNT];
-GameState game_states[MAX_CLNT];
-pthread_mutex_t mut;
 int serv_sock_global;
 
+// 이벤트 루프 (코어마다 하나), 방마다 루프 하나를 정해서 그 방의 두 연결을 모두 처리
+EventLoop **loops;
+int loop_count;
+int next_loop;              // 새 연결을 협상시킬 루프 (돌아가며, 새 방도 이 루프에 생김)
+uint64_t idle_attack_ms = IDLE_ATTACK_MS;
+ReplayLog *replay_log;      // 경기 기록기 (NULL이면 기록 안 함)
+_Atomic uint64_t next_match_id = 1;
+volatile sig_atomic_t stopping;
+BotPool *bot_pool;          // 봇 탐색 스레드 풀 (NULL이면 봇 없음)
+uint64_t bot_wait_ms;       // 혼자 이만큼 기다리면 봇을 앉힘 (0 = 봇 끔)
+uint64_t bot_move_ms = BOT_MOVE_MS;
+int bot_cpu_pct = BOT_CPU_PCT;
+
 // 함수 선언
-void *handle_client(void *arg);
-void compose_packet(int id, S2C_Packet *res_packet);
 void error_handling(const char *msg);
-// 패킷 전체 수신 보장 함수
-int recv_all(int sock, void *buffer, size_t len) {
-    size_t received = 0;
-    char *ptr = (char *)buffer;
-    while (received < len) {
-        int ret = read(sock, ptr + received, len - received);
-        if (ret <= 0) return ret;
-        received += ret;
-    }
-    return received;
+static void client_close(EventLoop *loop, Client *c);
+static void bot_move(EventLoop *loop, void *arg);
+
+void handle_sigint(int sig) {
+    (void)sig;
+    // accept를 깨워서 main이 끝난 경기 기록을 마저 쓰고 종료하게 함
+    stopping = 1;
+    shutdown(serv_sock_global, SHUT_RDWR);
 }
 
-int get_client_count() {
-    int count = 0;
-    for (int i = 0; i < MAX_CLNT; i++) {
-        if (clnt_socks[i] != -1) count++;
+// 통계 스레드가 표준 출력에 JSON을 한 줄 씀
+void handle_sigusr1(int sig) {
+    (void)sig;
+    stats_request_dump();
+}
+
+// ==========================================
+// [1] 논블로킹 전송
+// ==========================================
+
+// 소켓을 닫고 연결의 버퍼를 모두 해제 (루프에서는 먼저 loop_del)
+static void client_free(Client *c) {
+    stats_add(STATS_CLOSED, 1);
+    close(c->w.fd);
+    send_queue_free(&c->sq);
+    recv_buf_free(&c->rx);
+    free(c);
+}
+
+// 대기열이 상한을 넘은 연결은 소켓을 shutdown해 두고, 루프가 그 연결의 이벤트(EOF)를 받을 때 정리
+// (보내는 도중에 닫으면 방을 처리하던 쪽이 닫힌 연결을 건드리게 되므로)
+static void client_drop(Client *c) {
+    if (c->closing) return;
+    c->closing = true;
+    c->has_pending = false;
+    if (c->room && c->watching) printf("[Room %d] Spectator too slow, disconnecting.\n", c->room->id);
+    else if (c->room) printf("[Room %d][P%d] Too slow, disconnecting.\n", c->room->id, c->seat + 1);
+    shutdown(c->w.fd, SHUT_RDWR);
+}
+
+// 보낼 수 있는 만큼 바로 보내고 나머지는 대기열에 쌓아 EPOLLOUT 때 이어서 보냄
+static void client_send(EventLoop *loop, Client *c, const void *data, size_t len) {
+    if (c->closing) return;
+    bool was_empty = send_queue_empty(&c->sq);
+    uint64_t t0 = stats_now();
+    int ret = send_queue_write(&c->sq, c->w.fd, data, len);
+    stats_since(STATS_WRITE, t0);
+    stats_add(STATS_PACKETS_OUT, 1);
+    stats_add(STATS_BYTES_OUT, len);
+    if (ret < 0) client_drop(c);
+    else if (ret == 0 && was_empty) loop_mod(loop, &c->w, EPOLLIN | EPOLLOUT);
+}
+
+// 관전자에게 공유 프레임 전송 (복사 없이 참조만 대기열에 넣음)
+static void watcher_send(EventLoop *loop, Client *c, SharedBuf *b) {
+    if (c->closing) return;
+    bool idle = send_queue_empty(&c->sq);
+    if (send_queue_push(&c->sq, b) < 0) {
+        client_drop(c);
+        return;
+    }
+    stats_add(STATS_PACKETS_OUT, 1);
+    stats_add(STATS_BYTES_OUT, b->len);
+    // 이미 EPOLLOUT을 기다리는 중이면 그때 쌓인 프레임을 한꺼번에 보냄
+    if (idle) {
+        uint64_t t0 = stats_now();
+        int ret = send_queue_flush(&c->sq, c->w.fd);
+        stats_since(STATS_WRITE, t0);
+        if (ret < 0) client_drop(c);
+        else if (ret == 0) loop_mod(loop, &c->w, EPOLLIN | EPOLLOUT);
     }
-    return count;
 }
 
-void handle_sigint(int sig) {
-    (void)sig;
-    printf("\n[Server] Shutting down ...\n");
-    
-    // 서버 소켓 닫기 (포트 반납)
-    close(serv_sock_global);
-    
-    // 뮤텍스 파괴
-    pthread_mutex_destroy(&mut);
-    
-    printf("[Server] Bye!\n");
-    exit(0); // 프로그램 종료
+// 방의 현재 상태(1번 자리 기준)를 한 번만 인코딩해서 모든 관전자에게 전송, 관전자가 없으면 아무것도 안 함
+static void room_broadcast(EventLoop *loop, Room *room, bool keyframe) {
+    if (!room->watchers) return;
+
+    S2C_Packet pkt;
+    uint8_t buf[WIRE_MAX_PACKET];
+    room_compose_packet(room, 0, &pkt);
+    size_t len = wire_encode_stream(&room->watch_tx, &pkt, -1, buf, keyframe);
+
+    SharedBuf *b = shared_buf_new(buf, len);
+    if (!b) {
+        // 아무도 프레임을 받지 못했으므로 다음 프레임을 키프레임으로 해서 다시 맞춤
+        room->watch_tx.primed = false;
+        return;
+    }
+    for (Client *w = room->watchers; w; w = w->watch_next) watcher_send(loop, w, b);
+    shared_buf_unref(b);
 }
 
-int main(int argc, char *argv[]) {
-    int serv_sock, clnt_sock;
-    struct sockaddr_in serv_adr, clnt_adr;
-    socklen_t clnt_adr_sz;
-    pthread_t t_id;
-    
-    signal(SIGINT, handle_sigint);
+// 연결의 형식에 맞춰 패킷 전송
+// 앞의 패킷이 아직 대기열에 남아 있으면 쌓지 않고 최신 상태 하나로 합쳐 두었다가 대기열이 비면 보냄
+// (전체 상태라 중간 상태는 건너뛰어도 되고, 델타는 실제로 보낸 상태를 기준으로 그때 만듦)
+static void send_packet(EventLoop *loop, Client *c, const S2C_Packet *pkt) {
+    if (c->closing) return;
+    if (!send_queue_empty(&c->sq)) {
+        // 공격 받은 이벤트는 건너뛴 상태에 있었어도 알려 줌
+        bool hit = c->has_pending && c->pending.is_hit;
+        int hr = c->pending.highlight_r, hc = c->pending.highlight_c;
+        bool had_highlight = c->has_pending && hr >= 0;
+        c->pending = *pkt;
+        c->pending.is_hit |= hit;
+        if (pkt->highlight_r < 0 && had_highlight) {
+            c->pending.highlight_r = hr;
+            c->pending.highlight_c = hc;
+        }
+        c->has_pending = true;
+        return;
+    }
 
-    if (argc == 1) {
-        printf("Using default port 8080\n");
-        argv[1] = "8080";
-    } else if (argc != 2) {
-        printf("Usage : %s <port>\n", argv[0]);
-        exit(1);
+    if (c->format == FORMAT_COMPACT) {
+        uint8_t buf[WIRE_MAX_PACKET];
+        size_t len = (c->version >= 2) ? wire_encode_stream(&c->tx, pkt, c->input_seq, buf, false)
+                                       : wire_encode_packet(pkt, buf);
+        client_send(loop, c, buf, len);
+    } else if (c->format == FORMAT_RAW) {
+        client_send(loop, c, pkt, sizeof(*pkt));
     }
+}
 
+// EPOLLOUT: 쌓인 데이터를 보내고, 대기열이 비면 합쳐 둔 최신 상태를 보냄
+static void client_flush(EventLoop *loop, Client *c) {
+    if (c->closing) return;
+    uint64_t t0 = stats_now();
+    int ret = send_queue_flush(&c->sq, c->w.fd);
+    stats_since(STATS_WRITE, t0);
+    if (ret < 0) {
+        client_drop(c);
+        return;
+    }
+    if (ret == 0) return;
 
-    for(int i=0; i<MAX_CLNT; i++) clnt_socks[i] = -1;
-    pthread_mutex_init(&mut, NULL);
-    game_init(&game_states[0]);
-    game_init(&game_states[1]);
+    if (c->has_pending) {
+        c->has_pending = false;
+        send_packet(loop, c, &c->pending);
+        if (!send_queue_empty(&c->sq)) return; // send_packet이 EPOLLOUT을 유지함
+    }
+    loop_mod(loop, &c->w, EPOLLIN);
+}
 
-    serv_sock = socket(PF_INET, SOCK_STREAM, 0);
-    serv_sock_global = serv_sock;
-    if (serv_sock == -1) error_handling("socket() error");
+// 록스텝(버전 5) 연결은 상태 패킷 대신 사건을 받음
+static bool is_lockstep(const Client *c) {
+    return c->format == FORMAT_COMPACT && c->version >= WIRE_LOCKSTEP_VERSION;
+}
 
-    int opt = 1;
-    setsockopt(serv_sock, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+// actor 자리의 게임에 일어난 사건을 록스텝 연결 하나에 전송 (누구인지는 받는 쪽 기준으로)
+static void lock_send(EventLoop *loop, Client *c, LockEventType type, int actor, Direction dir) {
+    LockEvent ev = { .type = type, .who = (actor == c->seat) ? 0 : 1, .dir = dir };
+    if (type == LOCK_SEED) {
+        ev.seed = c->room->seeds[actor];
+        ev.stream = actor;
+    } else if (type == LOCK_STATE) {
+        ev.state = c->room->games[actor];
+    }
+    uint8_t buf[WIRE_MAX_LOCK];
+    client_send(loop, c, buf, wire_encode_lock(&ev, buf));
+}
 
-    memset(&serv_adr, 0, sizeof(serv_adr));
-    serv_adr.sin_family = AF_INET;
-    serv_adr.sin_addr.s_addr = htonl(INADDR_ANY);
-    serv_adr.sin_port = htons(atoi(argv[1]));
+// actor 자리에서 게임이 바뀌었음을 두 자리와 관전자에게 알림 (actor부터)
+// 록스텝 연결에는 사건 하나를, 나머지에는 상태 패킷을 만들어 보냄 (type이 0이면 상태 패킷만)
+// hit: 상대(actor가 아닌 쪽)가 이번에 공격받았는지
+static void room_notify(EventLoop *loop, Room *room, int actor, LockEventType type, Direction dir, bool hit) {
+    for (int i = 0; i < ROOM_SEATS; i++) {
+        int seat = (actor + i) % ROOM_SEATS;
+        Client *p = room->seats[seat];
+        if (!p || p->is_bot) continue;
+        if (is_lockstep(p)) {
+            if (type) lock_send(loop, p, type, actor, dir);
+            continue;
+        }
+        S2C_Packet pkt;
+        room_compose_packet(room, seat, &pkt);
+        if (seat != actor && hit) pkt.is_hit = true;
+        send_packet(loop, p, &pkt);
+    }
+    room_broadcast(loop, room, false);
+}
 
-    if (bind(serv_sock, (struct sockaddr *)&serv_adr, sizeof(serv_adr)) == -1)
-        error_handling("bind() error");
+// ==========================================
+// [2] 경기 기록
+// ==========================================
+// 사건은 방의 버퍼에 덧붙이기만 하고, 경기가 끝나면 버퍼를 기록 스레드에 넘김 (디스크는 기다리지 않음)
 
-    if (listen(serv_sock, 5) == -1)
-        error_handling("listen() error");
+// 기록 중인 경기를 끝 사건으로 닫아서 기록 스레드에 넘김 (기록 중이 아니면 아무것도 안 함)
+static void match_end(Room *room, ReplayReason reason, int seat) {
+    Replay *r = room->replay;
+    if (!r) return;
+    room->replay = NULL;
 
-    printf("Game Server Started on port %s...\n", argv[1]);
+    int s0 = room->games[0].score, s1 = room->games[1].score;
+    ReplayEvent ev = { .type = REPLAY_END, .seat = seat, .reason = reason, .winner = -1, .scores = { s0, s1 },
+                       .boards = { bb_from_array(room->games[0].board), bb_from_array(room->games[1].board) } };
+    // 무승부=패배 처리와 같게 동점이면 이긴 쪽 없음
+    if (reason == REPLAY_FINISHED && s0 != s1) ev.winner = (s0 > s1) ? 0 : 1;
+    if (replay_append(&r, &ev) < 0) {
+        free(r);
+        return;
+    }
+    replay_log_submit(replay_log, r);
+}
 
-    while (1) {
-        clnt_adr_sz = sizeof(clnt_adr);
-        clnt_sock = accept(serv_sock, (struct sockaddr *)&clnt_adr, &clnt_adr_sz);
-        
-        pthread_mutex_lock(&mut);
+// 사건 하나 기록, 메모리가 모자라면 이 경기는 기록하지 않음
+static void match_append(Room *room, const ReplayEvent *ev) {
+    if (replay_append(&room->replay, ev) < 0) {
+        free(room->replay);
+        room->replay = NULL;
+    }
+}
 
-        int empty_slot = -1;
-        for (int i = 0; i < MAX_CLNT; i++) {
-            if (clnt_socks[i] == -1) {
-                empty_slot = i;
-                break;
-            }
+// 두 자리가 모두 차면 경기 시작: 앉은 뒤 처음인 게임은 시드를, 이미 진행 중이던 게임은 상태를 기록
+static void match_begin(Room *room) {
+    if (!replay_log || room->replay) return;
+    room->replay = replay_begin(next_match_id++, (uint32_t)room->id);
+    for (int seat = 0; seat < ROOM_SEATS && room->replay; seat++) {
+        ReplayEvent ev = { .type = REPLAY_SEED, .seat = seat, .seed = room->seeds[seat], .stream = seat };
+        if (!room->fresh[seat]) {
+            ev.type = REPLAY_STATE;
+            ev.state = room->games[seat];
         }
+        room->fresh[seat] = false;
+        match_append(room, &ev);
+    }
+}
 
-        if (empty_slot == -1) {
-            pthread_mutex_unlock(&mut);
-            printf("Server full! Connection rejected.\n");
-            close(clnt_sock);
-            continue;
+// 경기 중 사건 (이동, 공격, 대기 공격) 기록
+static void match_record(Room *room, ReplayEventType type, int seat, Direction dir, int attacks) {
+    if (!room->replay) return;
+    ReplayEvent ev = { .type = type, .seat = seat, .dir = dir, .attacks = attacks };
+    match_append(room, &ev);
+}
+
+// 입력 하나의 사건을 다 기록한 뒤: 두 게임이 모두 끝났으면 경기 기록을 닫고,
+// 기록이 너무 커졌으면 끊고 지금 상태에서 새 경기로 이어 감 (이동과 그 공격이 다른 덩어리로 갈라지지 않게 여기서만)
+static void match_settle(Room *room, int seat) {
+    if (!room->replay) return;
+    if (room->games[0].game_over && room->games[1].game_over) {
+        match_end(room, REPLAY_FINISHED, seat);
+    } else if (room->replay->len > REPLAY_SPLIT_BYTES) {
+        match_end(room, REPLAY_SPLIT, seat);
+        match_begin(room);
+    }
+}
+
+// ==========================================
+// [3] 대기 공격 타이머
+// ==========================================
+
+// 대전 중이고 공격이 대기 중이면 타이머를 걸고 (이미 걸려 있으면 그대로), 아니면 끔
+static void update_idle_timer(EventLoop *loop, Client *c, bool restart) {
+    Room *room = c->room;
+    if (room->players >= ROOM_SEATS && room->games[c->seat].attack_cnt > 0) {
+        if (restart || !timer_active(&c->idle)) loop_timer_start(loop, &c->idle, idle_attack_ms);
+    } else {
+        loop_timer_stop(loop, &c->idle);
+    }
+}
+
+static void on_idle_timeout(EventLoop *loop, Timer *t) {
+    Client *c = (Client *)((char *)t - offsetof(Client, idle));
+    Room *room = c->room;
+    int my_id = c->seat;
+
+    printf("[Room %d][P%d] Timeout! Executing Attack.\n", room->id, my_id + 1);
+    game_execute_attack(&room->games[my_id]);
+    game_is_over(&room->games[my_id]);
+    match_record(room, REPLAY_IDLE, my_id, UP, 0);
+    match_settle(room, my_id);
+
+    // 남은 공격이 있으면 다시 5초
+    update_idle_timer(loop, c, true);
+
+    room_notify(loop, room, my_id, LOCK_IDLE, UP, false);
+}
+
+// ==========================================
+// [4] 요청 처리
+// ==========================================
+
+// dir은 이미 범위를 확인한 이동 (기록과 상대에게 보내는 사건이 서버가 실제로 둔 수와 같도록)
+static void handle_action(EventLoop *loop, Client *c, Direction dir) {
+    Room *room = c->room;
+    int my_id = c->seat;
+    int opp_id = (my_id + 1) % ROOM_SEATS;
+    GameState *me = &room->games[my_id];
+
+    // 방의 상태는 이 루프 스레드만 건드리므로 잠금 없이 처리
+    Client *opp = room->seats[opp_id];
+
+    if (room->players >= ROOM_SEATS && !me->game_over) {
+        // 록스텝 클라이언트도 같은 함수로 같은 결과를 만듦
+        uint64_t t0 = stats_now();
+        int attack_count = game_play_move(me, &room->games[opp_id], dir);
+        stats_since(STATS_MOVE, t0);
+        match_record(room, REPLAY_MOVE, my_id, dir, 0);
+        if (attack_count > 0) match_record(room, REPLAY_ATTACK, my_id, UP, attack_count);
+        match_settle(room, my_id);
+        if (attack_count > 0) {
+            printf("[Room %d][P%d] Attack! Sent %d blocks\n", room->id, my_id + 1, attack_count);
+            if (opp) update_idle_timer(loop, opp, false);
         }
 
-        clnt_socks[empty_slot] = clnt_sock;
-        game_init(&game_states[empty_slot]); 
-        
-        int *id_ptr = (int *)malloc(sizeof(int));
-        *id_ptr = empty_slot;
-        
-        printf("Connected client IP: %s (Player %d)\n", inet_ntoa(clnt_adr.sin_addr), empty_slot + 1);
-
-        // 매칭 성공 시 전송
-        S2C_Packet start_pkt1, start_pkt2;
-        int sock1 = -1, sock2 = -1;
-        int need_start_send = 0;
-
-        if (get_client_count() == 2) {
-            printf("Match Found! Starting game...\n");
-            if (clnt_socks[0] != -1) {
-                compose_packet(0, &start_pkt1);
-                sock1 = clnt_socks[0];
+        // 입력이 있었으므로 대기 시간은 처음부터 다시
+        update_idle_timer(loop, c, true);
+
+        room_notify(loop, room, my_id, LOCK_MOVE, dir, attack_count > 0);
+    } else if (is_lockstep(c)) {
+        // 반영하지 않은 입력도 받았다고 알려 줌 (클라이언트가 예측해 둔 입력을 버림)
+        lock_send(loop, c, LOCK_SKIP, my_id, UP);
+    } else if (me->game_over) {
+        // 게임오버 상태에서도 화면 갱신은 필요할 수 있음
+        room_notify(loop, room, my_id, 0, UP, false);
+    }
+}
+
+static void client_attach(EventLoop *loop, void *arg);
+static void watcher_attach(EventLoop *loop, void *arg);
+
+// 받아 둔 바이트의 맨 앞 요청 하나를 req에 꺼냄 (협상 중에는 hello/예전 요청 4바이트, watch면 8바이트)
+// @return 요청 크기, 아직 다 오지 않았으면 0, 잘못된 요청이면 -1
+static int next_request(Client *c, uint8_t req[WIRE_MAX_REQUEST]) {
+    size_t avail = recv_buf_peek(&c->rx, req, WIRE_MAX_REQUEST);
+    int size;
+    if (c->format == FORMAT_COMPACT) {
+        size = wire_request_size(req, avail, c->version);
+    } else if (c->format == FORMAT_PENDING && avail >= WIRE_HELLO_SIZE && wire_parse_watch(req) >= 0) {
+        size = WIRE_WATCH_SIZE;
+    } else {
+        size = (int)sizeof(C2S_Packet);
+    }
+    if (size <= 0) return size;
+    if ((size_t)size > avail) return 0;
+    recv_buf_consume(&c->rx, (size_t)size);
+    return size;
+}
+
+// 형식이 정해진 플레이어를 매칭해서 방의 루프로 넘김 (압축이면 고른 버전을 먼저 알림)
+static void client_start(EventLoop *loop, Client *c, WireFormat format, int version) {
+    loop_timer_stop(loop, &c->hello);
+    c->format = format;
+    if (format == FORMAT_COMPACT) {
+        uint8_t hello[WIRE_HELLO_SIZE];
+        c->version = version < WIRE_VERSION ? version : WIRE_VERSION;
+        wire_stream_init(&c->tx);
+        wire_hello(hello, c->version);
+        client_send(loop, c, hello, sizeof(hello));
+    }
+
+    // 기다리는 방을 찾거나 새 방을 이 루프에 만듦, 방은 자기 루프에서만 처리되므로 연결도 그 루프로
+    Room *room = room_match(loop);
+    if (!room) {
+        printf("Out of memory! Connection rejected.\n");
+        client_close(loop, c);
+        return;
+    }
+    c->room = room;
+    loop_del(loop, &c->w);
+    loop_post(room->loop, client_attach, c);
+}
+
+// 관전할 방을 찾아 방의 루프로 넘김
+static void watcher_start(EventLoop *loop, Client *c, int version, uint32_t room_id) {
+    loop_timer_stop(loop, &c->hello);
+    Room *room = (version >= WATCH_VERSION) ? room_watch((int)room_id) : NULL;
+    if (!room) {
+        // 볼 대전이 없으면 끊음
+        client_close(loop, c);
+        return;
+    }
+
+    uint8_t hello[WIRE_HELLO_SIZE];
+    c->format = FORMAT_COMPACT;
+    c->version = version < WIRE_VERSION ? version : WIRE_VERSION; // S2C는 버전 2부터 같음
+    c->watching = true;
+    c->room = room;
+    wire_hello(hello, c->version);
+    client_send(loop, c, hello, sizeof(hello));
+    loop_del(loop, &c->w);
+    loop_post(room->loop, watcher_attach, c);
+}
+
+static void on_hello_timeout(EventLoop *loop, Timer *t) {
+    Client *c = (Client *)((char *)t - offsetof(Client, hello));
+    client_start(loop, c, FORMAT_RAW, 0);
+}
+
+// 받아 둔 요청을 모두 처리 (종료 요청이나 잘못된 요청이 오면 연결을 닫음)
+// @return 연결을 계속 이 루프에서 처리하면 true, 닫혔거나 (협상이 끝나) 다른 루프로 넘어갔으면 false
+static bool client_process(EventLoop *loop, Client *c) {
+    uint8_t req[WIRE_MAX_REQUEST];
+    int size;
+
+    while ((size = next_request(c, req)) > 0) {
+        stats_add(STATS_PACKETS_IN, 1);
+        // 협상: hello면 압축 형식 플레이어, watch면 관전자, 아니면 예전 클라이언트의 요청
+        // (방에 들어가기 전에 누른 키라 버림, 종료 요청이면 끊음)
+        if (c->format == FORMAT_PENDING) {
+            int version = wire_parse_hello(req);
+            if (version >= 1) {
+                client_start(loop, c, FORMAT_COMPACT, version);
+                return false;
             }
-            if (clnt_socks[1] != -1) {
-                compose_packet(1, &start_pkt2);
-                sock2 = clnt_socks[1];
+            if ((version = wire_parse_watch(req)) >= 0) {
+                watcher_start(loop, c, version, wire_watch_room(req));
+                return false;
             }
-            need_start_send = 1;
+            ClientAction first;
+            if (wire_decode_raw(req, &first) == 0 && first == QUIT) break;
+            client_start(loop, c, FORMAT_RAW, 0);
+            return false;
         }
 
-        pthread_mutex_unlock(&mut); // 락 해제
+        ClientAction action;
+        if (c->format == FORMAT_COMPACT) {
+            int code = wire_request_code(req, c->version);
+            if (code < 0) continue;
+
+            // 상태를 놓쳤으면 키프레임으로 다시 맞춤
+            if (code == WIRE_KEYFRAME_REQUEST) {
+                if (c->watching) {
+                    room_broadcast(loop, c->room, true);
+                } else if (is_lockstep(c)) {
+                    // 록스텝은 양쪽 게임 상태를 통째로 다시 보냄
+                    int opp_id = (c->seat + 1) % ROOM_SEATS;
+                    lock_send(loop, c, LOCK_STATE, c->seat, UP);
+                    if (c->room->seats[opp_id]) lock_send(loop, c, LOCK_STATE, opp_id, UP);
+                } else {
+                    S2C_Packet pkt;
+                    uint8_t buf[WIRE_MAX_PACKET];
+                    room_compose_packet(c->room, c->seat, &pkt);
+                    client_send(loop, c, buf, wire_encode_stream(&c->tx, &pkt, c->input_seq, buf, true));
+                }
+                continue;
+            }
+            if (wire_decode_action((uint8_t)code, &action) < 0) continue;
+            // 이 입력의 결과로 나가는 상태부터 번호를 붙임 (무시된 입력도 처리한 것으로)
+            int seq = wire_request_seq(req, c->version);
+            if (seq >= 0) c->input_seq = seq;
+        } else if (wire_decode_raw(req, &action) < 0) {
+            // 알 수 없는 행동은 압축 형식과 같이 버림 (넘기면 이동 없이 공격만 실행되고 기록과 어긋남)
+            continue;
+        }
 
-        // 락 밖에서 전송
-        if (need_start_send) {
-            if (sock1 != -1) write(sock1, &start_pkt1, sizeof(S2C_Packet));
-            if (sock2 != -1) write(sock2, &start_pkt2, sizeof(S2C_Packet));
-            printf("Both players connected. Game start\n");
+        if (action == QUIT) {
+            if (!c->watching) printf("[Room %d][Player %d] Quit request received.\n", c->room->id, c->seat + 1);
+            break;
         }
+        // 관전자의 이동 입력은 무시
+        if (!c->watching) handle_action(loop, c, (Direction)action);
+    }
+    if (size == 0) return true; // 다 처리했거나 다음 요청이 아직 덜 옴
+
+    client_close(loop, c);
+    return false;
+}
 
-        pthread_create(&t_id, NULL, handle_client, (void *)id_ptr);
-        pthread_detach(t_id); 
+static void on_client_event(EventLoop *loop, Watcher *w, uint32_t events) {
+    Client *c = (Client *)w;
+
+    if (events & EPOLLOUT) client_flush(loop, c);
+    if (!(events & (EPOLLIN | EPOLLHUP | EPOLLERR))) return;
+
+    // 소켓에 와 있는 만큼 한 번에 받아서 완성된 요청을 모두 처리
+    // (더 남아 있으면 epoll이 다시 알려 주므로, 연결 하나가 루프를 붙잡지 않음)
+    ssize_t n = recv_buf_fill(&c->rx, w->fd);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+    if (n <= 0) {
+        client_close(loop, c);
+        return;
     }
+    // 받은 요청의 결과를 모두 보낼 때까지 (다른 루프로 넘어간 연결은 그 앞까지만)
+    uint64_t t0 = stats_now();
+    stats_add(STATS_BYTES_IN, (uint64_t)n);
+    client_process(loop, c);
+    stats_since(STATS_RECV_SEND, t0);
+}
 
-    close(serv_sock);
-    return 0;
+// ==========================================
+// [5] 봇
+// ==========================================
+// 봇은 소켓 없는 Client로 자리에 앉아 사람과 같은 규칙(handle_action, 대기 공격 타이머, 경기 기록)을 따름
+// 탐색은 방의 루프가 아니라 봇 풀의 스레드에서 하고, 고른 수만 loop_post로 방의 루프에 돌아옴
+
+// 혼자 앉은 사람의 봇 대기 타이머 시작 (봇을 켰을 때만)
+static void bot_wait_start(EventLoop *loop, Client *c) {
+    if (bot_pool) loop_timer_start(loop, &c->bot, bot_wait_ms);
 }
 
-void *handle_client(void *arg) {
-    int my_id = *((int *)arg);
-    int opp_id = (my_id + 1) % 2;
-    int sock;
+// 다음 수까지 기다릴 시간: 기본 간격, 앉은 뒤 쓴 CPU가 상한(지난 시간의 bot_cpu_pct%)을 넘었으면
+// 평균이 상한으로 돌아올 때까지 더 쉼
+static uint64_t bot_next_delay(const Client *b) {
+    uint64_t elapsed = loop_now_ns() - b->since_ns;
+    uint64_t allowed = elapsed / 100 * (uint64_t)bot_cpu_pct;
+    uint64_t delay = bot_move_ms;
+    if (b->cpu_ns > allowed) {
+        uint64_t debt_ms = (b->cpu_ns - allowed) * 100 / (uint64_t)bot_cpu_pct / 1000000;
+        if (debt_ms > delay) delay = debt_ms;
+    }
+    return delay;
+}
 
-    pthread_mutex_lock(&mut);
-    sock = clnt_socks[my_id];
-    pthread_mutex_unlock(&mut);
+// 봇 풀의 작업 스레드에서: 결과를 봇의 방 루프로 넘김
+static void bot_job_done(BotJob *job) {
+    Client *b = (Client *)((char *)job - offsetof(Client, job));
+    loop_post(job->arg, bot_move, b);
+}
 
-    free(arg);
+static void on_bot_think(EventLoop *loop, Timer *t) {
+    Client *b = (Client *)((char *)t - offsetof(Client, bot));
+    const GameState *me = &b->room->games[b->seat];
+    if (me->game_over) return;
 
-    C2S_Packet req_packet;
-    int idle_timer = 0;
+    b->job.board = bb_from_array(me->board);
+    b->job.done = bot_job_done;
+    b->job.arg = loop;
+    if (bot_pool_submit(bot_pool, &b->job) < 0) {
+        // 풀이 밀려 있으면 이번 수는 건너뜀 (봇이 많아도 탐색에 쓰는 코어는 늘지 않음)
+        loop_timer_start(loop, &b->bot, bot_move_ms);
+        return;
+    }
+    b->thinking = true;
+}
 
-    // 초기 접속 패킷
-    S2C_Packet init_pkt;
-    int need_init_send = 0;
+// 방의 루프에서: 탐색 결과를 사람의 입력처럼 처리하고 다음 수를 예약
+// (탐색하는 사이에 대기 공격으로 보드가 바뀌었어도 그대로 둠, 사람이 조금 늦게 누른 것과 같음)
+static void bot_move(EventLoop *loop, void *arg) {
+    Client *b = arg;
+    b->thinking = false;
+    b->cpu_ns += b->job.cpu_ns;
+    if (b->gone) {
+        free(b);
+        return;
+    }
 
-    pthread_mutex_lock(&mut);
-    if (get_client_count() < 2) {
-        compose_packet(my_id, &init_pkt);
-        need_init_send = 1;
+    if (b->job.result.valid) {
+        handle_action(loop, b, b->job.result.move);
+        b->moves++;
     }
-    pthread_mutex_unlock(&mut);
+    if (!b->room->games[b->seat].game_over) loop_timer_start(loop, &b->bot, bot_next_delay(b));
+}
+
+// 사람이 기다리는 방의 빈자리에 봇을 앉히고 경기 시작
+static void on_bot_wait(EventLoop *loop, Timer *t) {
+    Client *c = (Client *)((char *)t - offsetof(Client, bot));
+    Room *room = c->room;
+    if (room->players != 1) return;
 
-    if (need_init_send) {
-        write(sock, &init_pkt, sizeof(init_pkt));
+    Client *b = calloc(1, sizeof(Client));
+    if (!b) return;
+    // 그 사이에 사람이 매칭되어 넘어오는 중이면 그 사람을 기다림
+    if (!room_claim(room)) {
+        free(b);
+        return;
     }
+    b->is_bot = true;
+    b->w.fd = -1;
+    b->room = room;
+    b->input_seq = -1;
+    timer_init(&b->idle, on_idle_timeout);
+    timer_init(&b->bot, on_bot_think);
+    b->seat = room_sit(room, b);
+    b->since_ns = loop_now_ns();
+    printf("[Room %d] No opponent for %llu ms, bot seated as Player %d.\n",
+           room->id, (unsigned long long)bot_wait_ms, b->seat + 1);
+    match_begin(room);
 
-    while (1) {
-        fd_set reads;
-        FD_ZERO(&reads);
-        FD_SET(sock, &reads);
+    // 사람에게는 사람 상대가 들어온 것과 똑같이 알림
+    if (is_lockstep(c)) {
+        lock_send(loop, c, LOCK_SEED, b->seat, UP);
+    } else {
+        S2C_Packet pkt;
+        room_compose_packet(room, c->seat, &pkt);
+        send_packet(loop, c, &pkt);
+    }
+    room_broadcast(loop, room, false);
+    update_idle_timer(loop, c, false);
+    loop_timer_start(loop, &b->bot, bot_move_ms);
+}
 
-        struct timeval timeout;
-        timeout.tv_sec = 1;
-        timeout.tv_usec = 0;
+// 사람이 나간 방에서 봇도 나감
+// @return room_leave의 결과 (0이고 관전자가 없었으면 room은 이미 해제됨)
+static int bot_close(EventLoop *loop, Client *b) {
+    Room *room = b->room;
+    int room_id = room->id;
 
-        int result = select(sock + 1, &reads, 0, 0, &timeout);
+    loop_timer_stop(loop, &b->idle);
+    loop_timer_stop(loop, &b->bot);
+    double alive = (double)(loop_now_ns() - b->since_ns);
+    printf("[Room %d] Bot left (%ld moves, %.1f ms CPU, %.1f%% of a core).\n",
+           room_id, b->moves, b->cpu_ns / 1e6, alive > 0 ? 100.0 * (double)b->cpu_ns / alive : 0.0);
 
-        if (result < 0) break; 
+    int left = room_leave(room, b->seat);
+    // 탐색 중이면 결과가 돌아올 때 해제 (작업 스레드가 아직 b->job을 씀)
+    if (b->thinking) b->gone = true;
+    else free(b);
+    return left;
+}
 
-        // 타임아웃
-        if (result == 0) {
-            S2C_Packet my_pkt, opp_pkt;
-            int opp_sock = -1;
-            int need_send = 0;
+// ==========================================
+// [6] 접속 / 종료
+// ==========================================
 
-            pthread_mutex_lock(&mut);
-            
-            if (get_client_count() >= 2 && game_states[my_id].attack_cnt > 0) {
-                idle_timer++;
-                printf("[P%d] Warning: Idle for %d sec\n", my_id + 1, idle_timer);
+// accept 스레드가 넘긴 새 연결을 등록하고 형식 협상을 기다림
+static void client_handshake(EventLoop *loop, void *arg) {
+    Client *c = arg;
+    if (loop_add(loop, &c->w, EPOLLIN) < 0) {
+        perror("epoll_ctl");
+        client_free(c);
+        return;
+    }
+    // hello가 이미 와 있으면 바로 읽힘
+    loop_timer_start(loop, &c->hello, HELLO_WAIT_MS);
+}
 
-                if (idle_timer >= 5) {
-                    printf("[P%d] Timeout! Executing Attack.\n", my_id + 1);
-                    game_execute_attack(&game_states[my_id]);
-                    game_is_over(&game_states[my_id]);
-                    
-                    // 패킷 생성
-                    compose_packet(my_id, &my_pkt);
-                    opp_sock = clnt_socks[opp_id];
-                    if (opp_sock != -1) compose_packet(opp_id, &opp_pkt);
-                    
-                    idle_timer = 0;
-                    need_send = 1;
-                }
-            } else {
-                idle_timer = 0;
-            }
-            pthread_mutex_unlock(&mut);
+// 매칭된 연결을 방의 루프에 등록하고 자리에 앉힌 뒤 첫 패킷 전송
+static void client_attach(EventLoop *loop, void *arg) {
+    Client *c = arg;
+    Room *room = c->room;
 
-           
-            if (need_send) {
-                write(sock, &my_pkt, sizeof(my_pkt));
-                if (opp_sock != -1) write(opp_sock, &opp_pkt, sizeof(opp_pkt));
-            }
-            continue;
-        }
+    int my_id = room_sit(room, c);
+    int opp_id = (my_id + 1) % ROOM_SEATS;
+    c->seat = my_id;
 
-        // 데이터 수신
-        if (FD_ISSET(sock, &reads)) {
-            int str_len = recv_all(sock, &req_packet, sizeof(req_packet));
-            if (str_len <= 0) break;
+    // hello 응답을 다 못 보냈으면 이어서 보냄
+    if (loop_add(loop, &c->w, send_queue_empty(&c->sq) ? EPOLLIN : (EPOLLIN | EPOLLOUT)) < 0) {
+        perror("epoll_ctl");
+        room_leave(room, my_id);
+        client_free(c);
+        return;
+    }
+    printf("[Room %d] Player %d seated.\n", room->id, my_id + 1);
 
-            if (req_packet.action == QUIT) {
-                printf("[Player %d] Quit request received.\n", my_id + 1);
-                break;
-            }
+    Client *opp = room->seats[opp_id];
+    if (opp) {
+        printf("[Room %d] Match Found! Starting game...\n", room->id);
+        loop_timer_stop(loop, &opp->bot);
+        match_begin(room);
+    } else {
+        bot_wait_start(loop, c);
+    }
 
-            // 전송할 변수 준비
-            S2C_Packet my_pkt, opp_pkt;
-            int opp_sock = -1;
-            int need_send = 0;
+    // 록스텝 연결에는 새 게임의 시드를 (이미 진행 중인 상대 게임은 상태를), 나머지에는 상태 패킷을 보냄
+    if (is_lockstep(c)) {
+        lock_send(loop, c, LOCK_SEED, my_id, UP);
+        if (opp) lock_send(loop, c, LOCK_STATE, opp_id, UP);
+    } else {
+        S2C_Packet pkt;
+        room_compose_packet(room, my_id, &pkt);
+        send_packet(loop, c, &pkt);
+    }
+    // 매칭 성공 시 양쪽에 전송
+    if (opp && is_lockstep(opp)) {
+        lock_send(loop, opp, LOCK_SEED, my_id, UP);
+    } else if (opp) {
+        S2C_Packet pkt;
+        room_compose_packet(room, opp_id, &pkt);
+        send_packet(loop, opp, &pkt);
+    }
+    room_broadcast(loop, room, false);
+    // hello 뒤에 몰아서 온 요청은 협상한 루프에서 이미 받아 두었음
+    client_process(loop, c);
+}
 
-            pthread_mutex_lock(&mut);
+// 관전자를 방의 관전자 목록에 넣고, 새 관전자도 따라올 수 있게 키프레임을 보냄
+static void watcher_attach(EventLoop *loop, void *arg) {
+    Client *c = arg;
+    Room *room = c->room;
 
-            if (get_client_count() >= 2 && !game_states[my_id].game_over) {
-                idle_timer = 0; 
+    // 넘어오는 사이에 대전이 끝나 모두 나갔으면 끊음
+    if (room_members(room) == 0 || loop_add(loop, &c->w, send_queue_empty(&c->sq) ? EPOLLIN : (EPOLLIN | EPOLLOUT)) < 0) {
+        client_free(c);
+        room_unwatch(room);
+        return;
+    }
 
-                int score_gained = game_move(&game_states[my_id], (Direction)req_packet.action);
+    c->watch_prev = NULL;
+    c->watch_next = room->watchers;
+    if (room->watchers) room->watchers->watch_prev = c;
+    room->watchers = c;
+    room->watcher_count++;
+    printf("[Room %d] Spectator joined (%d watching).\n", room->id, room->watcher_count);
 
-                if (game_states[my_id].moved) {
-                    game_spawn_tile(&game_states[my_id]);
-                }
-                
-                game_execute_attack(&game_states[my_id]);
-                game_is_over(&game_states[my_id]);
-
-                bool attack_occurred = false;
-
-                if (score_gained >= 128) {
-                    int attack_count = score_gained / 128;
-                    if (attack_count > 4) attack_count = 4;
-                    for (int i = 0; i < attack_count; i++) {
-                        int attack_value = (rand() % 10 == 0) ? 4 : 2;
-                        game_queue_attack(&game_states[opp_id], attack_value);
-                    }
-                    // 공격 발생 플래그 켜기
-                    printf("[P%d] Attack! Sent %d blocks\n", my_id + 1, attack_count);
-                    attack_occurred = true;
-                }
-                
-                // 패킷 생성
-                compose_packet(my_id, &my_pkt);
-                opp_sock = clnt_socks[opp_id];
-                if (opp_sock != -1) {
-                    compose_packet(opp_id, &opp_pkt);
-                    // 공격 이벤트 플래그 설정
-                    if (attack_occurred) {
-                        opp_pkt.is_hit = true;
-                    }
-                }
-                need_send = 1;
-            }
-            else if (game_states[my_id].game_over) {
-                 // 게임오버 상태에서도 화면 갱신은 필요할 수 있음
-                 compose_packet(my_id, &my_pkt);
-                 opp_sock = clnt_socks[opp_id];
-                 if (opp_sock != -1) compose_packet(opp_id, &opp_pkt);
-                 need_send = 1;
-            }
+    // 관전자는 모두 같은 델타 스트림을 받으므로 키프레임은 모두에게 (새 관전자의 기준 상태)
+    room_broadcast(loop, room, true);
+    client_process(loop, c);
+}
 
-            pthread_mutex_unlock(&mut); 
+static void watcher_close(EventLoop *loop, Client *c) {
+    Room *room = c->room;
 
-            if (need_send) {
-                write(sock, &my_pkt, sizeof(my_pkt));
-                if (opp_sock != -1) write(opp_sock, &opp_pkt, sizeof(opp_pkt));
-            }
-        }
+    loop_del(loop, &c->w);
+    if (c->watch_prev) c->watch_prev->watch_next = c->watch_next;
+    else room->watchers = c->watch_next;
+    if (c->watch_next) c->watch_next->watch_prev = c->watch_prev;
+    room->watcher_count--;
+
+    client_free(c);
+    room_unwatch(room); // 대전이 끝난 방이면 마지막 관전자가 나갈 때 해제됨
+}
+
+static void client_close(EventLoop *loop, Client *c) {
+    // 협상 중에 끊긴 연결은 방이 없음
+    if (!c->room) {
+        loop_del(loop, &c->w);
+        loop_timer_stop(loop, &c->hello);
+        client_free(c);
+        return;
     }
-    
-    // 연결 종료 처리
-    S2C_Packet opp_wait_pkt;
-    int opp_sock_final = -1;
-    int send_wait = 0;
-
-    pthread_mutex_lock(&mut);
-    clnt_socks[my_id] = -1;
-    printf("Player %d disconnected.\n", my_id + 1);
-
-    int current_cnt = get_client_count();
-    if (current_cnt == 0) {
-        printf("All players disconnected. Resetting game states...\n");
-        game_init(&game_states[0]);
-        game_init(&game_states[1]);
+    if (c->watching) {
+        watcher_close(loop, c);
+        return;
+    }
+
+    Room *room = c->room;
+    int my_id = c->seat;
+    int opp_id = (my_id + 1) % ROOM_SEATS;
+    int room_id = room->id;
+    int watchers = room->watcher_count;
+
+    loop_del(loop, &c->w);
+    loop_timer_stop(loop, &c->idle);
+    loop_timer_stop(loop, &c->bot);
+
+    printf("[Room %d] Player %d disconnected.\n", room_id, my_id + 1);
+    match_end(room, REPLAY_LEFT, my_id);
+
+    // 사람이 모두 나가면 봇도 나감 (봇만 남은 방은 사람을 기다리게 두지 않음)
+    Client *bot = room->seats[opp_id];
+    int left = room_leave(room, my_id);
+    if (left > 0 && bot && bot->is_bot) left = bot_close(loop, bot);
+    if (left == 0) {
+        // 방 해제 (다른 방은 그대로), 관전자가 있으면 마지막 관전자가 나갈 때 해제됨
+        printf("[Room %d] All players disconnected. Closing room (%d rooms open).\n", room_id, room_count());
+        for (int i = watchers; i > 0; i--) watcher_close(loop, room->watchers);
     } else {
-        if (clnt_socks[opp_id] != -1) {
-            opp_sock_final = clnt_socks[opp_id];
-            compose_packet(opp_id, &opp_wait_pkt);
-            send_wait = 1;
+        // 남은 상대에게 알림 (록스텝이면 퇴장 사건, 아니면 기다리는 상태)
+        Client *opp = room->seats[opp_id];
+        if (opp) {
+            update_idle_timer(loop, opp, false);
+            bot_wait_start(loop, opp);
+            if (is_lockstep(opp)) {
+                lock_send(loop, opp, LOCK_LEAVE, my_id, UP);
+            } else {
+                S2C_Packet opp_wait_pkt;
+                room_compose_packet(room, opp_id, &opp_wait_pkt);
+                send_packet(loop, opp, &opp_wait_pkt);
+            }
         }
-    }
-    pthread_mutex_unlock(&mut);
-    
-    if (send_wait && opp_sock_final != -1) {
-        write(opp_sock_final, &opp_wait_pkt, sizeof(opp_wait_pkt));
+        room_broadcast(loop, room, false);
     }
 
-    close(sock);
-    return NULL;
+    client_free(c);
 }
 
-// 패킷 데이터 채우기 (전송 안 함)
+// 루프 스레드마다 통계 등록 (루프를 시작한 뒤 각 루프에서)
+static void stats_attach_loop(EventLoop *loop, void *arg) {
+    (void)arg;
+    char name[16];
+    snprintf(name, sizeof(name), "loop%d", loop_id(loop));
+    stats_register(name);
+}
 
-void compose_packet(int id, S2C_Packet *res_packet) {
-    int opp_id = (id + 1) % 2;
+// 통계 JSON에 읽는 순간의 값으로 넣는 항목
+static int64_t gauge_rooms(void) { return room_count(); }
+static int64_t gauge_waiting_rooms(void) { return room_waiting_count(); }
+static int64_t gauge_replay_dropped(void) {
+    ReplayLogStats rs = {0};
+    if (replay_log) replay_log_stats(replay_log, &rs);
+    return (int64_t)rs.dropped;
+}
+static const StatsGauge stats_gauges[] = {
+    { "rooms", gauge_rooms },
+    { "waiting_rooms", gauge_waiting_rooms },
+    { "replay_dropped", gauge_replay_dropped },
+};
 
-    // 패킷 메모리 초기화
-    memset(res_packet, 0, sizeof(S2C_Packet));
+// 수천 개 연결을 받을 수 있도록 열 수 있는 파일 수를 최대로
+static void raise_fd_limit(void) {
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+}
 
-    // 내 정보 채우기
-    memcpy(res_packet->my_board, game_states[id].board, sizeof(int) * 16);
-    res_packet->my_score = game_states[id].score;
+int main(int argc, char *argv[]) {
+    int serv_sock, clnt_sock;
+    struct sockaddr_in serv_adr, clnt_adr;
+    socklen_t clnt_adr_sz;
     
-    // 상대방 정보 
-    if (clnt_socks[opp_id] != -1) {
-        memcpy(res_packet->opp_board, game_states[opp_id].board, sizeof(int) * 16);
-        res_packet->opp_score = game_states[opp_id].score;
+    signal(SIGINT, handle_sigint);
+    signal(SIGUSR1, handle_sigusr1);
+    signal(SIGPIPE, SIG_IGN); // 끊긴 소켓에 쓰면 종료되지 않고 오류로 받음
+
+    // 봇 옵션 (-b를 주면 봇을 켬), 나머지는 예전과 같은 위치 인자
+    int bot_threads = 0;
+    bool bad_option = false;
+    const char *stats_path = STATS_SOCKET_PATH;
+    int ch;
+    while ((ch = getopt(argc, argv, "b:m:c:w:S:")) != -1) {
+        switch (ch) {
+            case 'b': bot_wait_ms = (uint64_t)atoll(optarg); break;
+            case 'm': bot_move_ms = (uint64_t)atoll(optarg); break;
+            case 'c': bot_cpu_pct = atoi(optarg); break;
+            case 'w': bot_threads = atoi(optarg); break;
+            case 'S': stats_path = optarg; break;
+            default: bad_option = true; break;
+        }
+    }
+    char **args = argv + optind;
+    int nargs = argc - optind;
+    if (bad_option || nargs > 3) {
+        printf("Usage : %s [-b bot_wait_ms] [-m bot_move_ms] [-c bot_cpu_pct] [-w bot_threads] [-S stats_socket|-] "
+               "<port> [idle_attack_ms] [replay_log|-]\n", argv[0]);
+        exit(1);
+    }
+    const char *port = (nargs >= 1) ? args[0] : "8080";
+    if (nargs == 0) printf("Using default port 8080\n");
+    // 빠른 게임용으로 대기 공격 시간을 줄일 수 있음 (1ms 단위)
+    if (nargs >= 2) {
+        idle_attack_ms = (uint64_t)atoll(args[1]);
+        if (idle_attack_ms == 0) idle_attack_ms = 1;
+    }
+    if (bot_move_ms == 0) bot_move_ms = 1;
+    if (bot_cpu_pct < 1) bot_cpu_pct = 1;
+    if (bot_cpu_pct > 100) bot_cpu_pct = 100;
+    // 끝난 경기를 기록 파일에 덧붙임 (기록에 실패해도 서버는 그대로 동작)
+    const char *replay_path = (nargs == 3) ? args[2] : REPLAY_LOG_PATH;
+    if (strcmp(replay_path, "-") != 0) {
+        replay_log = replay_log_open(replay_path, REPLAY_MAX_PENDING);
+        if (replay_log) printf("Recording matches to %s\n", replay_path);
+        else perror("replay log");
+    }
+
+
+    raise_fd_limit();
+    bb_init(); // 행 이동 테이블은 접속 받기 전에 미리 준비
+
+    // 코어마다 이벤트 루프 하나
+    loop_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (loop_count < 1) loop_count = 1;
+    loops = calloc((size_t)loop_count, sizeof(EventLoop *));
+    if (!loops) error_handling("calloc() error");
+    for (int i = 0; i < loop_count; i++) {
+        loops[i] = loop_create(i);
+        if (!loops[i] || loop_start(loops[i]) < 0) error_handling("event loop error");
+    }
+
+    // 통계: accept 스레드와 루프 스레드마다 따로 기록하고, 통계 스레드가 요청받을 때만 합침
+    stats_register("accept");
+    for (int i = 0; i < loop_count; i++) loop_post(loops[i], stats_attach_loop, NULL);
+    if (strcmp(stats_path, "-") == 0) stats_path = NULL;
+    if (stats_serve(stats_path, stats_gauges, (int)(sizeof(stats_gauges) / sizeof(stats_gauges[0]))) < 0) {
+        perror("stats socket");
     } else {
-        memset(res_packet->opp_board, 0, sizeof(int) * 16);
-        res_packet->opp_score = 0;
+        printf("Stats: %s%sSIGUSR1 dumps JSON to stdout\n", stats_path ? stats_path : "", stats_path ? ", " : "");
     }
 
-    // 공격 정보
-    memcpy(res_packet->pending_attacks, game_states[id].attack_queue, sizeof(int) * 10);
-    res_packet->attack_count = game_states[id].attack_cnt;
-    res_packet->highlight_r = game_states[id].highlight_r;
-    res_packet->highlight_c = game_states[id].highlight_c;
+    // 봇 탐색은 루프와 따로 정해진 수의 스레드에서 (기본: 코어 4개당 하나)
+    if (bot_wait_ms > 0) {
+        AiConfig cfg;
+        ai_default_config(&cfg);
+        // 한 수의 탐색 시간도 CPU 상한에 맞춤 (두는 간격의 bot_cpu_pct%)
+        cfg.time_ms = (int)(bot_move_ms * (uint64_t)bot_cpu_pct / 100);
+        if (cfg.time_ms < 1) cfg.time_ms = 1;
+        if (bot_threads < 1) bot_threads = (loop_count >= 4) ? loop_count / 4 : 1;
+        bot_pool = bot_pool_create(bot_threads, bot_threads * BOT_QUEUE_PER_THREAD, &cfg);
+        if (bot_pool) {
+            printf("Bots join after %llu ms alone (move every %llu ms, CPU cap %d%% per room, %d search threads)\n",
+                   (unsigned long long)bot_wait_ms, (unsigned long long)bot_move_ms, bot_cpu_pct, bot_threads);
+        } else {
+            printf("Bot pool error! Bots disabled.\n");
+        }
+    }
 
-    res_packet->is_hit = false;
-    
-    // 게임 상태 판정
-    if (get_client_count() < 2) {
-        res_packet->game_status = GAME_WAITING;
-    }
-    else {
-        bool i_am_over = game_states[id].game_over;
-        bool opp_is_over = game_states[opp_id].game_over;
-
-        if (i_am_over && opp_is_over) {
-            if (game_states[id].score > game_states[opp_id].score) {
-                res_packet->game_status = GAME_WIN;
-            } else if (game_states[id].score < game_states[opp_id].score) { 
-                res_packet->game_status = GAME_LOSE;
-            } else {
-                res_packet->game_status = GAME_LOSE; // 무승부=패배 처리
+    serv_sock = socket(PF_INET, SOCK_STREAM, 0);
+    serv_sock_global = serv_sock;
+    if (serv_sock == -1) error_handling("socket() error");
+
+    int opt = 1;
+    setsockopt(serv_sock, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+    memset(&serv_adr, 0, sizeof(serv_adr));
+    serv_adr.sin_family = AF_INET;
+    serv_adr.sin_addr.s_addr = htonl(INADDR_ANY);
+    serv_adr.sin_port = htons(atoi(port));
+
+    if (bind(serv_sock, (struct sockaddr *)&serv_adr, sizeof(serv_adr)) == -1)
+        error_handling("bind() error");
+
+    if (listen(serv_sock, SOMAXCONN) == -1)
+        error_handling("listen() error");
+
+    printf("Game Server Started on port %s (%d event loops)...\n", port, loop_count);
+
+    while (!stopping) {
+        clnt_adr_sz = sizeof(clnt_adr);
+        clnt_sock = accept(serv_sock, (struct sockaddr *)&clnt_adr, &clnt_adr_sz);
+        if (clnt_sock == -1) {
+            // 파일 수 한도에 걸리면 연결이 정리될 때까지 잠깐 쉼 (바로 다시 accept하면 헛돌기만 함)
+            if (errno == EMFILE || errno == ENFILE) {
+                perror("accept() error");
+                usleep(100000);
             }
-        } else if (i_am_over) {
-            res_packet->game_status = GAME_OVER_WAIT;
-        } else {
-            res_packet->game_status = GAME_PLAYING;
+            continue;
+        }
+        
+        // 논블로킹으로 바꿔서 방의 루프에 넘김 (첫 패킷은 루프가 보냄)
+        fcntl(clnt_sock, F_SETFL, fcntl(clnt_sock, F_GETFL, 0) | O_NONBLOCK);
+        int sndbuf = SOCKET_SNDBUF;
+        setsockopt(clnt_sock, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+        // 몇 바이트짜리 갱신(록스텝 사건은 2바이트)을 Nagle이 상대의 지연 ACK까지 붙잡지 않게
+        int nodelay = 1;
+        setsockopt(clnt_sock, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+        Client *c = calloc(1, sizeof(Client));
+        if (!c || recv_buf_init(&c->rx, RECV_BUF_SIZE) < 0) {
+            close(clnt_sock);
+            free(c);
+            continue;
         }
+        c->w.fd = clnt_sock;
+        c->w.fn = on_client_event;
+        timer_init(&c->idle, on_idle_timeout);
+        timer_init(&c->hello, on_hello_timeout);
+        timer_init(&c->bot, on_bot_wait);
+        send_queue_init(&c->sq, SEND_HIGH_WATER);
+        c->input_seq = -1;
+
+        stats_add(STATS_ACCEPTED, 1);
+
+        // 형식 협상은 루프를 돌아가며 맡김 (플레이어인지 관전자인지는 협상 뒤에 앎)
+        printf("Connected client IP: %s\n", inet_ntoa(clnt_adr.sin_addr));
+        if (loop_post(loops[next_loop], client_handshake, c) < 0) {
+            client_free(c);
+            continue;
+        }
+        next_loop = (next_loop + 1) % loop_count;
     }
+
+    printf("\n[Server] Shutting down ...\n");
+    // 서버 소켓 닫기 (포트 반납), 진행 중인 경기는 기록하지 않고 끝난 경기만 마저 씀
+    close(serv_sock);
+    if (bot_pool) {
+        BotPoolStats bs;
+        bot_pool_stats(bot_pool, &bs);
+        printf("[Bot] %llu searches, %llu skipped (pool busy), %.1f s CPU\n", (unsigned long long)bs.searches,
+               (unsigned long long)bs.rejected, bs.cpu_ns / 1e9);
+    }
+    if (replay_log) replay_log_close(replay_log);
+    stats_stop();
+    printf("[Server] Bye!\n");
+    return 0;
 }
 
 void error_handling(const char *message) {
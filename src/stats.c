@@ -0,0 +1,204 @@
+#define _GNU_SOURCE
+#include "stats.h"
+#include <stdlib.h>     // calloc(), malloc(), free()
+#include <string.h>     // strncpy()
+#include <stdbool.h>    // for bool type
+#include <signal.h>     // sig_atomic_t
+#include <unistd.h>     // write(), close(), unlink()
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/stat.h>   // stat(), S_ISSOCK
+#include <sys/un.h>     // struct sockaddr_un
+
+#define STATS_POLL_MS 200   // 덤프 요청을 확인하는 간격
+
+_Thread_local StatsThread *stats_self;
+
+// 등록된 스레드 목록 (늘어나기만 함, 등록과 읽기 때만 잠금)
+static pthread_mutex_t list_lock = PTHREAD_MUTEX_INITIALIZER;
+static StatsThread *threads;
+static uint64_t start_ns;
+
+static const char *hist_names[STATS_HISTS] = { "recv_to_send_ns", "lock_wait_ns", "move_ns", "write_ns" };
+static const char *counter_names[STATS_COUNTERS] = {
+    "accepted", "closed", "packets_in", "packets_out", "bytes_in", "bytes_out"
+};
+
+// 통계 스레드
+static pthread_t tid;
+static bool serving;
+static int listen_fd = -1;
+static char listen_path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+static const StatsGauge *served_gauges;
+static int served_gauge_count;
+static volatile sig_atomic_t dump_requested;
+static atomic_bool stopping;
+
+StatsThread *stats_register(const char *name) {
+    if (stats_self) return stats_self;
+    StatsThread *s = calloc(1, sizeof(StatsThread));
+    if (!s) return NULL;
+    strncpy(s->name, name, sizeof(s->name) - 1);
+
+    pthread_mutex_lock(&list_lock);
+    if (!threads) start_ns = stats_now();
+    s->next = threads;
+    threads = s;
+    pthread_mutex_unlock(&list_lock);
+    stats_self = s;
+    return s;
+}
+
+static void write_hist(FILE *f, const char *name, const Hist *h, bool comma) {
+    fprintf(f, "%s\"%s\":{\"count\":%llu,\"mean\":%.0f,\"p50\":%llu,\"p90\":%llu,\"p99\":%llu,\"p999\":%llu,\"max\":%llu}",
+            comma ? "," : "", name, (unsigned long long)hist_count(h), hist_mean(h),
+            (unsigned long long)hist_percentile(h, 0.5), (unsigned long long)hist_percentile(h, 0.9),
+            (unsigned long long)hist_percentile(h, 0.99), (unsigned long long)hist_percentile(h, 0.999),
+            (unsigned long long)hist_percentile(h, 1.0));
+}
+
+static void write_counters(FILE *f, const uint64_t counters[STATS_COUNTERS]) {
+    fprintf(f, "\"counters\":{");
+    for (int i = 0; i < STATS_COUNTERS; i++) {
+        fprintf(f, "%s\"%s\":%llu", i ? "," : "", counter_names[i], (unsigned long long)counters[i]);
+    }
+    fprintf(f, "}");
+}
+
+static void write_hists(FILE *f, const Hist *hists) {
+    fprintf(f, "\"histograms\":{");
+    for (int i = 0; i < STATS_HISTS; i++) write_hist(f, hist_names[i], &hists[i], i > 0);
+    fprintf(f, "}");
+}
+
+void stats_write_json(FILE *f, const StatsGauge *gauges, int gauge_count) {
+    // 합계용 히스토그램은 칸이 많아서 (스레드마다 30KB x 4) 스택 대신 힙에
+    Hist *total = malloc(sizeof(Hist) * STATS_HISTS);
+    if (!total) {
+        fprintf(f, "{\"error\":\"out of memory\"}\n");
+        return;
+    }
+    for (int i = 0; i < STATS_HISTS; i++) hist_reset(&total[i]);
+    uint64_t sums[STATS_COUNTERS] = {0};
+
+    pthread_mutex_lock(&list_lock);
+    StatsThread *list = threads;
+    uint64_t uptime = list ? stats_now() - start_ns : 0;
+    pthread_mutex_unlock(&list_lock);
+
+    // 목록은 앞에만 붙으므로 잡아 둔 머리부터는 잠금 없이 따라감
+    for (StatsThread *s = list; s; s = s->next) {
+        for (int i = 0; i < STATS_HISTS; i++) hist_merge(&total[i], &s->hists[i]);
+        for (int i = 0; i < STATS_COUNTERS; i++) sums[i] += atomic_load_explicit(&s->counters[i], memory_order_relaxed);
+    }
+
+    fprintf(f, "{\"uptime_ms\":%llu", (unsigned long long)(uptime / 1000000));
+    for (int i = 0; i < gauge_count; i++) fprintf(f, ",\"%s\":%lld", gauges[i].name, (long long)gauges[i].read());
+    fprintf(f, ",");
+    write_counters(f, sums);
+    fprintf(f, ",");
+    write_hists(f, total);
+
+    fprintf(f, ",\"threads\":[");
+    for (StatsThread *s = list; s; s = s->next) {
+        uint64_t counters[STATS_COUNTERS];
+        for (int i = 0; i < STATS_COUNTERS; i++) counters[i] = atomic_load_explicit(&s->counters[i], memory_order_relaxed);
+        fprintf(f, "%s{\"name\":\"%s\",", s == list ? "" : ",", s->name);
+        write_counters(f, counters);
+        fprintf(f, ",");
+        write_hists(f, s->hists);
+        fprintf(f, "}");
+    }
+    fprintf(f, "]}\n");
+    free(total);
+}
+
+// JSON을 메모리에 다 만든 뒤 한 번에 씀 (표준 출력의 다른 로그 줄과 섞이지 않게)
+static void dump_to_fd(int fd) {
+    char *buf = NULL;
+    size_t len = 0;
+    FILE *f = open_memstream(&buf, &len);
+    if (!f) return;
+    stats_write_json(f, served_gauges, served_gauge_count);
+    fclose(f);
+
+    const char *p = buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        p += n;
+        len -= (size_t)n;
+    }
+    free(buf);
+}
+
+static void *stats_main(void *arg) {
+    (void)arg;
+    while (!atomic_load(&stopping)) {
+        struct pollfd pfd = { .fd = listen_fd, .events = POLLIN };
+        int n = poll(&pfd, listen_fd >= 0 ? 1 : 0, STATS_POLL_MS);
+        if (dump_requested) {
+            dump_requested = 0;
+            dump_to_fd(STDOUT_FILENO);
+        }
+        if (n <= 0 || !(pfd.revents & POLLIN)) continue;
+
+        int c = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+        if (c < 0) continue;
+        // 읽지 않는 클라이언트가 통계 스레드를 붙잡지 않게
+        struct timeval tv = { .tv_sec = 1, .tv_usec = 0 };
+        setsockopt(c, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        dump_to_fd(c);
+        close(c);
+    }
+    return NULL;
+}
+
+int stats_serve(const char *path, const StatsGauge *gauges, int gauge_count) {
+    served_gauges = gauges;
+    served_gauge_count = gauge_count;
+    if (path) {
+        struct sockaddr_un addr = { .sun_family = AF_UNIX };
+        if (strlen(path) >= sizeof(addr.sun_path)) return -1;
+        strcpy(addr.sun_path, path);
+        // 지난번 실행이 남긴 소켓 파일만 지움 (다른 파일은 건드리지 않음)
+        struct stat st;
+        if (stat(path, &st) == 0 && S_ISSOCK(st.st_mode)) unlink(path);
+
+        listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (listen_fd < 0) return -1;
+        if (bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listen_fd, 16) < 0) {
+            close(listen_fd);
+            listen_fd = -1;
+            return -1;
+        }
+        strcpy(listen_path, path);
+    }
+    atomic_store(&stopping, false);
+    if (pthread_create(&tid, NULL, stats_main, NULL) != 0) {
+        stats_stop();
+        return -1;
+    }
+    serving = true;
+    return 0;
+}
+
+void stats_request_dump(void) {
+    dump_requested = 1;
+}
+
+void stats_stop(void) {
+    if (serving) {
+        atomic_store(&stopping, true);
+        pthread_join(tid, NULL);
+        serving = false;
+    }
+    if (listen_fd >= 0) {
+        close(listen_fd);
+        listen_fd = -1;
+        unlink(listen_path);
+    }
+}
@@ -0,0 +1,205 @@
+#include "task_pool.h"
+#include <stdlib.h>   // calloc(), free()
+#include <stdbool.h>  // for bool type
+#include <pthread.h>  // pthread_create(), mutex, cond
+
+// ==========================================
+// [1] 스레드별 작업 대기열
+// ==========================================
+// 작업은 번호뿐이라 대기열은 남은 번호 구간 [lo, hi) 하나로 충분
+// 주인은 앞(lo)에서 하나씩 꺼내고, 훔치는 쪽은 뒤(hi)에서 절반을 잘라 감
+// 작업 하나가 수십 마이크로초 이상이라 구간마다 뮤텍스 하나로도 경합이 거의 없음
+
+typedef struct {
+    pthread_mutex_t lock;
+    int lo, hi;
+} __attribute__((aligned(64))) TaskQueue; // 스레드끼리 같은 캐시 라인을 건드리지 않도록
+
+struct TaskPool {
+    int threads;
+    pthread_t *tids;        // [threads] (0번은 호출한 스레드라 사용 안 함)
+    TaskQueue *queues;      // [threads]
+
+    pthread_mutex_t lock;   // 아래 필드 보호
+    pthread_cond_t start_cv;
+    pthread_cond_t done_cv;
+    unsigned long round;    // task_pool_run 호출마다 1씩 증가 (일 시작 신호)
+    int running;            // 아직 일하고 있는 스레드 수 (0번 제외)
+    bool shutdown;
+
+    TaskFn fn;
+    void *ctx;
+};
+
+typedef struct {
+    TaskPool *pool;
+    int id;
+} WorkerArg;
+
+// 내 대기열 앞에서 하나 꺼냄, 비었으면 -1
+static int queue_pop(TaskQueue *q) {
+    int idx = -1;
+    pthread_mutex_lock(&q->lock);
+    if (q->lo < q->hi) idx = q->lo++;
+    pthread_mutex_unlock(&q->lock);
+    return idx;
+}
+
+// 다른 스레드 대기열의 뒤쪽 절반을 내 대기열로 옮기고 하나 꺼냄, 훔칠 게 없으면 -1
+static int queue_steal(TaskPool *pool, int id) {
+    for (int k = 1; k < pool->threads; k++) {
+        TaskQueue *victim = &pool->queues[(id + k) % pool->threads];
+
+        pthread_mutex_lock(&victim->lock);
+        int n = (victim->hi - victim->lo + 1) / 2;
+        int lo = victim->hi - n;
+        int hi = victim->hi;
+        victim->hi = lo;
+        pthread_mutex_unlock(&victim->lock);
+        if (n <= 0) continue;
+
+        TaskQueue *mine = &pool->queues[id];
+        pthread_mutex_lock(&mine->lock);
+        mine->lo = lo + 1; // 첫 번째는 바로 실행
+        mine->hi = hi;
+        pthread_mutex_unlock(&mine->lock);
+        return lo;
+    }
+    return -1;
+}
+
+// 작업은 새 작업을 만들지 않으므로, 모든 대기열이 비어 있으면 이번 라운드는 끝
+static void work(TaskPool *pool, int id) {
+    for (;;) {
+        int idx = queue_pop(&pool->queues[id]);
+        if (idx < 0) idx = queue_steal(pool, id);
+        if (idx < 0) return;
+        pool->fn(pool->ctx, idx, id);
+    }
+}
+
+static void *worker_main(void *arg) {
+    WorkerArg *wa = arg;
+    TaskPool *pool = wa->pool;
+    int id = wa->id;
+    free(wa);
+
+    unsigned long seen = 0;
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->round == seen && !pool->shutdown) {
+            pthread_cond_wait(&pool->start_cv, &pool->lock);
+        }
+        if (pool->shutdown) {
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        seen = pool->round;
+        pthread_mutex_unlock(&pool->lock);
+
+        work(pool, id);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->running == 0) pthread_cond_signal(&pool->done_cv);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+// ==========================================
+// [2] 공개 함수 구현
+// ==========================================
+
+TaskPool *task_pool_create(int threads) {
+    if (threads < 1) threads = 1;
+
+    TaskPool *pool = calloc(1, sizeof(TaskPool));
+    if (!pool) return NULL;
+    pool->threads = threads;
+    pool->tids = calloc((size_t)threads, sizeof(pthread_t));
+    pool->queues = aligned_alloc(64, sizeof(TaskQueue) * (size_t)threads);
+    if (!pool->tids || !pool->queues) {
+        free(pool->tids);
+        free(pool->queues);
+        free(pool);
+        return NULL;
+    }
+
+    for (int i = 0; i < threads; i++) {
+        pthread_mutex_init(&pool->queues[i].lock, NULL);
+        pool->queues[i].lo = pool->queues[i].hi = 0;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start_cv, NULL);
+    pthread_cond_init(&pool->done_cv, NULL);
+
+    for (int i = 1; i < threads; i++) {
+        WorkerArg *wa = malloc(sizeof(WorkerArg));
+        if (wa) {
+            wa->pool = pool;
+            wa->id = i;
+        }
+        if (!wa || pthread_create(&pool->tids[i], NULL, worker_main, wa) != 0) {
+            // 만들지 못한 스레드부터는 없는 것으로 하고 지금까지 만든 만큼만 사용
+            free(wa);
+            pool->threads = i;
+            break;
+        }
+    }
+    return pool;
+}
+
+void task_pool_destroy(TaskPool *pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = true;
+    pthread_cond_broadcast(&pool->start_cv);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 1; i < pool->threads; i++) {
+        pthread_join(pool->tids[i], NULL);
+    }
+    for (int i = 0; i < pool->threads; i++) {
+        pthread_mutex_destroy(&pool->queues[i].lock);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->start_cv);
+    pthread_cond_destroy(&pool->done_cv);
+    free(pool->tids);
+    free(pool->queues);
+    free(pool);
+}
+
+int task_pool_threads(const TaskPool *pool) {
+    return pool->threads;
+}
+
+void task_pool_run(TaskPool *pool, TaskFn fn, void *ctx, int count) {
+    if (count <= 0) return;
+
+    // 번호 구간을 스레드 수로 고르게 나눠서 시작, 이후 균형은 훔치기로 맞춤
+    int t = pool->threads;
+    for (int i = 0; i < t; i++) {
+        TaskQueue *q = &pool->queues[i];
+        pthread_mutex_lock(&q->lock);
+        q->lo = (int)((long)count * i / t);
+        q->hi = (int)((long)count * (i + 1) / t);
+        pthread_mutex_unlock(&q->lock);
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->fn = fn;
+    pool->ctx = ctx;
+    pool->running = t - 1;
+    pool->round++;
+    pthread_cond_broadcast(&pool->start_cv);
+    pthread_mutex_unlock(&pool->lock);
+
+    work(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->running > 0) {
+        pthread_cond_wait(&pool->done_cv, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
@@ -1,7 +1,1512 @@
 //네트워크 연결 없이 로직 확인용 함수
-//gcc -o test_game src/test_game.c src/game_logic.c -Iinclude
+//make test (또는 gcc -o test_game src/test_game.c src/game_logic.c src/bitboard.c -Iinclude)
+#define _DEFAULT_SOURCE
 #include <stdio.h>
+#include <stdlib.h>
+#include <math.h>   // fabsf()
+#include <time.h>   // clock_gettime()
 #include "game.h"
+#include "bitboard.h"
+#include "game_batch.h"
+#include "ai.h"
+#include "timer_wheel.h"
+#include "wire.h"
+#include <string.h> // memcmp()
+#include "send_queue.h"
+#include "recv_buf.h"
+#include "predict.h"
+#include "lockstep.h"
+#include "replay.h"
+#include "replay_log.h"
+#include "bot_pool.h"
+#include "hist.h"
+#include "stats.h"
+#include <pthread.h>
+#include <fcntl.h>      // fcntl()
+#include <unistd.h>     // read(), close()
+#include <sys/socket.h> // socket()
+#include <netinet/in.h> // struct sockaddr_in
+#include <arpa/inet.h>  // htonl()
+#include <poll.h>       // poll()
+#include <errno.h>
+#include <sys/un.h>     // struct sockaddr_un
+
+// 기존 int[4][4] 구현을 그대로 옮긴 기준(reference) 로직, 비트보드 결과와 비교용
+static int ref_process_line(int *line) {
+    int score = 0;
+    int temp[4] = {0};
+    int temp_idx = 0;
+
+    for (int i = 0; i < 4; i++) {
+        if (line[i] != 0) temp[temp_idx++] = line[i];
+    }
+    for (int i = 0; i < temp_idx - 1; i++) {
+        if (temp[i] != 0 && temp[i] != MAX_TILE && temp[i] == temp[i+1]) {
+            temp[i] *= 2;
+            score += temp[i];
+            temp[i+1] = 0;
+            i++;
+        }
+    }
+    int final_idx = 0;
+    for (int i = 0; i < 4; i++) {
+        if (temp[i] != 0) line[final_idx++] = temp[i];
+    }
+    while (final_idx < 4) line[final_idx++] = 0;
+    return score;
+}
+
+static int ref_move(int board[4][4], Direction dir) {
+    int total = 0;
+    int line[4];
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            switch(dir) {
+                case UP:    line[j] = board[j][i];   break;
+                case DOWN:  line[j] = board[3-j][i]; break;
+                case LEFT:  line[j] = board[i][j];   break;
+                case RIGHT: line[j] = board[i][3-j]; break;
+            }
+        }
+        total += ref_process_line(line);
+        for (int j = 0; j < 4; j++) {
+            switch(dir) {
+                case UP:    board[j][i]   = line[j]; break;
+                case DOWN:  board[3-j][i] = line[j]; break;
+                case LEFT:  board[i][j]   = line[j]; break;
+                case RIGHT: board[i][3-j] = line[j]; break;
+            }
+        }
+    }
+    return total;
+}
+
+static bool ref_is_over(int board[4][4]) {
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            if (board[i][j] == 0) return false;
+            if (board[i][j] == MAX_TILE) continue;
+            if (j < 3 && board[i][j] == board[i][j+1]) return false;
+            if (i < 3 && board[i][j] == board[i+1][j]) return false;
+        }
+    }
+    return true;
+}
+
+// 무작위 보드 (지수 0~11, 빈칸이 많이 나오도록 절반은 0)
+static void random_board(int board[4][4]) {
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            int e = (rand() % 2) ? 0 : rand() % 12;
+            board[i][j] = (e == 0) ? 0 : (1 << e);
+        }
+    }
+}
+
+static bool same_board(int a[4][4], int b[4][4]) {
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            if (a[i][j] != b[i][j]) return false;
+        }
+    }
+    return true;
+}
+
+// 비트보드 이동/판정 결과가 기준 로직과 같은지 무작위 보드로 교차 검증
+static int test_bitboard(int rounds) {
+    int fail = 0;
+    for (int n = 0; n < rounds; n++) {
+        int board[4][4];
+        random_board(board);
+        // 절반은 빈칸 없는 보드로 게임 오버 판정 검증
+        if (n % 2) {
+            for (int i = 0; i < 4; i++)
+                for (int j = 0; j < 4; j++)
+                    if (board[i][j] == 0) board[i][j] = 2 << (rand() % 3);
+        }
+
+        Board b = bb_from_array(board);
+        int back[4][4];
+        bb_to_array(b, back);
+        if (!same_board(board, back)) fail++;
+        if (bb_is_over(b) != ref_is_over(board)) fail++;
+
+        int empty = 0;
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 4; j++)
+                if (board[i][j] == 0) empty++;
+        if (bb_count_empty(b) != empty) fail++;
+
+        // 빈칸/같은 타일 마스크와 칸 고르기 (고른 칸은 항상 후보 안에 있어야 함)
+        uint16_t empty_mask = 0, two_mask = 0;
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+                if (board[i][j] == 0) empty_mask |= 1u << (4 * i + j);
+                if (board[i][j] == 2) two_mask |= 1u << (4 * i + j);
+            }
+        }
+        if (bb_empty_mask(b) != empty_mask || bb_match_mask(b, 1) != two_mask) fail++;
+        Rng rng;
+        rng_seed(&rng, n, 0);
+        int cell = bb_pick_cell(empty_mask, &rng);
+        if (empty_mask ? !(empty_mask >> cell & 1) : cell != -1) fail++;
+
+        for (int d = UP; d <= RIGHT; d++) {
+            int expect[4][4], got[4][4];
+            for (int i = 0; i < 4; i++)
+                for (int j = 0; j < 4; j++) expect[i][j] = board[i][j];
+
+            int expect_score = ref_move(expect, (Direction)d);
+            int got_score = 0;
+            bb_to_array(bb_move(b, (Direction)d, &got_score), got);
+
+            if (expect_score != got_score || !same_board(expect, got)) fail++;
+            if (bb_can_move(b, (Direction)d) != !same_board(expect, board)) fail++;
+        }
+    }
+
+    // 가장 큰 타일끼리는 합쳐지지 않음: 32768|32768 행은 움직이지 않고 점수도 없음, 16384 둘은 32768이 됨
+    GameState g = {0};
+    g.board[0][0] = g.board[0][1] = MAX_TILE;
+    game_move(&g, LEFT);
+    if (g.moved || g.score != 0 || g.board[0][0] != MAX_TILE || g.board[0][1] != MAX_TILE) fail++;
+    g.board[1][0] = g.board[1][1] = MAX_TILE / 2;
+    game_move(&g, LEFT);
+    if (!g.moved || g.score != MAX_TILE || g.board[1][0] != MAX_TILE || g.board[1][1] != 0) fail++;
+
+    // 빈칸 없이 32768끼리만 이웃한 보드는 게임 오버 (int 판정과 비트보드 판정이 같음)
+    GameState full = {0};
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++) full.board[i][j] = ((i + j) % 2) ? 2 : 4;
+    full.board[0][0] = full.board[0][1] = MAX_TILE;   // 가로
+    full.board[2][3] = full.board[3][3] = MAX_TILE;   // 세로
+    Board fb = bb_from_array(full.board);
+    if (!game_is_over(&full) || !bb_is_over(fb)) fail++;
+    for (int d = UP; d <= RIGHT; d++) {
+        if (bb_can_move(fb, (Direction)d)) fail++;
+    }
+    return fail;
+}
+
+// 모든 지수(0~15)가 나오는 무작위 비트보드, 2^15 합치기 제한까지 포함
+static Board random_bitboard(void) {
+    Board b = 0;
+    for (int i = 0; i < 16; i++) {
+        Board e = (rand() % 3 == 0) ? 0 : (Board)(rand() % 16);
+        b |= e << (4 * i);
+    }
+    return b;
+}
+
+// 이 CPU가 지원하는 SIMD 커널이 스칼라(테이블) 커널과 같은 결과를 내는지 검증
+static int test_kernels(int rounds) {
+    int fail = 0;
+    for (int k = BB_KERNEL_SSE41; k <= BB_KERNEL_AVX2; k++) {
+        if (!bb_kernel_supported((BbKernel)k)) {
+            printf("   [%s] 지원 안 함, 건너뜀\n", bb_kernel_name((BbKernel)k));
+            continue;
+        }
+        int kernel_fail = 0;
+        for (int n = 0; n < rounds; n++) {
+            Board b = random_bitboard();
+            Board expect[4], got[4], got_all[4];
+            int expect_score[4], got_score[4], got_all_score[4];
+
+            bb_set_kernel(BB_KERNEL_SCALAR);
+            bb_move_all(b, expect, expect_score);
+
+            bb_set_kernel((BbKernel)k);
+            bb_move_all(b, got_all, got_all_score);
+            for (int d = UP; d <= RIGHT; d++) {
+                got[d] = bb_move(b, (Direction)d, &got_score[d]);
+                if (got[d] != expect[d] || got_score[d] != expect_score[d]) kernel_fail++;
+                if (got_all[d] != expect[d] || got_all_score[d] != expect_score[d]) kernel_fail++;
+            }
+        }
+        printf("   [%s] 불일치 %d건\n", bb_kernel_name((BbKernel)k), kernel_fail);
+        fail += kernel_fail;
+    }
+    return fail;
+}
+
+// 같은 난수 시드로 배치를 AVX2/스칼라 커널로 각각 끝까지 돌려서 결과가 같은지 검증
+static int run_batch(BbKernel k, int count, int steps, GameBatch *out) {
+    bb_set_kernel(k);
+    if (game_batch_init(out, count, 1234) != 0) return 1;
+
+    Direction *dirs = malloc(sizeof(Direction) * count);
+    int *delta = malloc(sizeof(int) * count);
+    for (int s = 0; s < steps; s++) {
+        for (int i = 0; i < count; i++) dirs[i] = (Direction)((i + s * 7 + (s >> 3)) & 3);
+        game_batch_step(out, dirs, delta, NULL, NULL);
+        // 128점 이상이면 옆 게임에 공격 (서버의 공격 규칙과 같은 흐름)
+        for (int i = 0; i < count; i++) {
+            if (delta[i] >= 128) game_batch_queue_attack(out, (i + 1) % count, 2);
+        }
+    }
+    free(dirs);
+    free(delta);
+    return 0;
+}
+
+static int test_batch(void) {
+    if (!bb_kernel_supported(BB_KERNEL_AVX2)) {
+        printf("   [avx2] 지원 안 함, 건너뜀\n");
+        return 0;
+    }
+    int count = 1003, steps = 2000; // 4의 배수가 아닌 개수로 나머지 처리까지 확인
+    GameBatch scalar, avx2;
+    int fail = run_batch(BB_KERNEL_SCALAR, count, steps, &scalar);
+    fail += run_batch(BB_KERNEL_AVX2, count, steps, &avx2);
+
+    int over = 0;
+    for (int i = 0; i < count && fail == 0; i++) {
+        if (scalar.boards[i] != avx2.boards[i] || scalar.scores[i] != avx2.scores[i] ||
+            scalar.game_over[i] != avx2.game_over[i] || scalar.attack_cnt[i] != avx2.attack_cnt[i]) {
+            fail++;
+        }
+        // 게임 오버 판정이 기존 함수와 같은지
+        GameState st;
+        game_batch_get(&avx2, i, &st);
+        if ((bool)avx2.game_over[i] != game_is_over(&st)) fail++;
+        over += avx2.game_over[i];
+    }
+    printf("   %d게임 x %d스텝, 게임 오버 %d개\n", count, steps, over);
+    game_batch_free(&scalar);
+    game_batch_free(&avx2);
+    return fail;
+}
+
+// 같은 시드면 같은 게임, 다른 스트림이면 다른 게임이 나오는지 검증
+static int test_seeded(void) {
+    GameState a, b, c;
+    game_init_seeded(&a, 42, 7);
+    game_init_seeded(&b, 42, 7);
+    game_init_seeded(&c, 42, 8);
+
+    bool differs = false;
+    for (int n = 0; n < 500; n++) {
+        Direction d = (Direction)(n % 4);
+        GameState *games[3] = {&a, &b, &c};
+        for (int g = 0; g < 3; g++) {
+            game_move(games[g], d);
+            if (games[g]->moved) game_spawn_tile(games[g]);
+            if (n % 10 == 0) game_queue_attack(games[g], 2);
+            game_execute_attack(games[g]);
+            game_is_over(games[g]);
+        }
+        if (!same_board(a.board, b.board) || a.score != b.score) return 1;
+        if (!same_board(a.board, c.board)) differs = true;
+    }
+    if (!differs) return 1;
+
+    // 빈 보드에 타일 생성: 4가 나올 확률 10%, 16칸 모두 고르게
+    int fours = 0, per_cell[16] = {0};
+    int spawns = 200000;
+    Rng rng;
+    rng_seed(&rng, 1, 0);
+    for (int n = 0; n < spawns; n++) {
+        Board b = bb_spawn(0, &rng);
+        int cell = __builtin_ctzll(b) / 4;
+        per_cell[cell]++;
+        if (BB_CELL(b, cell / 4, cell % 4) == 2) fours++;
+    }
+    if (fours < spawns * 0.09 || fours > spawns * 0.11) return 1;
+    for (int i = 0; i < 16; i++) {
+        if (per_cell[i] < spawns / 16 * 0.95 || per_cell[i] > spawns / 16 * 1.05) return 1;
+    }
+    return 0;
+}
+
+// 얕은 깊이 AI로 시드 게임을 끝까지 진행: 움직일 수 있는데 이동을 못 고르거나
+// 고른 이동이 보드를 바꾸지 못하면 실패, 무작위 이동보다 확실히 오래 버텨야 함
+static int test_ai(int *out_score, int *out_max) {
+    AiConfig config;
+    ai_default_config(&config);
+    config.depth = 3;
+    AiSearch *ai = ai_create(&config);
+    if (!ai) return 1;
+
+    int fail = 0;
+    GameState g;
+    game_init_seeded(&g, 2048, 0);
+    while (!g.game_over) {
+        AiResult r = ai_best_move(ai, &g);
+        if (!r.valid) {
+            fail++;
+            break;
+        }
+        game_move(&g, r.move);
+        if (!g.moved) fail++;
+        else game_spawn_tile(&g);
+        game_is_over(&g);
+    }
+    ai_destroy(ai);
+
+    // 같은 보드는 같은 결과 (트랜스포지션 테이블 세대가 바뀌어도 값이 흔들리지 않음)
+    AiSearch *a = ai_create(&config);
+    AiSearch *b = ai_create(&config);
+    if (!a || !b) fail++;
+    else {
+        Board board = 0x0000000100210321ULL;
+        AiResult ra = ai_search(a, board);
+        ai_search(b, 0x1000200030004ULL);
+        AiResult rb = ai_search(b, board);
+        if (ra.move != rb.move || ra.expected != rb.expected) fail++;
+    }
+    ai_destroy(a);
+    ai_destroy(b);
+
+    // 병렬 탐색(스레드 4개)은 같은 깊이에서 단일 스레드와 거의 같은 기대값을 내야 함
+    // (트랜스포지션 테이블 재사용 순서가 달라서 값이 조금 다를 수 있음)
+    AiConfig par_config = config;
+    par_config.depth = 5;
+    par_config.threads = 4;
+    config.depth = 5;
+    AiSearch *single = ai_create(&config);
+    AiSearch *par = ai_create(&par_config);
+    if (!single || !par) fail++;
+    else {
+        Rng rng;
+        rng_seed(&rng, 99, 0);
+        Board board = bb_spawn(bb_spawn(0, &rng), &rng);
+        for (int n = 0; n < 40; n++) {
+            AiResult rs = ai_search(single, board);
+            AiResult rp = ai_search(par, board);
+            if (!rs.valid) break;
+            if (!rp.valid || rp.depth != 5) fail++;
+            if (fabsf(rs.expected - rp.expected) > rs.expected * 0.01f) fail++;
+            int score;
+            board = bb_spawn(bb_move(board, rs.move, &score), &rng);
+        }
+
+        // 시간 제한 탐색: 최소 깊이 2는 보장하고 제한을 크게 넘기지 않음
+        ai_destroy(par);
+        par_config.depth = 0;
+        par_config.time_ms = 20;
+        par = ai_create(&par_config);
+        if (!par) fail++;
+        else {
+            struct timespec t0, t1;
+            clock_gettime(CLOCK_MONOTONIC, &t0);
+            AiResult r = ai_search(par, 0x0000000100210321ULL);
+            clock_gettime(CLOCK_MONOTONIC, &t1);
+            double ms = (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) * 1e-6;
+            printf("   [threads 4, 20ms] 깊이 %d, %.1fms\n", r.depth, ms);
+            if (!r.valid || r.depth < 2 || ms > 200) fail++;
+        }
+    }
+    ai_destroy(single);
+    ai_destroy(par);
+
+    *out_score = g.score;
+    *out_max = bb_max_tile(bb_from_array(g.board));
+    if (*out_max < 512) fail++;
+    return fail;
+}
+
+// 타이머 휠: 무작위로 걸기/끄기/다시 걸기를 섞으면서 가상 시간을 진행하고,
+// 모든 타이머가 만료 tick보다 일찍도 늦게도 아니게 정확히 한 번 꺼내지는지 검증
+// (휠 범위(2^24 tick)보다 먼 타이머, 만료 직후 다시 거는 타이머 포함)
+#define WHEEL_TEST_TIMERS 1000
+
+static int test_timer_wheel(int steps) {
+    static TimerWheel w;
+    static WheelTimer timers[WHEEL_TEST_TIMERS];
+    static const uint32_t ranges[4] = {64, 4096, 1u << 18, 1u << 26};
+    int fail = 0, fired = 0;
+    Rng rng;
+    rng_seed(&rng, 13, 0);
+
+    uint64_t now = 0;
+    wheel_init(&w, now);
+    for (int i = 0; i < WHEEL_TEST_TIMERS; i++) wheel_timer_init(&timers[i]);
+
+    for (int s = 0; s < steps; s++) {
+        // 타이머 몇 개를 끄거나 (다시) 검
+        for (int k = 0; k < 4; k++) {
+            WheelTimer *t = &timers[rng_below(&rng, WHEEL_TEST_TIMERS)];
+            if (rng_below(&rng, 3) == 0) wheel_del(&w, t);
+            else wheel_add(&w, t, now + 1 + rng_below(&rng, ranges[rng_below(&rng, 4)]));
+        }
+
+        // 다음에 일할 tick이 어떤 타이머의 만료보다 늦으면 안 됨
+        uint64_t earliest = UINT64_MAX, next;
+        for (int i = 0; i < WHEEL_TEST_TIMERS; i++) {
+            if (wheel_timer_active(&timers[i]) && timers[i].expires < earliest) earliest = timers[i].expires;
+        }
+        bool has_next = wheel_next(&w, &next);
+        if (has_next != (earliest != UINT64_MAX) || (has_next && next > earliest)) fail++;
+
+        // 시간 진행: 가끔은 루프처럼 wheel_next가 알려 준 tick으로 바로 건너뜀
+        uint64_t target = now + 1 + rng_below(&rng, ranges[rng_below(&rng, 3)]);
+        if (has_next && rng_below(&rng, 2) == 0 && next > now) target = next;
+
+        WheelTimer *t;
+        while ((t = wheel_expire(&w, target)) != NULL) {
+            if (t->expires <= now || t->expires > target || wheel_timer_active(t)) fail++;
+            fired++;
+            // 콜백처럼 만료 직후 다시 걸기
+            if (rng_below(&rng, 2) == 0) wheel_add(&w, t, target + 1 + rng_below(&rng, 4096));
+        }
+        now = target;
+
+        // 만료 tick이 지났는데 남아 있는 타이머가 없어야 함
+        for (int i = 0; i < WHEEL_TEST_TIMERS; i++) {
+            if (wheel_timer_active(&timers[i]) && timers[i].expires <= now) fail++;
+        }
+    }
+    printf("   %d스텝, 만료 %d번, 가상 시간 %llu tick\n", steps, fired, (unsigned long long)now);
+    return fail;
+}
+
+// 전송 대기열: 소켓 버퍼가 작은 TCP 연결(루프백)에 공유 버퍼와 개별 데이터를 섞어 넣고 받는 쪽은 조금씩 읽으면서,
+// 두 연결이 보낸 순서 그대로 빠짐없이 받는지, 다 보낸 버퍼의 참조가 풀리는지, 상한을 넘는 push는 거절되는지 검증
+#define SQ_TEST_LIMIT (16 * 1024)
+
+// 루프백 TCP 연결 한 쌍 (유닉스 소켓은 작은 쓰기를 나눠 보내지 않아서 일부만 보낸 경우를 만들 수 없음)
+static int tcp_pair(int fds[2]) {
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+    socklen_t len = sizeof(addr);
+    int ls = socket(AF_INET, SOCK_STREAM, 0);
+    if (ls < 0) return -1;
+    if (bind(ls, (struct sockaddr *)&addr, len) < 0 || listen(ls, 1) < 0 ||
+        getsockname(ls, (struct sockaddr *)&addr, &len) < 0) {
+        close(ls);
+        return -1;
+    }
+    fds[0] = socket(AF_INET, SOCK_STREAM, 0);
+    int buf = 4096;
+    setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &buf, sizeof(buf));
+    if (fds[0] < 0 || connect(fds[0], (struct sockaddr *)&addr, len) < 0) {
+        close(ls);
+        return -1;
+    }
+    fds[1] = accept(ls, NULL, NULL);
+    close(ls);
+    if (fds[1] < 0) return -1;
+    setsockopt(fds[1], SOL_SOCKET, SO_RCVBUF, &buf, sizeof(buf));
+    return 0;
+}
+
+static int test_send_queue(int frames) {
+    int fail = 0, fds[2][2];
+    SendQueue q[2];
+    size_t expect[2] = {0, 0};    // 받은 바이트 수 (n번째 바이트의 값은 n % 256)
+    size_t sent[2] = {0, 0};
+    size_t received = 0;
+    int rejected = 0;
+    Rng rng;
+    rng_seed(&rng, 17, 0);
+
+    for (int k = 0; k < 2; k++) {
+        if (tcp_pair(fds[k]) < 0) return 1;
+        fcntl(fds[k][0], F_SETFL, O_NONBLOCK);
+        fcntl(fds[k][1], F_SETFL, O_NONBLOCK);
+        send_queue_init(&q[k], SQ_TEST_LIMIT);
+    }
+
+    for (int f = 0; f < frames; f++) {
+        uint8_t data[1500];
+        size_t len = 1 + rng_below(&rng, sizeof(data));
+
+        if (rng_below(&rng, 2) == 0) {
+            // 공유 버퍼 하나를 두 대기열에 (두 연결의 다음 바이트 값이 같을 때만)
+            if ((uint8_t)sent[0] == (uint8_t)sent[1]) {
+                for (size_t i = 0; i < len; i++) data[i] = (uint8_t)(sent[0] + i);
+                SharedBuf *b = shared_buf_new(data, len);
+                size_t before[2] = {q[0].bytes, q[1].bytes};
+                bool ok[2];
+                for (int k = 0; k < 2; k++) ok[k] = (send_queue_push(&q[k], b) == 0);
+                for (int k = 0; k < 2; k++) {
+                    if (!ok[k] && (q[k].bytes != before[k] || before[k] + len <= SQ_TEST_LIMIT)) fail++;
+                    if (ok[k]) sent[k] += len;
+                    else rejected++;
+                }
+                if (b->refs != 1 + (ok[0] ? 1 : 0) + (ok[1] ? 1 : 0)) fail++;
+                shared_buf_unref(b);
+            }
+        } else {
+            int k = (int)rng_below(&rng, 2);
+            for (size_t i = 0; i < len; i++) data[i] = (uint8_t)(sent[k] + i);
+            size_t before = q[k].bytes;
+            int ret = send_queue_write(&q[k], fds[k][0], data, len);
+            if (ret < 0) {
+                if (q[k].bytes != before || before + len <= SQ_TEST_LIMIT) fail++;
+                rejected++;
+            } else {
+                sent[k] += len;
+            }
+        }
+
+        // 받는 쪽은 가끔, 조금씩 읽고 한동안은 아예 읽지 않음 (소켓 버퍼가 차서 대기열이 상한까지 쌓이게)
+        bool stalled = (f / 1000) % 2 == 1;
+        for (int k = 0; k < 2; k++) {
+            if (!stalled && rng_below(&rng, 4) == 0) {
+                uint8_t buf[4096];
+                ssize_t n = read(fds[k][1], buf, 1 + rng_below(&rng, sizeof(buf)));
+                for (ssize_t i = 0; i < n; i++) {
+                    if (buf[i] != (uint8_t)expect[k]) fail++;
+                    expect[k]++;
+                }
+                if (n > 0) received += (size_t)n;
+            }
+            if (send_queue_flush(&q[k], fds[k][0]) < 0) fail++;
+            if (q[k].bytes > SQ_TEST_LIMIT) fail++;
+        }
+    }
+
+    // 끝까지 받아서 보낸 것과 맞춰 봄
+    for (int k = 0; k < 2; k++) {
+        for (int spin = 0; spin < 1000 && !(send_queue_empty(&q[k]) && expect[k] == sent[k]); spin++) {
+            uint8_t buf[4096];
+            struct pollfd pfd = { .fd = fds[k][1], .events = POLLIN };
+            poll(&pfd, 1, 10);
+            ssize_t n = read(fds[k][1], buf, sizeof(buf));
+            for (ssize_t i = 0; i < n; i++) {
+                if (buf[i] != (uint8_t)expect[k]) fail++;
+                expect[k]++;
+            }
+            if (n > 0) received += (size_t)n;
+            if (send_queue_flush(&q[k], fds[k][0]) < 0) fail++;
+        }
+        if (!send_queue_empty(&q[k]) || q[k].bytes != 0 || expect[k] != sent[k]) fail++;
+        send_queue_free(&q[k]);
+        close(fds[k][0]);
+        close(fds[k][1]);
+    }
+    printf("   %d프레임, 받은 바이트 %zu, 상한 초과로 거절 %d번\n", frames, received, rejected);
+    return fail;
+}
+
+// 수신 링 버퍼: 버전 3 요청(길이 바이트 + 요청 종류 + 가끔 덧붙인 바이트)을 임의의 크기로 잘라 파이프에 쓰고,
+// 링보다 작은 버퍼로 조금씩 받아 꺼내면서 (링이 여러 바퀴 돌도록) 보낸 요청을 순서대로 모두 꺼내는지 검증
+#define RB_TEST_CAP 64
+
+static int test_recv_buf(int requests) {
+    int fail = 0, fds[2];
+    RecvBuf rb;
+    Rng rng;
+    rng_seed(&rng, 19, 0);
+    if (pipe(fds) < 0 || recv_buf_init(&rb, RB_TEST_CAP) < 0) return 1;
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+
+    uint8_t pending[4096];      // 아직 파이프에 쓰지 않은 바이트
+    size_t pending_len = 0;
+    int sent = 0, parsed = 0, fills = 0;
+
+    while (parsed < requests) {
+        // 요청 몇 개를 만들어 쌓아 두고 임의의 크기만큼 파이프에 씀
+        while (sent < requests && pending_len + WIRE_MAX_REQUEST <= sizeof(pending) && rng_below(&rng, 3) != 0) {
+            uint8_t *p = pending + pending_len;
+            size_t len = wire_encode_request(p, 3, (uint8_t)(sent & 0x7F), -1);
+            size_t extra = rng_below(&rng, 4) == 0 ? rng_below(&rng, WIRE_MAX_REQUEST - len) : 0;
+            p[0] = (uint8_t)(p[0] + extra); // 이후 버전이 덧붙일 바이트 (받는 쪽은 건너뜀)
+            for (size_t i = 0; i < extra; i++) p[len + i] = 0xEE;
+            pending_len += len + extra;
+            sent++;
+        }
+        if (pending_len > 0) {
+            size_t chunk = 1 + rng_below(&rng, (uint32_t)pending_len);
+            ssize_t n = write(fds[1], pending, chunk);
+            if (n > 0) {
+                memmove(pending, pending + n, pending_len - (size_t)n);
+                pending_len -= (size_t)n;
+            }
+        }
+
+        ssize_t n = recv_buf_fill(&rb, fds[0]);
+        if (n > 0) fills++;
+        else if (n < 0 && errno != EAGAIN && errno != ENOBUFS) fail++;
+        if (rb.len > rb.cap) fail++;
+
+        // 완성된 요청은 모두 꺼냄 (가끔은 꺼내지 않고 링을 채워 둠)
+        if (rng_below(&rng, 4) == 0) continue;
+        uint8_t req[WIRE_MAX_REQUEST];
+        for (;;) {
+            size_t avail = recv_buf_peek(&rb, req, sizeof(req));
+            int size = wire_request_size(req, avail, 3);
+            if (size < 0) {
+                fail++;
+                break;
+            }
+            if (size == 0 || (size_t)size > avail) break;
+            if (wire_request_code(req, 3) != (parsed & 0x7F)) fail++;
+            recv_buf_consume(&rb, (size_t)size);
+            parsed++;
+        }
+    }
+
+    // 가득 찬 링에는 읽지 않음
+    uint8_t fill[RB_TEST_CAP];
+    memset(fill, 0, sizeof(fill));
+    if (write(fds[1], fill, sizeof(fill)) != (ssize_t)sizeof(fill)) fail++;
+    while (recv_buf_fill(&rb, fds[0]) > 0) {}
+    if (rb.len != rb.cap || recv_buf_fill(&rb, fds[0]) != -1 || errno != ENOBUFS) fail++;
+
+    recv_buf_free(&rb);
+    close(fds[0]);
+    close(fds[1]);
+    printf("   요청 %d개, 링 %d바이트, 읽기 %d번\n", parsed, RB_TEST_CAP, fills);
+    return fail;
+}
+
+// 압축 전송 형식: 실제 게임에서 나온 패킷을 인코딩/디코딩해서 원래 패킷과 같은지,
+// 잘린 패킷은 "더 필요", 망가진 패킷은 오류로 처리하는지 검증
+static int same_packet(const S2C_Packet *a, const S2C_Packet *b) {
+    if (memcmp(a->my_board, b->my_board, sizeof(a->my_board)) || memcmp(a->opp_board, b->opp_board, sizeof(a->opp_board))) return 0;
+    if (a->my_score != b->my_score || a->opp_score != b->opp_score || a->game_status != b->game_status) return 0;
+    if (a->attack_count != b->attack_count || memcmp(a->pending_attacks, b->pending_attacks, sizeof(int) * (size_t)a->attack_count)) return 0;
+    return a->highlight_r == b->highlight_r && a->highlight_c == b->highlight_c && a->is_hit == b->is_hit;
+}
+
+static int test_wire(int games, size_t *out_max_size, double *out_full, double *out_delta) {
+    int fail = 0;
+    size_t max_size = 0, full_bytes = 0, delta_bytes = 0, frames = 0;
+    uint8_t hello[WIRE_HELLO_SIZE];
+    wire_hello(hello, WIRE_VERSION);
+    if (wire_parse_hello(hello) != WIRE_VERSION) fail++;
+    // 예전 클라이언트의 요청(0~4)은 hello로 보이면 안 됨
+    for (int a = MOVE_UP; a <= QUIT; a++) {
+        C2S_Packet req = { .action = (ClientAction)a };
+        if (wire_parse_hello((const uint8_t *)&req) >= 0) fail++;
+        ClientAction back;
+        if (wire_decode_action(wire_encode_action(req.action), &back) < 0 || back != req.action) fail++;
+        if (wire_decode_raw((const uint8_t *)&req, &back) < 0 || back != req.action) fail++;
+    }
+    // 예전 형식 요청도 범위 밖 행동은 디코딩하지 않음 (서버는 그 요청을 버림)
+    static const int32_t bad_raw[] = { QUIT + 1, 7, -1, 0x100, INT32_MIN };
+    for (size_t i = 0; i < sizeof(bad_raw) / sizeof(bad_raw[0]); i++) {
+        ClientAction back;
+        if (wire_decode_raw((const uint8_t *)&bad_raw[i], &back) == 0) fail++;
+    }
+
+    for (int g = 0; g < games; g++) {
+        WireStream tx, rx, fresh;
+        wire_stream_init(&tx);
+        wire_stream_init(&rx);
+        GameState me, opp;
+        game_init_seeded(&me, 500 + (uint64_t)g, 0);
+        game_init_seeded(&opp, 500 + (uint64_t)g, 1);
+        for (int n = 0; !me.game_over; n++) {
+            int gained = game_move(&me, (Direction)(n % 4));
+            if (me.moved) game_spawn_tile(&me);
+            game_execute_attack(&me);
+            game_is_over(&me);
+            game_send_attack(&me, &opp, gained);
+
+            S2C_Packet pkt, back;
+            memset(&pkt, 0, sizeof(pkt));
+            memcpy(pkt.my_board, me.board, sizeof(pkt.my_board));
+            memcpy(pkt.opp_board, opp.board, sizeof(pkt.opp_board));
+            pkt.my_score = me.score;
+            pkt.opp_score = opp.score * 1000; // 여러 바이트짜리 varint도 거치도록
+            memcpy(pkt.pending_attacks, opp.attack_queue, sizeof(int) * MAX_ATTACK_QUEUE);
+            pkt.attack_count = opp.attack_cnt;
+            pkt.highlight_r = me.highlight_r;
+            pkt.highlight_c = me.highlight_c;
+            pkt.is_hit = (n % 3 == 0);
+            pkt.game_status = (GameStatus)(n % 5);
+            if (opp.attack_cnt >= MAX_ATTACK_QUEUE) game_execute_attack(&opp);
+
+            uint8_t buf[WIRE_MAX_PACKET + 1];
+            size_t len = wire_encode_packet(&pkt, buf);
+            if (len > max_size) max_size = len;
+            if (len > WIRE_MAX_PACKET) fail++;
+            if (wire_decode_packet(buf, len, &back) != (int)len || !same_packet(&pkt, &back)) fail++;
+            if (wire_decode_packet(buf, len - 1, &back) != 0) fail++;
+
+            // 델타 스트림: 가끔 키프레임을 강제하고, 받는 쪽이 보낸 쪽과 같은 상태를 복원하는지
+            uint8_t frame[WIRE_MAX_PACKET];
+            // 입력 번호는 몇 번에 한 번씩 바뀌고 65535에서 0으로 돎 (첫 게임은 번호 없이)
+            int ack = g == 0 ? -1 : (int)((65530u + (unsigned)n / 3) & 0xFFFF);
+            size_t frame_len = wire_encode_stream(&tx, &pkt, ack, frame, n % 50 == 49);
+            if (frame_len > WIRE_MAX_PACKET) fail++;
+            if (wire_decode_stream(&rx, frame, frame_len, &back) != (int)frame_len || !same_packet(&pkt, &back)) fail++;
+            if (rx.ack != ack) fail++;
+            // 기준 상태가 없는 쪽은 델타를 거부해야 함 (키프레임은 받아들임)
+            wire_stream_init(&fresh);
+            int fresh_ret = wire_decode_stream(&fresh, frame, frame_len, &back);
+            if (tx.since_key == 0 ? fresh_ret != (int)frame_len : fresh_ret != -1) fail++;
+            full_bytes += len;
+            delta_bytes += frame_len;
+            frames++;
+
+            // 알 수 없는 상태 값, 길이와 맞지 않는 공격 개수
+            uint8_t bad[WIRE_MAX_PACKET + 1];
+            memcpy(bad, buf, len);
+            bad[1] |= 0x7;
+            if (wire_decode_packet(bad, len, &back) != -1) fail++;
+            memcpy(bad, buf, len);
+            bad[len - 1 - (pkt.attack_count + 1) / 2] = 11;
+            if (wire_decode_packet(bad, len, &back) != -1) fail++;
+        }
+    }
+    *out_max_size = max_size;
+    *out_full = (double)full_bytes / (double)frames;
+    *out_delta = (double)delta_bytes / (double)frames;
+    return fail;
+}
+
+// 클라이언트 예측: 서버(가짜)가 입력을 늦게 처리하는 동안 예측 화면이 맞는지
+// - 서버와 맞춰진 상태에서 누른 키 하나는 서버의 이동 결과와 같아야 함 (새 타일 제외)
+// - 서버가 모든 입력을 처리한 상태가 오면 예측 화면은 서버 상태 그대로
+// - 입력 번호가 65535에서 0으로 돌아도 확인된 입력만 버림
+static int test_predict(int steps, int *out_max_pending) {
+    int fail = 0, max_pending = 0;
+    Rng rng;
+    rng_seed(&rng, 23, 0);
+    GameState server, opp;
+    game_init_seeded(&server, 23, 0);
+    game_init_seeded(&opp, 23, 1);
+    WireStream tx, rx;
+    wire_stream_init(&tx);
+    wire_stream_init(&rx);
+
+    Predictor pred;
+    predict_init(&pred);
+    pred.next_seq = 65500; // 번호가 한 바퀴 도는 경우도 지나가도록
+
+    uint8_t flight[256][WIRE_MAX_REQUEST]; // 서버로 가는 중인 요청
+    int flight_head = 0, flight_count = 0;
+    bool dropped = false;
+    S2C_Packet pkt, back, view;
+
+    for (int step = 0; step < steps; step++) {
+        if (server.game_over) game_init_seeded(&server, 23 + (uint64_t)step, 0);
+
+        // 키 입력: 예측에 기록하고 번호를 붙여 보냄
+        if (flight_count < 200 && rng_below(&rng, 2) == 0) {
+            Direction dir = (Direction)rng_below(&rng, 4);
+            bool synced = pred.has_server && flight_count == 0 && pred.server.game_status == GAME_PLAYING &&
+                          !memcmp(pred.server.my_board, server.board, sizeof(server.board));
+            int seq = predict_input(&pred, dir);
+            uint8_t *req = flight[(flight_head + flight_count++) % 256];
+            size_t len = wire_encode_request(req, 4, wire_encode_action((ClientAction)dir), seq);
+            if (wire_request_size(req, len, 4) != (int)len || wire_request_code(req, 4) != (int)dir ||
+                wire_request_seq(req, 4) != seq) fail++;
+
+            if (synced) {
+                GameState moved = server;
+                game_move(&moved, dir);
+                if (!predict_view(&pred, &view) || memcmp(view.my_board, moved.board, sizeof(moved.board)) ||
+                    view.my_score != moved.score) fail++;
+            }
+        }
+        // 기록이 넘친 적이 없으면 가는 중인 입력이 모두 기록되어 있어야 함
+        if (flight_count > max_pending) max_pending = flight_count;
+        if (flight_count > PREDICT_MAX_PENDING) dropped = true;
+        if (pred.count > flight_count || (!dropped && pred.count != flight_count)) fail++;
+
+        // 서버: 가끔 몰아서 처리하고, 처리할 때마다 상태와 마지막 입력 번호를 보냄
+        if (flight_count == 0 || rng_below(&rng, 24) != 0) continue;
+        int batch = 1 + (int)rng_below(&rng, (uint32_t)flight_count);
+        for (int i = 0; i < batch; i++) {
+            uint8_t *req = flight[flight_head];
+            flight_head = (flight_head + 1) % 256;
+            flight_count--;
+
+            ClientAction action;
+            if (wire_decode_action((uint8_t)wire_request_code(req, 4), &action) < 0) fail++;
+            int gained = game_move(&server, (Direction)action);
+            if (server.moved) game_spawn_tile(&server);
+            game_execute_attack(&server);
+            game_is_over(&server);
+            game_send_attack(&server, &opp, gained);
+            if (rng_below(&rng, 8) == 0) game_queue_attack(&server, 2);
+
+            memset(&pkt, 0, sizeof(pkt));
+            memcpy(pkt.my_board, server.board, sizeof(pkt.my_board));
+            memcpy(pkt.opp_board, opp.board, sizeof(pkt.opp_board));
+            pkt.my_score = server.score;
+            pkt.highlight_r = server.highlight_r;
+            pkt.highlight_c = server.highlight_c;
+            pkt.game_status = server.game_over ? GAME_LOSE : GAME_PLAYING;
+
+            uint8_t frame[WIRE_MAX_PACKET];
+            size_t frame_len = wire_encode_stream(&tx, &pkt, wire_request_seq(req, 4), frame, false);
+            if (wire_decode_stream(&rx, frame, frame_len, &back) != (int)frame_len) fail++;
+            predict_server_state(&pred, &back, rx.ack);
+        }
+        if (flight_count > 0) continue;
+        if (!predict_view(&pred, &view) || pred.count != 0 || !same_packet(&view, &pkt)) fail++;
+        dropped = false;
+    }
+    *out_max_pending = max_pending;
+    return fail;
+}
+
+// 록스텝: 서버 쪽 두 게임과, 사건만 받아서 진행하는 두 클라이언트가 매번 같은 상태인지
+// 이동/건너뜀/대기 공격, 진행 중인 상대에게 새로 앉기(상태 사건), 나가고 다시 앉기(시드 사건)를 섞음
+typedef struct {
+    GameState games[2];
+    bool seated[2];
+    Lockstep views[2];
+    size_t bytes, events;
+    int fail;
+} LockRoom;
+
+// actor 자리의 사건을 앉아 있는 자리(only >= 0이면 그 자리만)에 인코딩해서 보내고 적용
+static void lock_deliver(LockRoom *r, int actor, LockEventType type, Direction dir, int only) {
+    for (int seat = 0; seat < 2; seat++) {
+        if (!r->seated[seat] || (only >= 0 && seat != only)) continue;
+        LockEvent ev = { .type = type, .who = seat == actor ? 0 : 1, .dir = dir };
+        ev.seed = 1000 + (uint64_t)actor;
+        ev.stream = actor;
+        ev.state = r->games[actor];
+
+        uint8_t buf[WIRE_MAX_LOCK], back[WIRE_MAX_LOCK];
+        LockEvent got;
+        size_t len = wire_encode_lock(&ev, buf);
+        if (len > WIRE_MAX_LOCK || wire_decode_lock(buf, len, &got) != (int)len) r->fail++;
+        if (wire_decode_lock(buf, len - 1, &got) != 0) r->fail++;
+        if (wire_encode_lock(&got, back) != len || memcmp(buf, back, len)) r->fail++;
+        if (lockstep_apply(&r->views[seat], &got) < 0) r->fail++;
+        if (type == LOCK_MOVE) {
+            r->bytes += len;
+            r->events++;
+        }
+    }
+}
+
+static void lock_sit(LockRoom *r, int seat) {
+    int other = 1 - seat;
+    game_init_seeded(&r->games[seat], 1000 + (uint64_t)seat, (uint64_t)seat);
+    r->seated[seat] = true;
+    lockstep_init(&r->views[seat]);
+    lock_deliver(r, seat, LOCK_SEED, UP, -1);
+    if (r->seated[other]) lock_deliver(r, other, LOCK_STATE, UP, seat);
+}
+
+static int test_lockstep(int steps, double *out_bytes) {
+    LockRoom r;
+    memset(&r, 0, sizeof(r));
+    Rng rng;
+    rng_seed(&rng, 29, 0);
+    lock_sit(&r, 0);
+    lock_sit(&r, 1);
+
+    for (int step = 0; step < steps; step++) {
+        int actor = (int)rng_below(&rng, 2);
+        GameState *me = &r.games[actor];
+        uint32_t pick = rng_below(&rng, 64);
+
+        if (pick == 0 || (me->game_over && r.games[1 - actor].game_over)) {
+            // 나갔다가 다시 앉음 (남은 쪽은 게임을 이어 감)
+            r.seated[actor] = false;
+            lock_deliver(&r, actor, LOCK_LEAVE, UP, -1);
+            lock_sit(&r, actor);
+        } else if (pick < 6) {
+            game_execute_attack(me);
+            game_is_over(me);
+            lock_deliver(&r, actor, LOCK_IDLE, UP, -1);
+        } else if (!me->game_over) {
+            Direction dir = (Direction)rng_below(&rng, 4);
+            int attacks = game_play_move(me, &r.games[1 - actor], dir);
+            lock_deliver(&r, actor, LOCK_MOVE, dir, -1);
+            if (r.views[1 - actor].hit != (attacks > 0)) r.fail++;
+        } else {
+            lock_deliver(&r, actor, LOCK_SKIP, UP, actor);
+        }
+
+        // 클라이언트가 만든 화면 = 서버가 만드는 패킷, 난수 상태까지 같아야 이후도 같음
+        for (int seat = 0; seat < 2; seat++) {
+            S2C_Packet want, got;
+            lockstep_compose_packet(&r.games[seat], &r.games[1 - seat], r.seated[1 - seat], &want);
+            lockstep_packet(&r.views[seat], &got);
+            got.is_hit = false;
+            if (!same_packet(&want, &got)) r.fail++;
+            if (memcmp(&r.views[seat].games[0].rng, &r.games[seat].rng, sizeof(Rng)) ||
+                memcmp(&r.views[seat].games[1].rng, &r.games[1 - seat].rng, sizeof(Rng))) r.fail++;
+        }
+    }
+
+    // 상대 게임이 없으면 이동은 적용할 수 없음 (키프레임 요청)
+    Lockstep empty;
+    lockstep_init(&empty);
+    LockEvent move = { .type = LOCK_MOVE, .who = 1, .dir = LEFT };
+    if (lockstep_apply(&empty, &move) != -1) r.fail++;
+    // 알 수 없는 사건, 이동이 아닌데 방향이 있는 사건, 짝수 inc는 거부
+    uint8_t bad[3] = { 1, 0x70, 0 };
+    LockEvent ev;
+    if (wire_decode_lock(bad, 2, &ev) != -1) r.fail++;
+    bad[1] = (uint8_t)(LOCK_IDLE << 4) | 1;
+    if (wire_decode_lock(bad, 2, &ev) != -1) r.fail++;
+    ev.type = LOCK_STATE;
+    ev.who = 0;
+    game_init_seeded(&ev.state, 1, 0);
+    uint8_t buf[WIRE_MAX_LOCK];
+    size_t len = wire_encode_lock(&ev, buf);
+    buf[len - 8] ^= 1;
+    if (wire_decode_lock(buf, len, &ev) != -1) r.fail++;
+
+    *out_bytes = r.events ? (double)r.bytes / (double)r.events : 0;
+    return r.fail;
+}
+
+// 경기 기록: 기록 스레드로 파일에 쓴 경기를 mmap으로 읽어서 처음부터 다시 진행하면 끝 상태가 같은지
+// 첫 경기는 두 게임 모두 시드로, 다음 경기부터는 한쪽이 다시 앉아서 남은 쪽은 상태로 시작
+#define REPLAY_TEST_MATCHES 40
+
+// 검증기 테스트에서 기록 한 곳을 조작하는 방법과, 검증기가 내야 하는 결과
+typedef enum {
+    TAMPER_NONE,
+    TAMPER_ATTACK,      // 첫 공격의 타일 수 +1
+    TAMPER_DROP_ATTACK, // 첫 공격 사건을 뺌
+    TAMPER_SCORE,       // 끝 점수 +2
+    TAMPER_BOARD,       // 끝 보드의 한 칸
+    TAMPER_RESULT,      // 이긴 자리
+    TAMPER_MOVE,        // 게임 오버인 쪽의 이동을 끝 바로 앞에
+    TAMPER_NO_END,      // 끝 사건 없음
+    TAMPER_KINDS
+} Tamper;
+
+static const ReplayVerdict tamper_verdict[TAMPER_KINDS] = {
+    REPLAY_OK, REPLAY_BAD_ATTACK, REPLAY_BAD_ATTACK, REPLAY_BAD_SCORE,
+    REPLAY_BAD_BOARD, REPLAY_BAD_RESULT, REPLAY_BAD_MOVE, REPLAY_BAD_FORMAT
+};
+
+static bool same_game(const GameState *a, const GameState *b) {
+    if (memcmp(a->board, b->board, sizeof(a->board)) || a->score != b->score) return false;
+    if (a->game_over != b->game_over || a->attack_cnt != b->attack_cnt) return false;
+    if (memcmp(a->attack_queue, b->attack_queue, sizeof(int) * (size_t)a->attack_cnt)) return false;
+    return a->rng.state == b->rng.state && a->rng.inc == b->rng.inc;
+}
+
+// 서버처럼 k번째 경기를 진행하면서 기록 (games는 경기가 끝난 상태로 바뀜)
+// @param applied 조작을 실제로 넣었는지 (공격이 없었거나 게임 오버인 쪽이 없으면 못 넣음)
+// @return 기록, 메모리 할당 실패 시 NULL
+static Replay *record_match(Rng *rng, GameState games[2], int k, Tamper tamper, bool *applied) {
+    Replay *r = replay_begin((uint64_t)k + 1, 7);
+    if (!r) return NULL;
+    bool oom = false;
+    *applied = (tamper != TAMPER_ATTACK && tamper != TAMPER_DROP_ATTACK && tamper != TAMPER_MOVE);
+
+    for (int seat = 0; seat < 2; seat++) {
+        // 첫 경기와 방금 다시 앉은 자리(k번째 경기에서 k % 2)는 새 게임
+        bool fresh = (k == 0 || seat == k % 2);
+        ReplayEvent ev = { .type = fresh ? REPLAY_SEED : REPLAY_STATE, .seat = seat };
+        if (fresh) {
+            ev.seed = 3000 + (uint64_t)k * 2 + (uint64_t)seat;
+            ev.stream = seat;
+            game_init_seeded(&games[seat], ev.seed, (uint64_t)seat);
+        }
+        ev.state = games[seat];
+        oom |= replay_append(&r, &ev) < 0;
+    }
+
+    ReplayEvent end = { .type = REPLAY_END, .reason = REPLAY_FINISHED, .winner = -1 };
+    for (int step = 0; !(games[0].game_over && games[1].game_over); step++) {
+        int actor = (int)rng_below(rng, 2);
+        GameState *me = &games[actor];
+        uint32_t pick = rng_below(rng, 400);
+        ReplayEvent ev = { .seat = actor };
+
+        if (pick == 0 || step > 5000) {
+            end.reason = REPLAY_LEFT;
+            end.seat = actor;
+            break;
+        }
+        if (pick < 20) {
+            game_execute_attack(me);
+            game_is_over(me);
+            ev.type = REPLAY_IDLE;
+            oom |= replay_append(&r, &ev) < 0;
+        } else if (!me->game_over) {
+            ev.type = REPLAY_MOVE;
+            ev.dir = (Direction)rng_below(rng, 4);
+            int attacks = game_play_move(me, &games[1 - actor], ev.dir);
+            oom |= replay_append(&r, &ev) < 0;
+            if (attacks == 0) continue;
+
+            ev.type = REPLAY_ATTACK;
+            ev.attacks = attacks;
+            if (!*applied && tamper == TAMPER_ATTACK) ev.attacks++;
+            if (*applied || tamper != TAMPER_DROP_ATTACK) oom |= replay_append(&r, &ev) < 0;
+            if (tamper == TAMPER_ATTACK || tamper == TAMPER_DROP_ATTACK) *applied = true;
+        }
+    }
+
+    for (int seat = 0; seat < 2; seat++) {
+        end.scores[seat] = games[seat].score;
+        end.boards[seat] = bb_from_array(games[seat].board);
+    }
+    if (end.reason == REPLAY_FINISHED && games[0].score != games[1].score) end.winner = games[0].score > games[1].score ? 0 : 1;
+
+    switch (tamper) {
+        case TAMPER_SCORE: end.scores[1] += 2; break;
+        case TAMPER_BOARD: end.boards[0] ^= 1ULL << 60; break;
+        case TAMPER_RESULT: end.winner = (end.winner == 0) ? 1 : 0; break;
+        case TAMPER_MOVE:
+            for (int seat = 0; seat < 2 && !*applied; seat++) {
+                if (!games[seat].game_over) continue;
+                ReplayEvent ev = { .type = REPLAY_MOVE, .seat = seat, .dir = LEFT };
+                oom |= replay_append(&r, &ev) < 0;
+                *applied = true;
+            }
+            break;
+        default: break;
+    }
+    if (tamper != TAMPER_NO_END) oom |= replay_append(&r, &end) < 0;
+
+    if (oom) {
+        free(r);
+        return NULL;
+    }
+    return r;
+}
+
+// 기록 한 경기를 읽어서 다시 진행, 끝 상태를 out에
+static int replay_match(const ReplayMatch *m, GameState out[2], size_t *out_moves) {
+    ReplayCursor cur = {0};
+    ReplayEvent ev;
+    int fail = 0, ret, last_attacks = -1, last_seat = -1;
+    uint32_t last_ms = 0;
+    bool ended = false;
+
+    while ((ret = replay_next_event(m, &cur, &ev)) > 0) {
+        if (ended || ev.t_ms < last_ms) fail++;
+        last_ms = ev.t_ms;
+        switch (ev.type) {
+            case REPLAY_SEED:
+                game_init_seeded(&out[ev.seat], ev.seed, (uint64_t)ev.stream);
+                break;
+            case REPLAY_STATE:
+                out[ev.seat] = ev.state;
+                break;
+            case REPLAY_MOVE:
+                last_attacks = game_play_move(&out[ev.seat], &out[1 - ev.seat], ev.dir);
+                last_seat = ev.seat;
+                (*out_moves)++;
+                break;
+            case REPLAY_ATTACK:
+                // 이동 바로 뒤에 그 이동이 보낸 수만큼
+                if (ev.seat != last_seat || ev.attacks != last_attacks) fail++;
+                break;
+            case REPLAY_IDLE:
+                game_execute_attack(&out[ev.seat]);
+                game_is_over(&out[ev.seat]);
+                break;
+            case REPLAY_END:
+                if (ev.scores[0] != out[0].score || ev.scores[1] != out[1].score) fail++;
+                if (ev.boards[0] != bb_from_array(out[0].board) || ev.boards[1] != bb_from_array(out[1].board)) fail++;
+                ended = true;
+                break;
+        }
+        if (ev.type != REPLAY_MOVE) last_attacks = -1;
+    }
+    if (ret < 0 || !ended) fail++;
+    return fail;
+}
+
+static int test_replay(double *out_bytes) {
+    char path[] = "/tmp/m2k_replay_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) return 1;
+    close(fd);
+
+    ReplayLog *log = replay_log_open(path, 0);
+    if (!log) {
+        unlink(path);
+        return 1;
+    }
+
+    int fail = 0;
+    GameState games[2], want[REPLAY_TEST_MATCHES][2];
+    Rng rng;
+    rng_seed(&rng, 31, 0);
+    for (int k = 0; k < REPLAY_TEST_MATCHES; k++) {
+        bool applied;
+        Replay *r = record_match(&rng, games, k, TAMPER_NONE, &applied);
+        if (!r || replay_log_submit(log, r) < 0) fail++;
+        want[k][0] = games[0];
+        want[k][1] = games[1];
+    }
+    replay_log_close(log); // 남은 경기를 모두 쓰고 끝남
+
+    // 다시 진행한 결과가 기록할 때와 같은지
+    ReplayFile f;
+    if (replay_open(&f, path) < 0) {
+        unlink(path);
+        return 1;
+    }
+    unlink(path);
+
+    ReplayMatch m;
+    size_t off = 0, moves = 0;
+    int count = 0, ret;
+    while ((ret = replay_next_match(&f, &off, &m)) > 0) {
+        GameState got[2];
+        ReplayCheck check;
+        memset(got, 0, sizeof(got));
+        if (count >= REPLAY_TEST_MATCHES || m.id != (uint64_t)count + 1 || m.room_id != 7) {
+            fail++;
+            break;
+        }
+        fail += replay_match(&m, got, &moves);
+        if (!same_game(&got[0], &want[count][0]) || !same_game(&got[1], &want[count][1])) fail++;
+        if (replay_verify(&m, &check) != REPLAY_OK) fail++;
+        count++;
+    }
+    if (ret < 0 || count != REPLAY_TEST_MATCHES) fail++;
+    *out_bytes = moves ? (double)f.size / (double)moves : 0;
+
+    // 덩어리 하나가 깨지면 그 앞까지만, 파일 끝이 덜 써졌으면 마지막 경기 앞까지만 읽음
+    uint8_t *copy = malloc(f.size);
+    if (!copy) return fail + 1;
+    memcpy(copy, f.base, f.size);
+    ReplayFile bad = { copy, f.size };
+    off = 0;
+    if (replay_next_match(&bad, &off, &m) != 1) fail++;
+    copy[off + REPLAY_HEADER_SIZE + 3] ^= 0x10;
+    if (replay_next_match(&bad, &off, &m) != -1) fail++;
+    copy[off + REPLAY_HEADER_SIZE + 3] ^= 0x10;
+
+    bad.size = f.size - 1;
+    off = 0;
+    count = 0;
+    while ((ret = replay_next_match(&bad, &off, &m)) > 0) count++;
+    if (ret != -1 || count != REPLAY_TEST_MATCHES - 1) fail++;
+    free(copy);
+
+    replay_close(&f);
+    return fail;
+}
+
+// 예전 형식 클라이언트가 범위 밖 행동(7, -1 등)을 섞어 보내도 서버처럼 디코딩해서 둔 경기는 검증을 통과
+// (범위 밖 값을 넘기면 game_play_move는 이동 없이 공격만 실행하는데 기록에는 dir & 3으로 남아 어긋남)
+static int test_verify_raw(void) {
+    static const int32_t bad[] = { 5, 7, -1, 0x100, 0x7fffffff };
+    int fail = 0;
+    ClientAction action;
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        if (wire_decode_raw((const uint8_t *)&bad[i], &action) == 0) fail++;
+    }
+    for (int32_t a = MOVE_UP; a <= QUIT; a++) {
+        if (wire_decode_raw((const uint8_t *)&a, &action) < 0 || action != (ClientAction)a) fail++;
+    }
+
+    Replay *r = replay_begin(1, 7);
+    if (!r) return fail + 1;
+    GameState games[2];
+    bool oom = false;
+    for (int seat = 0; seat < 2; seat++) {
+        ReplayEvent ev = { .type = REPLAY_SEED, .seat = seat, .seed = 4000 + (uint64_t)seat, .stream = seat };
+        game_init_seeded(&games[seat], ev.seed, (uint64_t)seat);
+        ev.state = games[seat];
+        oom |= replay_append(&r, &ev) < 0;
+    }
+
+    Rng rng;
+    rng_seed(&rng, 41, 0);
+    int rejected = 0;
+    ReplayEvent end = { .type = REPLAY_END, .reason = REPLAY_FINISHED, .winner = -1 };
+    for (int step = 0; !(games[0].game_over && games[1].game_over); step++) {
+        if (step > 5000) {
+            end.reason = REPLAY_LEFT;
+            break;
+        }
+        int actor = (int)rng_below(&rng, 2);
+        int32_t code = rng_below(&rng, 4) ? (int32_t)rng_below(&rng, 4) : bad[rng_below(&rng, 5)];
+        if (wire_decode_raw((const uint8_t *)&code, &action) < 0) {
+            rejected++;
+            continue;
+        }
+        if (games[actor].game_over) continue;
+        ReplayEvent ev = { .type = REPLAY_MOVE, .seat = actor, .dir = (Direction)action };
+        int attacks = game_play_move(&games[actor], &games[1 - actor], ev.dir);
+        oom |= replay_append(&r, &ev) < 0;
+        if (attacks > 0) {
+            ev.type = REPLAY_ATTACK;
+            ev.attacks = attacks;
+            oom |= replay_append(&r, &ev) < 0;
+        }
+    }
+    for (int seat = 0; seat < 2; seat++) {
+        end.scores[seat] = games[seat].score;
+        end.boards[seat] = bb_from_array(games[seat].board);
+    }
+    if (end.reason == REPLAY_FINISHED && games[0].score != games[1].score) end.winner = games[0].score > games[1].score ? 0 : 1;
+    oom |= replay_append(&r, &end) < 0;
+    if (oom) {
+        free(r);
+        return fail + 1;
+    }
+    replay_seal(r);
+
+    ReplayFile f = { r->data, r->len };
+    ReplayMatch m;
+    ReplayCheck check;
+    size_t off = 0;
+    if (replay_next_match(&f, &off, &m) != 1 || replay_verify(&m, &check) != REPLAY_OK) fail++;
+    if (rejected == 0) fail++;
+    free(r);
+    return fail;
+}
+
+// 기록 검증기: 조작하지 않은 경기는 통과, 조작한 경기는 조작한 종류로 걸러 내는지
+static int test_verify(int *out_caught) {
+    int fail = 0;
+    *out_caught = 0;
+    for (int t = 0; t < TAMPER_KINDS; t++) {
+        GameState games[2];
+        Rng rng;
+        rng_seed(&rng, 37, (uint64_t)t);
+        int applied_count = 0;
+
+        for (int k = 0; k < REPLAY_TEST_MATCHES; k++) {
+            bool applied;
+            Replay *r = record_match(&rng, games, k, (Tamper)t, &applied);
+            if (!r) return fail + 1;
+            replay_seal(r);
+
+            ReplayFile f = { r->data, r->len };
+            ReplayMatch m;
+            ReplayCheck check;
+            size_t off = 0;
+            if (replay_next_match(&f, &off, &m) != 1) fail++;
+            ReplayVerdict v = replay_verify(&m, &check);
+            if (v != (applied ? tamper_verdict[t] : REPLAY_OK)) fail++;
+            if (applied && t != TAMPER_NONE) {
+                applied_count++;
+                if (v == tamper_verdict[t]) (*out_caught)++;
+            }
+            free(r);
+        }
+        // 종류마다 적어도 한 번은 실제로 조작해 봄
+        if (t != TAMPER_NONE && applied_count == 0) fail++;
+    }
+    fail += test_verify_raw();
+    return fail;
+}
+
+// 봇 풀 작업이 끝났음을 기다리는 쪽에 알림 (gate가 닫혀 있으면 열릴 때까지 작업 스레드를 붙잡음)
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cv;
+    int done;
+    bool gate_closed;
+} BotTestSync;
+
+static void bot_test_done(BotJob *job) {
+    BotTestSync *sync = job->arg;
+    pthread_mutex_lock(&sync->lock);
+    sync->done++;
+    pthread_cond_broadcast(&sync->cv);
+    while (sync->gate_closed) pthread_cond_wait(&sync->cv, &sync->lock);
+    pthread_mutex_unlock(&sync->lock);
+}
+
+static void bot_test_wait(BotTestSync *sync, int done) {
+    pthread_mutex_lock(&sync->lock);
+    while (sync->done < done) pthread_cond_wait(&sync->cv, &sync->lock);
+    pthread_mutex_unlock(&sync->lock);
+}
+
+// 봇 풀: 작업 스레드의 탐색 결과가 같은 설정의 ai_search와 같은지 (게임 하나를 끝까지),
+// 작업 스레드가 바쁠 때 대기열 길이를 넘는 작업은 거절하고 받은 작업은 종료 때 모두 끝내는지
+static int test_bot_pool(int *out_moves) {
+    int fail = 0;
+    AiConfig config;
+    ai_default_config(&config);
+    config.depth = 3;
+    BotTestSync sync = { .lock = PTHREAD_MUTEX_INITIALIZER, .cv = PTHREAD_COND_INITIALIZER };
+
+    BotPool *pool = bot_pool_create(2, 4, &config);
+    AiSearch *ai = ai_create(&config);
+    if (!pool || !ai) return 1;
+    GameState g;
+    game_init_seeded(&g, 777, 0);
+    BotJob job = { .done = bot_test_done, .arg = &sync };
+    *out_moves = 0;
+    while (!g.game_over) {
+        job.board = bb_from_array(g.board);
+        if (bot_pool_submit(pool, &job) < 0) {
+            fail++;
+            break;
+        }
+        bot_test_wait(&sync, *out_moves + 1);
+        AiResult r = ai_search(ai, job.board);
+        if (job.result.valid != r.valid || job.result.move != r.move) fail++;
+        if (!job.result.valid) break;
+        game_move(&g, job.result.move);
+        if (g.moved) game_spawn_tile(&g);
+        game_is_over(&g);
+        (*out_moves)++;
+    }
+    BotPoolStats stats;
+    bot_pool_stats(pool, &stats);
+    if (stats.searches != (uint64_t)*out_moves + (g.game_over ? 0 : 1) || stats.rejected != 0 || stats.cpu_ns == 0) fail++;
+    bot_pool_destroy(pool);
+    ai_destroy(ai);
+
+    // 스레드 하나를 done 안에 붙잡아 두고 대기열(2개)을 채움
+    pool = bot_pool_create(1, 2, &config);
+    if (!pool) return fail + 1;
+    BotJob jobs[4];
+    sync.done = 0;
+    sync.gate_closed = true;
+    for (int i = 0; i < 4; i++) jobs[i] = (BotJob){ .board = 0x0000000100210321ULL, .done = bot_test_done, .arg = &sync };
+    if (bot_pool_submit(pool, &jobs[0]) < 0) fail++;
+    bot_test_wait(&sync, 1);
+    if (bot_pool_submit(pool, &jobs[1]) < 0 || bot_pool_submit(pool, &jobs[2]) < 0) fail++;
+    if (bot_pool_submit(pool, &jobs[3]) == 0) fail++;
+    bot_pool_stats(pool, &stats);
+    if (stats.queued != 2 || stats.rejected != 1) fail++;
+
+    pthread_mutex_lock(&sync.lock);
+    sync.gate_closed = false;
+    pthread_cond_broadcast(&sync.cv);
+    pthread_mutex_unlock(&sync.lock);
+    bot_pool_destroy(pool);
+    if (sync.done != 3) fail++;
+    for (int i = 0; i < 3; i++) {
+        if (!jobs[i].result.valid) fail++;
+    }
+    return fail;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// 지연 히스토그램: 1ns ~ 수십 초에 고르게(로그) 퍼진 값의 분위수가 정렬한 실제 값보다 작지 않고 1/64 안에서 맞는지,
+// 둘로 나눠 기록하고 합친 결과가 한 번에 기록한 결과와 같은지, 칸 번호가 값 순서를 지키는지
+#define HIST_TEST_VALUES 200000
+
+static int test_hist(double *out_err) {
+    int fail = 0;
+    Hist *all = malloc(sizeof(Hist)), *part[2] = { malloc(sizeof(Hist)), malloc(sizeof(Hist)) }, *merged = malloc(sizeof(Hist));
+    uint64_t *values = malloc(sizeof(uint64_t) * HIST_TEST_VALUES);
+    if (!all || !part[0] || !part[1] || !merged || !values) return 1;
+    hist_reset(all);
+    hist_reset(part[0]);
+    hist_reset(part[1]);
+    hist_reset(merged);
+
+    Rng rng;
+    rng_seed(&rng, 64, 0);
+    for (int i = 0; i < HIST_TEST_VALUES; i++) {
+        int bits = (int)rng_below(&rng, 36);
+        uint64_t v = ((uint64_t)rng_next(&rng) << 32 | rng_next(&rng)) >> (63 - bits);
+        values[i] = v;
+        hist_record(all, v);
+        hist_record(part[i & 1], v);
+    }
+    hist_merge(merged, part[0]);
+    hist_merge(merged, part[1]);
+    qsort(values, HIST_TEST_VALUES, sizeof(uint64_t), cmp_u64);
+
+    static const double ps[] = { 0.0, 0.1, 0.5, 0.9, 0.99, 0.999, 0.9999, 1.0 };
+    *out_err = 0;
+    for (size_t i = 0; i < sizeof(ps) / sizeof(ps[0]); i++) {
+        uint64_t rank = (uint64_t)(ps[i] * HIST_TEST_VALUES + 0.999999);
+        uint64_t exact = values[rank ? rank - 1 : 0];
+        uint64_t got = hist_percentile(all, ps[i]);
+        if (got < exact || (double)got > (double)exact * (1.0 + 1.0 / HIST_HALF) + 1) fail++;
+        if (exact > 0 && (double)(got - exact) / (double)exact > *out_err) *out_err = (double)(got - exact) / (double)exact;
+        if (hist_percentile(merged, ps[i]) != got) fail++;
+    }
+    if (hist_count(all) != HIST_TEST_VALUES || hist_count(merged) != HIST_TEST_VALUES) fail++;
+    if (hist_percentile(all, 1.0) != values[HIST_TEST_VALUES - 1]) fail++;
+
+    // 칸 번호는 값이 커지면 줄지 않고 2의 거듭제곱 경계에서 끊기지 않음
+    int prev = 0;
+    for (int shift = 1; shift < 64; shift++) {
+        uint64_t v = 1ULL << shift;
+        int below = hist_bucket(v - 1), at = hist_bucket(v);
+        if (below < prev || at < below || at - below > 1 || at >= HIST_BUCKETS) fail++;
+        prev = at;
+    }
+    if (hist_bucket(UINT64_MAX) != HIST_BUCKETS - 1) fail++;
+
+    free(all);
+    free(part[0]);
+    free(part[1]);
+    free(merged);
+    free(values);
+    return fail;
+}
+
+// 통계: 스레드마다 따로 기록한 값이 JSON에서 합쳐지고, 소켓으로도 같은 내용을 받음
+#define STATS_TEST_THREADS 2
+#define STATS_TEST_VALUES 100
+
+static void *stats_test_thread(void *arg) {
+    stats_register((const char *)arg);
+    for (int v = 1; v <= STATS_TEST_VALUES; v++) {
+        hist_record(&stats_self->hists[STATS_MOVE], (uint64_t)v);
+        stats_add(STATS_PACKETS_IN, 1);
+        stats_add(STATS_BYTES_IN, 10);
+    }
+    return NULL;
+}
+
+static int64_t stats_test_gauge(void) { return 42; }
+
+static int test_stats(void) {
+    int fail = 0;
+    pthread_t th[STATS_TEST_THREADS];
+    static const char *names[STATS_TEST_THREADS] = { "test0", "test1" };
+    for (int i = 0; i < STATS_TEST_THREADS; i++) pthread_create(&th[i], NULL, stats_test_thread, (void *)names[i]);
+    for (int i = 0; i < STATS_TEST_THREADS; i++) pthread_join(th[i], NULL);
+
+    // 등록하지 않은 스레드(여기서는 main)의 기록은 버려짐
+    stats_add(STATS_PACKETS_IN, 1000);
+
+    static const StatsGauge gauges[] = { { "answer", stats_test_gauge } };
+    char *json = NULL;
+    size_t len = 0;
+    FILE *f = open_memstream(&json, &len);
+    if (!f) return 1;
+    stats_write_json(f, gauges, 1);
+    fclose(f);
+
+    static const char *want[] = {
+        "\"answer\":42",
+        "\"packets_in\":200,",
+        "\"bytes_in\":2000,",
+        "\"move_ns\":{\"count\":200,\"mean\":50,\"p50\":50,\"p90\":90,\"p99\":99,\"p999\":100,\"max\":100}",
+        "\"name\":\"test0\"",
+        "\"name\":\"test1\"",
+    };
+    for (size_t i = 0; i < sizeof(want) / sizeof(want[0]); i++) {
+        if (!strstr(json, want[i])) {
+            printf("   JSON에 %s 없음\n", want[i]);
+            fail++;
+        }
+    }
+    if (len == 0 || json[len - 1] != '\n' || memchr(json, '\n', len) != json + len - 1) fail++;
+
+    // 소켓으로 받은 내용도 같은 JSON 한 줄
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/mult2048_stats_%d.sock", (int)getpid());
+    if (stats_serve(path, gauges, 1) < 0) {
+        free(json);
+        return fail + 1;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    strcpy(addr.sun_path, path);
+    char got[16384];
+    size_t got_len = 0;
+    if (fd >= 0 && connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+        ssize_t n;
+        while (got_len < sizeof(got) - 1 && (n = read(fd, got + got_len, sizeof(got) - 1 - got_len)) > 0) got_len += (size_t)n;
+    }
+    got[got_len] = '\0';
+    if (fd >= 0) close(fd);
+    stats_stop();
+
+    // uptime_ms는 다를 수 있으니 그 뒤부터 비교
+    const char *a = strchr(json, ','), *b = strchr(got, ',');
+    if (!a || !b || strcmp(a, b) != 0) fail++;
+    if (access(path, F_OK) == 0) fail++;   // 멈추면 소켓 파일을 지움
+
+    free(json);
+    return fail;
+}
 
 // 보드를 예쁘게 출력하는 도우미 함수
 void print_board(GameState *state) {
@@ -24,6 +1529,8 @@ void print_board(GameState *state) {
 int main() {
     GameState state;
 
+    bb_init();
+
     printf("=== 1. 게임 초기화 테스트 ===\n");
     game_init(&state);
     print_board(&state);
@@ -51,5 +1558,125 @@ int main() {
     printf("[랜덤 타일 생성 후]\n");
     print_board(&state);
 
-    return 0;
+    int fail = 0;
+    if (!state.moved) fail++;
+
+    printf("=== 3. 비트보드 교차 검증 테스트 ===\n");
+    int bb_fail = test_bitboard(100000);
+    if (bb_fail == 0) printf(">> 비트보드 결과 일치 (OK)\n");
+    else printf(">> 비트보드 불일치 %d건 (FAIL)\n", bb_fail);
+    fail += bb_fail;
+
+    printf("=== 4. SIMD 커널 교차 검증 테스트 ===\n");
+    BbKernel selected = bb_get_kernel();
+    int kernel_fail = test_kernels(100000);
+    bb_set_kernel(selected);
+    if (kernel_fail == 0) printf(">> 커널 결과 일치 (OK)\n");
+    else printf(">> 커널 불일치 %d건 (FAIL)\n", kernel_fail);
+    fail += kernel_fail;
+
+    printf("=== 5. 배치(SoA) API 검증 테스트 ===\n");
+    int batch_fail = test_batch();
+    bb_set_kernel(selected);
+    if (batch_fail == 0) printf(">> 배치 결과 일치 (OK)\n");
+    else printf(">> 배치 불일치 %d건 (FAIL)\n", batch_fail);
+    fail += batch_fail;
+
+    printf("=== 6. 시드 재현성 / 타일 생성 분포 테스트 ===\n");
+    int seed_fail = test_seeded();
+    if (seed_fail == 0) printf(">> 같은 시드 = 같은 게임 (OK)\n");
+    else printf(">> 시드 재현 실패 (FAIL)\n");
+    fail += seed_fail;
+
+    printf("=== 7. Expectimax AI 테스트 ===\n");
+    int ai_score = 0, ai_max = 0;
+    int ai_fail = test_ai(&ai_score, &ai_max);
+    printf("   [depth 3] 점수 %d, 최대 타일 %d\n", ai_score, ai_max);
+    if (ai_fail == 0) printf(">> AI 이동 검증 (OK)\n");
+    else printf(">> AI 이동 오류 %d건 (FAIL)\n", ai_fail);
+    fail += ai_fail;
+
+    printf("=== 8. 타이머 휠 테스트 ===\n");
+    int wheel_fail = test_timer_wheel(20000);
+    if (wheel_fail == 0) printf(">> 모든 타이머가 만료 tick에 정확히 한 번 (OK)\n");
+    else printf(">> 타이머 만료 오류 %d건 (FAIL)\n", wheel_fail);
+    fail += wheel_fail;
+
+    printf("=== 9. 압축 전송 형식 테스트 ===\n");
+    size_t wire_max = 0;
+    double wire_full = 0, wire_delta = 0;
+    int wire_fail = test_wire(20, &wire_max, &wire_full, &wire_delta);
+    printf("   패킷 최대 %zu바이트 (구조체 %zu바이트), 평균 전체 %.1f바이트 / 델타 %.1f바이트\n",
+           wire_max, sizeof(S2C_Packet), wire_full, wire_delta);
+    if (wire_fail == 0) printf(">> 인코딩/디코딩 결과 일치 (OK)\n");
+    else printf(">> 인코딩/디코딩 오류 %d건 (FAIL)\n", wire_fail);
+    fail += wire_fail;
+
+    printf("=== 10. 전송 대기열 테스트 ===\n");
+    int sq_fail = test_send_queue(20000);
+    if (sq_fail == 0) printf(">> 보낸 순서대로 빠짐없이 전송, 상한 초과 거절 (OK)\n");
+    else printf(">> 전송 대기열 오류 %d건 (FAIL)\n", sq_fail);
+    fail += sq_fail;
+
+    printf("=== 11. 수신 링 버퍼 / 요청 틀 테스트 ===\n");
+    int rb_fail = test_recv_buf(20000);
+    if (rb_fail == 0) printf(">> 잘려 온 요청을 순서대로 모두 꺼냄 (OK)\n");
+    else printf(">> 수신 버퍼 오류 %d건 (FAIL)\n", rb_fail);
+    fail += rb_fail;
+
+    printf("=== 12. 클라이언트 예측 / 서버 상태로 맞추기 테스트 ===\n");
+    int max_pending = 0;
+    int pred_fail = test_predict(20000, &max_pending);
+    printf("   확인 안 된 입력 최대 %d개 (기록 %d개까지)\n", max_pending, PREDICT_MAX_PENDING);
+    if (pred_fail == 0) printf(">> 예측 화면이 서버 결과와 일치 (OK)\n");
+    else printf(">> 예측 오류 %d건 (FAIL)\n", pred_fail);
+    fail += pred_fail;
+
+    printf("=== 13. 록스텝 사건 테스트 ===\n");
+    double lock_bytes = 0;
+    int lock_fail = test_lockstep(20000, &lock_bytes);
+    printf("   이동 하나에 %.1f바이트 (상태 프레임 최대 %d바이트)\n", lock_bytes, WIRE_MAX_PACKET);
+    if (lock_fail == 0) printf(">> 사건만으로 만든 두 게임이 서버와 일치 (OK)\n");
+    else printf(">> 록스텝 불일치 %d건 (FAIL)\n", lock_fail);
+    fail += lock_fail;
+
+    printf("=== 14. 경기 기록 / mmap 읽기 테스트 ===\n");
+    double replay_bytes = 0;
+    int replay_fail = test_replay(&replay_bytes);
+    printf("   경기 %d개, 이동 하나에 %.1f바이트 (헤더 포함)\n", REPLAY_TEST_MATCHES, replay_bytes);
+    if (replay_fail == 0) printf(">> 기록을 다시 진행한 결과가 원래 경기와 일치 (OK)\n");
+    else printf(">> 경기 기록 불일치 %d건 (FAIL)\n", replay_fail);
+    fail += replay_fail;
+
+    printf("=== 15. 기록 검증기 테스트 ===\n");
+    int caught = 0;
+    int verify_fail = test_verify(&caught);
+    printf("   조작한 경기 %d개를 조작한 종류로 찾음\n", caught);
+    if (verify_fail == 0) printf(">> 원래 기록은 통과, 조작한 기록은 모두 걸러 냄, 범위 밖 예전 형식 행동은 버림 (OK)\n");
+    else printf(">> 검증 오류 %d건 (FAIL)\n", verify_fail);
+    fail += verify_fail;
+
+    printf("=== 16. 봇 탐색 풀 테스트 ===\n");
+    int bot_moves = 0;
+    int bot_fail = test_bot_pool(&bot_moves);
+    printf("   작업 스레드가 고른 수로 %d수 진행\n", bot_moves);
+    if (bot_fail == 0) printf(">> 풀의 결과가 직접 탐색과 같고, 가득 찬 대기열은 거절 (OK)\n");
+    else printf(">> 봇 풀 오류 %d건 (FAIL)\n", bot_fail);
+    fail += bot_fail;
+
+    printf("=== 17. 지연 히스토그램 테스트 ===\n");
+    double hist_err = 0;
+    int hist_fail = test_hist(&hist_err);
+    printf("   분위수 최대 상대 오차 %.2f%% (칸 %d개)\n", hist_err * 100, HIST_BUCKETS);
+    if (hist_fail == 0) printf(">> 분위수가 정렬한 값과 오차 안에서 일치, 합친 결과도 같음 (OK)\n");
+    else printf(">> 히스토그램 오류 %d건 (FAIL)\n", hist_fail);
+    fail += hist_fail;
+
+    printf("=== 18. 서버 통계 테스트 ===\n");
+    int stats_fail = test_stats();
+    if (stats_fail == 0) printf(">> 스레드별 기록이 JSON에서 합쳐지고, 소켓으로 같은 내용을 받음 (OK)\n");
+    else printf(">> 통계 오류 %d건 (FAIL)\n", stats_fail);
+    fail += stats_fail;
+
+    return fail ? 1 : 0;
 }
\ No newline at end of file
@@ -0,0 +1,176 @@
+#include "timer_wheel.h"
+#include <stddef.h> // NULL
+
+#define SLOT_MASK  ((uint64_t)WHEEL_SLOTS - 1)
+#define DUE_SLOT   (WHEEL_LEVELS * WHEEL_SLOTS) // 만료돼서 꺼내 가기를 기다리는 타이머 목록
+#define WHEEL_SPAN (1ULL << (WHEEL_BITS * WHEEL_LEVELS)) // 표현할 수 있는 가장 먼 거리 (tick)
+
+// ==========================================
+// [1] 칸 리스트
+// ==========================================
+
+static inline uint64_t rotr64(uint64_t x, unsigned r) {
+    r &= 63;
+    return r ? (x >> r) | (x << (64 - r)) : x;
+}
+
+static void list_insert(TimerWheel *w, int slot, WheelTimer *t) {
+    WheelTimer *head = &w->heads[slot];
+    t->prev = head->prev;
+    t->next = head;
+    head->prev->next = t;
+    head->prev = t;
+    t->slot = slot;
+}
+
+static void list_unlink(TimerWheel *w, WheelTimer *t) {
+    t->prev->next = t->next;
+    t->next->prev = t->prev;
+
+    // 단의 칸이 비면 비트맵에서 지움
+    if (t->slot < DUE_SLOT) {
+        WheelTimer *head = &w->heads[t->slot];
+        if (head->next == head) {
+            w->occupied[t->slot / WHEEL_SLOTS] &= ~(1ULL << (t->slot % WHEEL_SLOTS));
+        }
+    }
+    t->prev = t->next = NULL;
+    t->slot = -1;
+}
+
+// 남은 거리에 맞는 단의 칸에 넣음 (k단에는 64^k 이상 64^(k+1) 미만 남은 타이머)
+static void place(TimerWheel *w, WheelTimer *t) {
+    uint64_t expires = (t->expires < w->now) ? w->now : t->expires;
+    uint64_t delta = expires - w->now;
+
+    // 너무 먼 타이머는 가장 먼 칸에 두었다가 내려올 때 다시 자리를 찾음
+    if (delta >= WHEEL_SPAN) {
+        expires = w->now + WHEEL_SPAN - 1;
+        delta = WHEEL_SPAN - 1;
+    }
+    int level = 0;
+    while (level < WHEEL_LEVELS - 1 && delta >= (1ULL << (WHEEL_BITS * (level + 1)))) level++;
+
+    int idx = (int)((expires >> (WHEEL_BITS * level)) & SLOT_MASK);
+    list_insert(w, level * WHEEL_SLOTS + idx, t);
+    w->occupied[level] |= 1ULL << idx;
+}
+
+// 윗단 칸 하나를 비우고 그 안의 타이머를 다시 배치 (아랫단으로 내려감)
+static void cascade_slot(TimerWheel *w, int level, int idx) {
+    WheelTimer *head = &w->heads[level * WHEEL_SLOTS + idx];
+    WheelTimer *t = head->next;
+    head->next = head->prev = head;
+    w->occupied[level] &= ~(1ULL << idx);
+
+    while (t != head) {
+        WheelTimer *next = t->next;
+        place(w, t);
+        t = next;
+    }
+}
+
+// now가 k단 칸의 경계이면 k단부터 1단까지 차례로 내림 (윗단을 먼저 내려야 1단 칸으로 온 타이머도 같이 내려옴)
+static void cascade(TimerWheel *w, uint64_t now) {
+    int top = 0;
+    while (top < WHEEL_LEVELS - 1 && (now & ((1ULL << (WHEEL_BITS * (top + 1))) - 1)) == 0) top++;
+    for (int level = top; level >= 1; level--) {
+        cascade_slot(w, level, (int)((now >> (WHEEL_BITS * level)) & SLOT_MASK));
+    }
+}
+
+// ==========================================
+// [2] 공개 함수 구현
+// ==========================================
+
+void wheel_init(TimerWheel *w, uint64_t now) {
+    w->now = now;
+    for (int i = 0; i < WHEEL_LEVELS; i++) w->occupied[i] = 0;
+    for (int i = 0; i <= DUE_SLOT; i++) {
+        w->heads[i].prev = w->heads[i].next = &w->heads[i];
+        w->heads[i].slot = i;
+        w->heads[i].expires = 0;
+    }
+}
+
+void wheel_timer_init(WheelTimer *t) {
+    t->expires = 0;
+    t->prev = t->next = NULL;
+    t->slot = -1;
+}
+
+void wheel_add(TimerWheel *w, WheelTimer *t, uint64_t expires) {
+    if (wheel_timer_active(t)) list_unlink(w, t);
+    t->expires = expires;
+    place(w, t);
+}
+
+void wheel_del(TimerWheel *w, WheelTimer *t) {
+    if (wheel_timer_active(t)) list_unlink(w, t);
+}
+
+WheelTimer *wheel_expire(TimerWheel *w, uint64_t now) {
+    WheelTimer *due = &w->heads[DUE_SLOT];
+
+    for (;;) {
+        if (due->next != due) {
+            WheelTimer *t = due->next;
+            list_unlink(w, t);
+            return t;
+        }
+        if (w->now > now) return NULL;
+
+        uint64_t tick = w->now;
+        if ((tick & SLOT_MASK) == 0) cascade(w, tick);
+
+        int idx = (int)(tick & SLOT_MASK);
+        if (w->occupied[0] & (1ULL << idx)) {
+            // 이 tick에 만료되는 칸을 통째로 만료 목록으로 옮김
+            // (콜백에서 바로 다시 걸린 타이머는 다음 tick 칸에 들어감)
+            WheelTimer *head = &w->heads[idx];
+            while (head->next != head) {
+                WheelTimer *t = head->next;
+                list_unlink(w, t);
+                list_insert(w, DUE_SLOT, t);
+            }
+            w->now = tick + 1;
+            continue;
+        }
+
+        // 빈 tick은 건너뜀: 0단의 다음 타이머나 다음 칸 경계(윗단이 내려올 수 있는 시각) 중 빠른 쪽
+        uint64_t next = (tick | SLOT_MASK) + 1;
+        if (w->occupied[0]) {
+            uint64_t cand = tick + (uint64_t)__builtin_ctzll(rotr64(w->occupied[0], (unsigned)idx));
+            if (cand < next) next = cand;
+        }
+        w->now = (next > now + 1) ? now + 1 : next;
+    }
+}
+
+bool wheel_next(const TimerWheel *w, uint64_t *tick) {
+    const WheelTimer *due = &w->heads[DUE_SLOT];
+    if (due->next != due) {
+        *tick = 0; // 이미 만료된 타이머가 있음
+        return true;
+    }
+
+    bool found = false;
+    uint64_t best = UINT64_MAX;
+    if (w->occupied[0]) {
+        unsigned idx = (unsigned)(w->now & SLOT_MASK);
+        best = w->now + (uint64_t)__builtin_ctzll(rotr64(w->occupied[0], idx));
+        found = true;
+    }
+    // 윗단은 칸이 내려오는 시각 (그 칸이 처리될 가장 가까운 경계)
+    for (int level = 1; level < WHEEL_LEVELS; level++) {
+        if (!w->occupied[level]) continue;
+        unsigned shift = WHEEL_BITS * (unsigned)level;
+        uint64_t base = (w->now + (1ULL << shift) - 1) >> shift;
+        uint64_t off = (uint64_t)__builtin_ctzll(rotr64(w->occupied[level], (unsigned)(base & SLOT_MASK)));
+        uint64_t cand = (base + off) << shift;
+        if (cand < best) best = cand;
+        found = true;
+    }
+    if (found) *tick = best;
+    return found;
+}
@@ -0,0 +1,510 @@
+#include "wire.h"
+#include <string.h> // memset()
+
+#define HELLO_MAGIC "M2K"
+#define WATCH_MAGIC "M2W"
+#define MAX_ATTACKS ((int)(sizeof(((S2C_Packet *)0)->pending_attacks) / sizeof(int)))
+
+// 비트필드 (0-8은 상태/공격받음/하이라이트, 9-14는 버전 2 델타, 15는 버전 4 입력 확인)
+#define FLAG_HIT          (1u << 3)
+#define FLAG_HIGHLIGHT    (1u << 4)
+#define FLAG_STATE_MASK   0x1FFu
+#define FLAG_DELTA        (1u << 9)
+#define FLAG_MY_BOARD     (1u << 10)
+#define FLAG_OPP_BOARD    (1u << 11)
+#define FLAG_MY_SCORE     (1u << 12)
+#define FLAG_OPP_SCORE    (1u << 13)
+#define FLAG_ATTACKS      (1u << 14)
+#define FLAG_DELTA_FIELDS (0x1Fu << 10)
+#define FLAG_ACK          (1u << 15)
+// 델타를 만들어 보는 임시 버퍼 크기 (모든 필드가 바뀐 경우)
+#define WIRE_MAX_DELTA    (1 + 2 + 2 * (2 + 8) + 5 + 5 + 1 + 5 + 2)
+
+// ==========================================
+// [1] 바이트 쓰기/읽기 도우미
+// ==========================================
+
+static uint8_t *put_u16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+static uint8_t *put_u64(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) p[i] = (uint8_t)(v >> (8 * i));
+    return p + 8;
+}
+
+static uint8_t *put_varint(uint8_t *p, uint32_t v) {
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint64_t get_u64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v |= (uint64_t)p[i] << (8 * i);
+    return v;
+}
+
+// 잘못된 varint(5바이트 초과)나 end를 넘으면 NULL
+static const uint8_t *get_varint(const uint8_t *p, const uint8_t *end, uint32_t *v) {
+    uint32_t result = 0;
+    for (int shift = 0; shift < 35 && p < end; shift += 7) {
+        uint8_t b = *p++;
+        result |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *v = result;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+// 타일 값 <-> 4비트 지수 (0 = 빈칸)
+static unsigned tile_exp(int value) {
+    if (value <= 0) return 0;
+    unsigned e = (unsigned)__builtin_ctz((unsigned)value);
+    return e > 15 ? 15 : e;
+}
+
+static int tile_value(unsigned e) {
+    return e ? 1 << e : 0;
+}
+
+static uint64_t pack_board(const int board[4][4]) {
+    uint64_t b = 0;
+    for (int r = 0; r < 4; r++) {
+        for (int c = 0; c < 4; c++) b |= (uint64_t)tile_exp(board[r][c]) << ((r * 4 + c) * 4);
+    }
+    return b;
+}
+
+static void unpack_board(uint64_t b, int board[4][4]) {
+    for (int r = 0; r < 4; r++) {
+        for (int c = 0; c < 4; c++) board[r][c] = tile_value((unsigned)(b >> ((r * 4 + c) * 4)) & 0xF);
+    }
+}
+
+// 패킷을 전송할 모양으로 압축한 것 (지수 보드, 4비트씩 묶은 공격 대기열)
+typedef struct {
+    uint16_t flags;
+    uint64_t boards[2];
+    uint32_t scores[2];
+    int attack_count;
+    uint64_t attacks;
+    int ack;        // 마지막으로 처리한 입력 번호, -1이면 없음
+} Frame;
+
+static void frame_from_packet(const S2C_Packet *pkt, int ack, Frame *f) {
+    f->ack = ack;
+    f->flags = (uint16_t)(pkt->game_status & 0x7);
+    if (pkt->is_hit) f->flags |= FLAG_HIT;
+    if (pkt->highlight_r >= 0 && pkt->highlight_c >= 0) {
+        f->flags |= FLAG_HIGHLIGHT;
+        f->flags |= (uint16_t)((pkt->highlight_r & 0x3) << 5);
+        f->flags |= (uint16_t)((pkt->highlight_c & 0x3) << 7);
+    }
+    f->boards[0] = pack_board(pkt->my_board);
+    f->boards[1] = pack_board(pkt->opp_board);
+    f->scores[0] = (uint32_t)pkt->my_score;
+    f->scores[1] = (uint32_t)pkt->opp_score;
+
+    int count = pkt->attack_count;
+    if (count < 0) count = 0;
+    if (count > MAX_ATTACKS) count = MAX_ATTACKS;
+    f->attack_count = count;
+    f->attacks = 0;
+    for (int i = 0; i < count; i++) f->attacks |= (uint64_t)tile_exp(pkt->pending_attacks[i]) << (i * 4);
+}
+
+static void frame_to_packet(const Frame *f, S2C_Packet *pkt) {
+    memset(pkt, 0, sizeof(*pkt));
+    pkt->game_status = (GameStatus)(f->flags & 0x7);
+    pkt->is_hit = (f->flags & FLAG_HIT) != 0;
+    if (f->flags & FLAG_HIGHLIGHT) {
+        pkt->highlight_r = (f->flags >> 5) & 0x3;
+        pkt->highlight_c = (f->flags >> 7) & 0x3;
+    } else {
+        pkt->highlight_r = -1;
+        pkt->highlight_c = -1;
+    }
+    unpack_board(f->boards[0], pkt->my_board);
+    unpack_board(f->boards[1], pkt->opp_board);
+    pkt->my_score = (int)f->scores[0];
+    pkt->opp_score = (int)f->scores[1];
+    pkt->attack_count = f->attack_count;
+    for (int i = 0; i < f->attack_count; i++) pkt->pending_attacks[i] = tile_value((f->attacks >> (i * 4)) & 0xF);
+}
+
+// 4비트 값 count개를 앞에서부터 두 개씩 한 바이트에
+static uint8_t *put_nibbles(uint8_t *p, uint64_t nibbles, int count) {
+    for (int i = 0; i < count; i += 2) *p++ = (uint8_t)(nibbles >> (i * 4));
+    return p;
+}
+
+static const uint8_t *get_nibbles(const uint8_t *p, const uint8_t *end, int count, uint64_t *nibbles) {
+    int bytes = (count + 1) / 2;
+    if (end - p < bytes) return NULL;
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; i++) v |= (uint64_t)p[i] << (i * 8);
+    if (count % 2) v &= (1ULL << (count * 4)) - 1;
+    *nibbles = v;
+    return p + bytes;
+}
+
+// 키프레임 본문 (버전 1 패킷과 같음)
+static uint8_t *put_keyframe(uint8_t *p, const Frame *f) {
+    p = put_u16(p, (uint16_t)(f->flags | (f->ack >= 0 ? FLAG_ACK : 0)));
+    p = put_u64(p, f->boards[0]);
+    p = put_u64(p, f->boards[1]);
+    p = put_varint(p, f->scores[0]);
+    p = put_varint(p, f->scores[1]);
+    *p++ = (uint8_t)f->attack_count;
+    p = put_nibbles(p, f->attacks, f->attack_count);
+    if (f->ack >= 0) p = put_u16(p, (uint16_t)f->ack);
+    return p;
+}
+
+// 보드에서 바뀐 칸만: u16 칸 비트맵 + 바뀐 칸의 지수 4비트씩
+static uint8_t *put_board_delta(uint8_t *p, uint64_t old_board, uint64_t new_board) {
+    uint16_t mask = 0;
+    uint64_t cells = 0;
+    int k = 0;
+    for (int i = 0; i < 16; i++) {
+        uint64_t e = (new_board >> (i * 4)) & 0xF;
+        if (((old_board >> (i * 4)) & 0xF) == e) continue;
+        mask |= (uint16_t)(1u << i);
+        cells |= e << (k++ * 4);
+    }
+    p = put_u16(p, mask);
+    return put_nibbles(p, cells, k);
+}
+
+static const uint8_t *get_board_delta(const uint8_t *p, const uint8_t *end, uint64_t *board) {
+    if (end - p < 2) return NULL;
+    uint16_t mask = get_u16(p);
+    p += 2;
+    uint64_t cells;
+    int k = __builtin_popcount(mask);
+    if (!(p = get_nibbles(p, end, k, &cells))) return NULL;
+    for (int i = 0; i < 16; i++) {
+        if (!(mask & (1u << i))) continue;
+        *board = (*board & ~(0xFULL << (i * 4))) | ((cells & 0xF) << (i * 4));
+        cells >>= 4;
+    }
+    return p;
+}
+
+static uint8_t *put_delta(uint8_t *p, const WireStream *base, const Frame *f) {
+    uint16_t flags = f->flags | FLAG_DELTA;
+    if (f->boards[0] != base->boards[0]) flags |= FLAG_MY_BOARD;
+    if (f->boards[1] != base->boards[1]) flags |= FLAG_OPP_BOARD;
+    if (f->scores[0] != base->scores[0]) flags |= FLAG_MY_SCORE;
+    if (f->scores[1] != base->scores[1]) flags |= FLAG_OPP_SCORE;
+    if (f->attack_count != base->attack_count || f->attacks != base->attacks) flags |= FLAG_ATTACKS;
+    if (f->ack >= 0 && f->ack != base->ack) flags |= FLAG_ACK;
+
+    p = put_u16(p, flags);
+    if (flags & FLAG_MY_BOARD) p = put_board_delta(p, base->boards[0], f->boards[0]);
+    if (flags & FLAG_OPP_BOARD) p = put_board_delta(p, base->boards[1], f->boards[1]);
+    if (flags & FLAG_MY_SCORE) p = put_varint(p, f->scores[0]);
+    if (flags & FLAG_OPP_SCORE) p = put_varint(p, f->scores[1]);
+    if (flags & FLAG_ATTACKS) {
+        *p++ = (uint8_t)f->attack_count;
+        p = put_nibbles(p, f->attacks, f->attack_count);
+    }
+    if (flags & FLAG_ACK) p = put_u16(p, (uint16_t)f->ack);
+    return p;
+}
+
+// 길이 바이트를 확인하고 본문을 Frame으로 (델타면 base 위에 덮어씀, base가 없으면 오류)
+static int parse_frame(const uint8_t *in, size_t len, const WireStream *base, Frame *f) {
+    if (len < 1) return 0;
+    size_t body = in[0];
+    if (body + 1 > WIRE_MAX_PACKET) return -1;
+    if (len < body + 1) return 0;
+
+    const uint8_t *p = in + 1;
+    const uint8_t *end = p + body;
+    if (end - p < 2) return -1;
+    uint16_t flags = get_u16(p);
+    p += 2;
+    if ((flags & 0x7) > GAME_OVER_WAIT) return -1;
+    f->flags = flags & FLAG_STATE_MASK;
+
+    if (!(flags & FLAG_DELTA)) {
+        if (flags & FLAG_DELTA_FIELDS) return -1;
+        if (end - p < 16) return -1;
+        f->boards[0] = get_u64(p);
+        f->boards[1] = get_u64(p + 8);
+        p += 16;
+        if (!(p = get_varint(p, end, &f->scores[0]))) return -1;
+        if (!(p = get_varint(p, end, &f->scores[1]))) return -1;
+        if (p >= end) return -1;
+        f->attack_count = *p++;
+        if (f->attack_count > MAX_ATTACKS) return -1;
+        if (!(p = get_nibbles(p, end, f->attack_count, &f->attacks))) return -1;
+        f->ack = -1;
+    } else {
+        if (!base || !base->primed) return -1;
+        f->boards[0] = base->boards[0];
+        f->boards[1] = base->boards[1];
+        f->scores[0] = base->scores[0];
+        f->scores[1] = base->scores[1];
+        f->attack_count = base->attack_count;
+        f->attacks = base->attacks;
+        f->ack = base->ack;
+        if ((flags & FLAG_MY_BOARD) && !(p = get_board_delta(p, end, &f->boards[0]))) return -1;
+        if ((flags & FLAG_OPP_BOARD) && !(p = get_board_delta(p, end, &f->boards[1]))) return -1;
+        if ((flags & FLAG_MY_SCORE) && !(p = get_varint(p, end, &f->scores[0]))) return -1;
+        if ((flags & FLAG_OPP_SCORE) && !(p = get_varint(p, end, &f->scores[1]))) return -1;
+        if (flags & FLAG_ATTACKS) {
+            if (p >= end) return -1;
+            f->attack_count = *p++;
+            if (f->attack_count > MAX_ATTACKS) return -1;
+            if (!(p = get_nibbles(p, end, f->attack_count, &f->attacks))) return -1;
+        }
+    }
+    if (flags & FLAG_ACK) {
+        if (end - p < 2) return -1;
+        f->ack = get_u16(p);
+        p += 2;
+    }
+    if (p != end) return -1;
+    return (int)(body + 1);
+}
+
+static void stream_store(WireStream *s, const Frame *f) {
+    s->primed = true;
+    s->boards[0] = f->boards[0];
+    s->boards[1] = f->boards[1];
+    s->scores[0] = f->scores[0];
+    s->scores[1] = f->scores[1];
+    s->attack_count = f->attack_count;
+    s->attacks = f->attacks;
+    s->ack = f->ack;
+}
+
+// ==========================================
+// [2] 공개 함수 구현
+// ==========================================
+
+void wire_hello(uint8_t out[WIRE_HELLO_SIZE], int version) {
+    memcpy(out, HELLO_MAGIC, 3);
+    out[3] = (uint8_t)version;
+}
+
+int wire_parse_hello(const uint8_t in[WIRE_HELLO_SIZE]) {
+    if (memcmp(in, HELLO_MAGIC, 3) != 0) return -1;
+    return in[3];
+}
+
+void wire_watch(uint8_t out[WIRE_WATCH_SIZE], int version, uint32_t room_id) {
+    memcpy(out, WATCH_MAGIC, 3);
+    out[3] = (uint8_t)version;
+    for (int i = 0; i < 4; i++) out[4 + i] = (uint8_t)(room_id >> (8 * i));
+}
+
+int wire_parse_watch(const uint8_t in[WIRE_HELLO_SIZE]) {
+    if (memcmp(in, WATCH_MAGIC, 3) != 0) return -1;
+    return in[3];
+}
+
+uint32_t wire_watch_room(const uint8_t in[WIRE_WATCH_SIZE]) {
+    return (uint32_t)in[4] | ((uint32_t)in[5] << 8) | ((uint32_t)in[6] << 16) | ((uint32_t)in[7] << 24);
+}
+
+size_t wire_encode_packet(const S2C_Packet *pkt, uint8_t *out) {
+    Frame f;
+    frame_from_packet(pkt, -1, &f);
+    uint8_t *p = put_keyframe(out + 1, &f);
+    out[0] = (uint8_t)(p - out - 1);
+    return (size_t)(p - out);
+}
+
+int wire_decode_packet(const uint8_t *in, size_t len, S2C_Packet *pkt) {
+    Frame f;
+    int ret = parse_frame(in, len, NULL, &f);
+    if (ret > 0) frame_to_packet(&f, pkt);
+    return ret;
+}
+
+void wire_stream_init(WireStream *s) {
+    memset(s, 0, sizeof(*s));
+    s->ack = -1;
+}
+
+size_t wire_encode_stream(WireStream *s, const S2C_Packet *pkt, int ack, uint8_t *out, bool keyframe) {
+    Frame f;
+    frame_from_packet(pkt, ack, &f);
+
+    uint8_t *p = NULL;
+    if (s->primed && !keyframe && s->since_key < WIRE_KEYFRAME_INTERVAL) {
+        // 바뀐 게 많아서 델타가 키프레임보다 커지면 키프레임으로
+        uint8_t delta[WIRE_MAX_DELTA];
+        uint8_t *end = put_delta(delta + 1, s, &f);
+        size_t delta_len = (size_t)(end - delta);
+        if (delta_len <= WIRE_MAX_PACKET) {
+            delta[0] = (uint8_t)(delta_len - 1);
+            memcpy(out, delta, delta_len);
+            p = out + delta_len;
+            s->since_key++;
+        }
+    }
+    if (!p) {
+        p = put_keyframe(out + 1, &f);
+        out[0] = (uint8_t)(p - out - 1);
+        s->since_key = 0;
+    }
+    stream_store(s, &f);
+    return (size_t)(p - out);
+}
+
+int wire_decode_stream(WireStream *s, const uint8_t *in, size_t len, S2C_Packet *pkt) {
+    Frame f;
+    int ret = parse_frame(in, len, s, &f);
+    if (ret > 0) {
+        stream_store(s, &f);
+        frame_to_packet(&f, pkt);
+    }
+    return ret;
+}
+
+size_t wire_encode_lock(const LockEvent *ev, uint8_t *out) {
+    uint8_t *p = out + 1;
+    uint8_t code = (uint8_t)(ev->type << 4) | (uint8_t)((ev->who & 1) << 2);
+    if (ev->type == LOCK_MOVE) code |= (uint8_t)(ev->dir & 0x3);
+    *p++ = code;
+
+    if (ev->type == LOCK_SEED) {
+        p = put_u64(p, ev->seed);
+        *p++ = (uint8_t)ev->stream;
+    } else if (ev->type == LOCK_STATE) {
+        const GameState *g = &ev->state;
+        int count = g->attack_cnt < 0 ? 0 : (g->attack_cnt > MAX_ATTACK_QUEUE ? MAX_ATTACK_QUEUE : g->attack_cnt);
+        uint64_t attacks = 0;
+        for (int i = 0; i < count; i++) attacks |= (uint64_t)tile_exp(g->attack_queue[i]) << (i * 4);
+
+        p = put_u64(p, pack_board(g->board));
+        p = put_varint(p, (uint32_t)g->score);
+        *p++ = (uint8_t)count;
+        p = put_nibbles(p, attacks, count);
+        uint8_t flags = g->game_over ? 1 : 0;
+        if (g->highlight_r >= 0 && g->highlight_c >= 0) {
+            flags |= (uint8_t)(2 | ((g->highlight_r & 0x3) << 2) | ((g->highlight_c & 0x3) << 4));
+        }
+        *p++ = flags;
+        p = put_u64(p, g->rng.state);
+        p = put_u64(p, g->rng.inc);
+    }
+    out[0] = (uint8_t)(p - out - 1);
+    return (size_t)(p - out);
+}
+
+int wire_decode_lock(const uint8_t *in, size_t len, LockEvent *ev) {
+    if (len < 1) return 0;
+    size_t body = in[0];
+    if (body + 1 > WIRE_MAX_LOCK || body < 1) return -1;
+    if (len < body + 1) return 0;
+    const uint8_t *p = in + 1, *end = in + 1 + body;
+
+    uint8_t code = *p++;
+    memset(ev, 0, sizeof(*ev));
+    ev->type = (LockEventType)(code >> 4);
+    ev->who = (code >> 2) & 1;
+    if (ev->type < LOCK_MOVE || ev->type > LOCK_LEAVE) return -1;
+    if (ev->type != LOCK_MOVE && (code & 0x3)) return -1;
+    ev->dir = (Direction)(code & 0x3);
+
+    if (ev->type == LOCK_SEED) {
+        if (end - p < 9) return -1;
+        ev->seed = get_u64(p);
+        ev->stream = p[8];
+        p += 9;
+    } else if (ev->type == LOCK_STATE) {
+        GameState *g = &ev->state;
+        uint32_t score;
+        uint64_t attacks;
+        if (end - p < 8) return -1;
+        unpack_board(get_u64(p), g->board);
+        p += 8;
+        if (!(p = get_varint(p, end, &score)) || p >= end) return -1;
+        g->score = (int)score;
+        g->attack_cnt = *p++;
+        if (g->attack_cnt > MAX_ATTACK_QUEUE) return -1;
+        if (!(p = get_nibbles(p, end, g->attack_cnt, &attacks))) return -1;
+        for (int i = 0; i < g->attack_cnt; i++) g->attack_queue[i] = tile_value((attacks >> (i * 4)) & 0xF);
+        if (end - p < 17) return -1;
+        uint8_t flags = *p++;
+        g->game_over = flags & 1;
+        g->highlight_r = (flags & 2) ? (flags >> 2) & 0x3 : -1;
+        g->highlight_c = (flags & 2) ? (flags >> 4) & 0x3 : -1;
+        g->rng.state = get_u64(p);
+        g->rng.inc = get_u64(p + 8);
+        if (!(g->rng.inc & 1)) return -1; // PCG의 inc는 항상 홀수
+        p += 16;
+    }
+    if (p != end) return -1;
+    return (int)(body + 1);
+}
+
+uint8_t wire_encode_action(ClientAction action) {
+    return (uint8_t)action;
+}
+
+int wire_decode_action(uint8_t in, ClientAction *action) {
+    if (in > QUIT) return -1;
+    *action = (ClientAction)in;
+    return 0;
+}
+
+_Static_assert(sizeof(C2S_Packet) == sizeof(uint32_t), "raw request is one 4-byte enum");
+
+int wire_decode_raw(const uint8_t *in, ClientAction *action) {
+    // 음수도 부호 없는 값으로 읽으면 범위 밖
+    uint32_t raw;
+    memcpy(&raw, in, sizeof(raw));
+    if (raw > QUIT) return -1;
+    *action = (ClientAction)raw;
+    return 0;
+}
+
+size_t wire_encode_request(uint8_t *out, int version, uint8_t code, int seq) {
+    if (version < 3) {
+        out[0] = code;
+        return WIRE_ACTION_SIZE;
+    }
+    out[1] = code;
+    if (version != 4 || seq < 0) {
+        out[0] = 1;
+        return 2;
+    }
+    put_u16(out + 2, (uint16_t)seq);
+    out[0] = 3;
+    return 4;
+}
+
+int wire_request_size(const uint8_t *in, size_t len, int version) {
+    if (version < 3) return WIRE_ACTION_SIZE;
+    if (len < 1) return 0;
+    if (in[0] + 1 > WIRE_MAX_REQUEST) return -1;
+    return in[0] + 1;
+}
+
+int wire_request_code(const uint8_t *in, int version) {
+    if (version < 3) return in[0];
+    return in[0] > 0 ? in[1] : -1;
+}
+
+int wire_request_seq(const uint8_t *in, int version) {
+    if (version != 4 || in[0] < 3) return -1;
+    return get_u16(in + 2);
+}